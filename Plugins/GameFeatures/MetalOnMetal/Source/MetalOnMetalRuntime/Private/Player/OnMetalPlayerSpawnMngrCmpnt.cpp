@@ -34,9 +34,39 @@ AActor* UOnMetalPlayerSpawnMngrCmpnt::OnChoosePlayerStart(AController* Player, T
 		break;
 	}
 	
-	for(ALyraPlayerStart* EachPlayerStart : PlayerStarts)
+	if (!IsSpawnIndexEnabled())
 	{
-		if(!EachPlayerStart->IsClaimed() && EachPlayerStart->GetGameplayTags().HasTag(TeamSpawnTag))
+		for (ALyraPlayerStart* EachPlayerStart : PlayerStarts)
+		{
+			if (!EachPlayerStart->IsClaimed() && EachPlayerStart->GetGameplayTags().HasTag(TeamSpawnTag))
+			{
+				return EachPlayerStart;
+			}
+		}
+
+		return nullptr;
+	}
+
+	// The spawn index already knows which starts belong to the team, and scores them against nearby enemies
+	TArray<ALyraPlayerStart*> TeamStarts;
+	FindPlayerStartsWithTag(TeamSpawnTag, TeamStarts);
+
+	// Leave it to the default selection if every team start is taken
+	const bool bHasUnclaimedStart = TeamStarts.ContainsByPredicate([](const ALyraPlayerStart* EachPlayerStart) { return !EachPlayerStart->IsClaimed(); });
+	if(!bHasUnclaimedStart)
+	{
+		return nullptr;
+	}
+
+	if (ALyraPlayerStart* BestPlayerStart = ChooseBestPlayerStart(Player, TeamStarts))
+	{
+		return BestPlayerStart;
+	}
+
+	// Every team start is blocked, still spawn in our own base rather than at an arbitrary start
+	for (ALyraPlayerStart* EachPlayerStart : TeamStarts)
+	{
+		if (!EachPlayerStart->IsClaimed())
 		{
 			return EachPlayerStart;
 		}
@@ -4,6 +4,7 @@
 #include "WeaponAbilities/OnMetal_RangedWeaponAbility.h"
 #include "AbilitySystemComponent.h"
 #include "AbilitySystemGlobals.h"
+#include "AbilitySystem/LyraAbilitySystemComponent.h"
 #include "AIController.h"
 #include "DrawDebugHelpers.h"
 #include "LyraLogChannels.h"
@@ -17,6 +18,7 @@
 #include "Types/TBProjectileId.h"
 #include "Types/TBProjectileInjury.h"
 #include "WeaponAbilities/OnMetal_ProjectileImpactAbility.h"
+#include "Weapons/LyraDamageJournalSubsystem.h"
 #include "Weapons/LyraRangedWeaponInstance.h"
 #include "Weapons/LyraWeaponStateComponent.h"
 #include "Weapons/OnMetal_WeaponStateComponent.h"
@@ -782,10 +784,20 @@ void UOnMetal_RangedWeaponAbility::OnTargetDataReadyCallback(const FGameplayAbil
 		const bool bShouldNotifyServer = CurrentActorInfo->IsLocallyControlled() && !CurrentActorInfo->IsNetAuthority();
 		if (bShouldNotifyServer)
 		{
-			MyAbilityComponent->CallServerSetReplicatedTargetData(CurrentSpecHandle,
-			                                                      CurrentActivationInfo.GetActivationPredictionKey(),
-			                                                      LocalTargetDataHandle, FGameplayTag(),
-			                                                      MyAbilityComponent->ScopedPredictionKey);
+			if (ULyraAbilitySystemComponent* LyraASC = Cast<ULyraAbilitySystemComponent>(MyAbilityComponent))
+			{
+				LyraASC->CallServerSetReplicatedTargetDataBatched(CurrentSpecHandle,
+				                                                  CurrentActivationInfo.GetActivationPredictionKey(),
+				                                                  LocalTargetDataHandle, FGameplayTag(),
+				                                                  MyAbilityComponent->ScopedPredictionKey);
+			}
+			else
+			{
+				MyAbilityComponent->CallServerSetReplicatedTargetData(CurrentSpecHandle,
+				                                                      CurrentActivationInfo.GetActivationPredictionKey(),
+				                                                      LocalTargetDataHandle, FGameplayTag(),
+				                                                      MyAbilityComponent->ScopedPredictionKey);
+			}
 		}
 
 		const bool bIsTargetDataValid = true;
@@ -836,6 +848,16 @@ void UOnMetal_RangedWeaponAbility::OnTargetDataReadyCallback(const FGameplayAbil
 			check(WeaponData);
 			WeaponData->AddSpread();
 
+#if WITH_SERVER_CODE
+			if (CurrentActorInfo->IsNetAuthority())
+			{
+				if (ULyraDamageJournalSubsystem* DamageJournal = ULyraDamageJournalSubsystem::Get(GetAvatarActorFromActorInfo()))
+				{
+					DamageJournal->RecordShots(GetAvatarActorFromActorInfo(), WeaponData, LocalTargetDataHandle);
+				}
+			}
+#endif // WITH_SERVER_CODE
+
 			UE_LOG(LogTemp, Warning,
 			       TEXT("About to call OnRangedWeaponTargetDataReady. IsServer: %s, IsProjectile: %s"),
 			       GetOwningActorFromActorInfo()->HasAuthority() ? TEXT("True") : TEXT("False"),
@@ -8,7 +8,9 @@
 #include "AIController.h"
 #include "NativeGameplayTags.h"
 #include "Weapons/LyraWeaponStateComponent.h"
+#include "Weapons/LyraDamageJournalSubsystem.h"
 #include "AbilitySystemComponent.h"
+#include "AbilitySystem/LyraAbilitySystemComponent.h"
 #include "AbilitySystem/LyraGameplayAbilityTargetData_SingleTargetHit.h"
 #include "TerminalBallistics/Public/Core/TBStatics.h"
 #include "DrawDebugHelpers.h"
@@ -569,7 +571,14 @@ void UOnMetal_RangedProjectileAbility::OnTargetDataReadyCallback(const FGameplay
 		const bool bShouldNotifyServer = CurrentActorInfo->IsLocallyControlled() && !CurrentActorInfo->IsNetAuthority();
 		if (bShouldNotifyServer)
 		{
-			MyAbilityComponent->CallServerSetReplicatedTargetData(CurrentSpecHandle, CurrentActivationInfo.GetActivationPredictionKey(), LocalTargetDataHandle, ApplicationTag, MyAbilityComponent->ScopedPredictionKey);
+			if (ULyraAbilitySystemComponent* LyraASC = Cast<ULyraAbilitySystemComponent>(MyAbilityComponent))
+			{
+				LyraASC->CallServerSetReplicatedTargetDataBatched(CurrentSpecHandle, CurrentActivationInfo.GetActivationPredictionKey(), LocalTargetDataHandle, ApplicationTag, MyAbilityComponent->ScopedPredictionKey);
+			}
+			else
+			{
+				MyAbilityComponent->CallServerSetReplicatedTargetData(CurrentSpecHandle, CurrentActivationInfo.GetActivationPredictionKey(), LocalTargetDataHandle, ApplicationTag, MyAbilityComponent->ScopedPredictionKey);
+			}
 		}
 
 		const bool bIsTargetDataValid = true;
@@ -615,6 +624,16 @@ void UOnMetal_RangedProjectileAbility::OnTargetDataReadyCallback(const FGameplay
 			check(WeaponData);
 			WeaponData->AddSpread();
 
+#if WITH_SERVER_CODE
+			if (CurrentActorInfo->IsNetAuthority())
+			{
+				if (ULyraDamageJournalSubsystem* DamageJournal = ULyraDamageJournalSubsystem::Get(GetAvatarActorFromActorInfo()))
+				{
+					DamageJournal->RecordShots(GetAvatarActorFromActorInfo(), WeaponData, LocalTargetDataHandle);
+				}
+			}
+#endif // WITH_SERVER_CODE
+
 			// Let the blueprint do stuff like apply effects to the targets
 			OnRangedWeaponTargetDataReady(LocalTargetDataHandle);
 		}
@@ -2,7 +2,12 @@
 
 #include "Accolades/LyraAccoladeHostWidget.h"
 
+#include "Components/PanelSlot.h"
+#include "Components/PanelWidget.h"
 #include "DataRegistrySubsystem.h"
+#include "Engine/AssetManager.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameModes/LyraExperienceManagerComponent.h"
 #include "LyraLogChannels.h"
 #include "Messages/LyraNotificationMessage.h"
 #include "Sound/SoundBase.h"
@@ -16,12 +21,53 @@ UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Lyra_ShooterGame_Accolade, "Lyra.ShooterGame.A
 
 static FName NAME_AccoladeRegistryID("Accolades");
 
+namespace LyraConsoleVariables
+{
+	static bool bPrefetchAccolades = true;
+	static FAutoConsoleVariableRef CVarPrefetchAccolades(
+		TEXT("lyra.Accolades.Prefetch"),
+		bPrefetchAccolades,
+		TEXT("Should accolade hosts prefetch every accolade row, sound and icon once the experience has loaded?"),
+		ECVF_Default);
+}
+
+// Copies the layout a panel slot subclass adds (padding, alignment, ...), but not the slot's parent and content
+static void CopyPanelSlotLayout(const UPanelSlot* FromSlot, UPanelSlot* ToSlot)
+{
+	if ((FromSlot == nullptr) || (ToSlot == nullptr) || (FromSlot->GetClass() != ToSlot->GetClass()))
+	{
+		return;
+	}
+
+	for (TFieldIterator<FProperty> PropertyIt(ToSlot->GetClass()); PropertyIt; ++PropertyIt)
+	{
+		const UClass* OwnerClass = PropertyIt->GetOwnerClass();
+		if ((OwnerClass != nullptr) && OwnerClass->IsChildOf(UPanelSlot::StaticClass()) && (OwnerClass != UPanelSlot::StaticClass()))
+		{
+			PropertyIt->CopyCompleteValue_InContainer(ToSlot, FromSlot);
+		}
+	}
+
+	ToSlot->SynchronizeProperties();
+}
+
 void ULyraAccoladeHostWidget::NativeConstruct()
 {
 	Super::NativeConstruct();
 
 	UGameplayMessageSubsystem& MessageSubsystem = UGameplayMessageSubsystem::Get(this);
 	ListenerHandle = MessageSubsystem.RegisterListener(TAG_Lyra_AddNotification_Message, this, &ThisClass::OnNotificationMessage);
+
+	if (LyraConsoleVariables::bPrefetchAccolades && !bStartedPrefetch)
+	{
+		// The accolade registry sources are added by the experience's game features
+		AGameStateBase* GameState = GetWorld()->GetGameState();
+		if (ULyraExperienceManagerComponent* ExperienceComponent = GameState ? GameState->FindComponentByClass<ULyraExperienceManagerComponent>() : nullptr)
+		{
+			bStartedPrefetch = true;
+			ExperienceComponent->CallOrRegister_OnExperienceLoaded(FOnLyraExperienceLoaded::FDelegate::CreateUObject(this, &ThisClass::OnExperienceLoaded));
+		}
+	}
 }
 
 void ULyraAccoladeHostWidget::NativeDestruct()
@@ -31,6 +77,18 @@ void ULyraAccoladeHostWidget::NativeDestruct()
 
 	CancelAsyncLoading();
 
+	// Rows that were still prefetching are acquired again the next time the widget is constructed
+	for (const TSharedPtr<FStreamableHandle>& Handle : PrefetchHandles)
+	{
+		if (Handle.IsValid())
+		{
+			Handle->CancelHandle();
+		}
+	}
+	PrefetchHandles.Reset();
+	PrefetchingAccoladeRows.Reset();
+	bStartedPrefetch = false;
+
 	Super::NativeDestruct();
 }
 
@@ -52,6 +110,15 @@ void ULyraAccoladeHostWidget::OnNotificationMessage(FGameplayTag Channel, const
 		const int32 NextID = AllocatedSequenceID;
 		++AllocatedSequenceID;
 
+		// Prefetched accolades are ready right away, but still wait their turn behind any earlier ones that are loading
+		if (const FPendingAccoladeEntry* PrefetchedEntry = PrefetchedAccolades.Find(Notification.PayloadTag.GetTagName()))
+		{
+			FPendingAccoladeEntry& PendingEntry = PendingAccoladeLoads.Add_GetRef(*PrefetchedEntry);
+			PendingEntry.SequenceID = NextID;
+			ConsiderLoadedAccolades();
+			return;
+		}
+
 		FDataRegistryId ItemID(NAME_AccoladeRegistryID, Notification.PayloadTag.GetTagName());
 		if (!UDataRegistrySubsystem::Get()->AcquireItem(ItemID, FDataRegistryItemAcquiredCallback::CreateUObject(this, &ThisClass::OnRegistryLoadCompleted, NextID)))
 		{
@@ -67,6 +134,7 @@ void ULyraAccoladeHostWidget::OnRegistryLoadCompleted(const FDataRegistryAcquire
 	{
 		FPendingAccoladeEntry& PendingEntry = PendingAccoladeLoads.AddDefaulted_GetRef();
 		PendingEntry.Row = *AccoladeRow;
+		PendingEntry.AccoladeName = AccoladeHandle.ItemId.ItemName;
 		PendingEntry.SequenceID = SequenceID;
 
 		TArray<FSoftObjectPath> AssetsToLoad;
@@ -91,6 +159,90 @@ void ULyraAccoladeHostWidget::OnRegistryLoadCompleted(const FDataRegistryAcquire
 	}
 }
 
+void ULyraAccoladeHostWidget::OnExperienceLoaded(const ULyraExperienceDefinition* Experience)
+{
+	PrefetchAccolades();
+}
+
+void ULyraAccoladeHostWidget::PrefetchAccolades()
+{
+	UDataRegistrySubsystem* DataRegistrySubsystem = UDataRegistrySubsystem::Get();
+	const UDataRegistry* Registry = DataRegistrySubsystem ? DataRegistrySubsystem->GetRegistryForType(NAME_AccoladeRegistryID) : nullptr;
+	if (Registry == nullptr)
+	{
+		UE_LOG(LogLyra, Warning, TEXT("Failed to find accolade registry, accolades will load when they're first displayed"));
+		return;
+	}
+
+	TArray<FDataRegistryId> AccoladeIDs;
+	Registry->GetPossibleRegistryIds(/*out*/ AccoladeIDs, /*bSortForDisplay=*/ false);
+
+	for (const FDataRegistryId& AccoladeID : AccoladeIDs)
+	{
+		if (!PrefetchedAccolades.Contains(AccoladeID.ItemName) && !PrefetchingAccoladeRows.Contains(AccoladeID.ItemName))
+		{
+			DataRegistrySubsystem->AcquireItem(AccoladeID, FDataRegistryItemAcquiredCallback::CreateUObject(this, &ThisClass::OnPrefetchRowAcquired));
+		}
+	}
+}
+
+void ULyraAccoladeHostWidget::OnPrefetchRowAcquired(const FDataRegistryAcquireResult& AccoladeHandle)
+{
+	const FLyraAccoladeDefinitionRow* AccoladeRow = AccoladeHandle.GetItem<FLyraAccoladeDefinitionRow>();
+	const FName AccoladeName = AccoladeHandle.ItemId.ItemName;
+	if (!bStartedPrefetch || (AccoladeRow == nullptr) || PrefetchedAccolades.Contains(AccoladeName) || PrefetchingAccoladeRows.Contains(AccoladeName))
+	{
+		return;
+	}
+
+	TArray<FSoftObjectPath> AssetsToLoad;
+
+	// Accolades for other locations are never displayed here, so only their rows are needed
+	if (AccoladeRow->LocationTag == LocationName)
+	{
+		if (!AccoladeRow->Sound.IsNull())
+		{
+			AssetsToLoad.Add(AccoladeRow->Sound.ToSoftObjectPath());
+		}
+		if (!AccoladeRow->Icon.IsNull())
+		{
+			AssetsToLoad.Add(AccoladeRow->Icon.ToSoftObjectPath());
+		}
+	}
+
+	PrefetchingAccoladeRows.Add(AccoladeName, *AccoladeRow);
+
+	if (AssetsToLoad.Num() > 0)
+	{
+		TSharedPtr<FStreamableHandle> Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(AssetsToLoad,
+			FStreamableDelegate::CreateUObject(this, &ThisClass::OnPrefetchAssetsLoaded, AccoladeName),
+			FStreamableManager::DefaultAsyncLoadPriority, false, false, TEXT("LyraAccoladeHostWidget"));
+		if (Handle.IsValid())
+		{
+			PrefetchHandles.Add(Handle);
+			return;
+		}
+	}
+
+	OnPrefetchAssetsLoaded(AccoladeName);
+}
+
+void ULyraAccoladeHostWidget::OnPrefetchAssetsLoaded(FName AccoladeName)
+{
+	FLyraAccoladeDefinitionRow AccoladeRow;
+	if (PrefetchingAccoladeRows.RemoveAndCopyValue(AccoladeName, /*out*/ AccoladeRow))
+	{
+		FPendingAccoladeEntry& PrefetchedEntry = PrefetchedAccolades.Add(AccoladeName);
+		PrefetchedEntry.Row = MoveTemp(AccoladeRow);
+		PrefetchedEntry.AccoladeName = AccoladeName;
+		PrefetchedEntry.Sound = PrefetchedEntry.Row.Sound.Get();
+		PrefetchedEntry.Icon = PrefetchedEntry.Row.Icon.Get();
+		PrefetchedEntry.bFinishedLoading = true;
+	}
+
+	PrefetchHandles.RemoveAll([](const TSharedPtr<FStreamableHandle>& Handle) { return !Handle.IsValid() || Handle->HasLoadCompleted(); });
+}
+
 void ULyraAccoladeHostWidget::ConsiderLoadedAccolades()
 {
 	int32 PendingIndexToDisplay;
@@ -117,9 +269,9 @@ void ULyraAccoladeHostWidget::ProcessLoadedAccolade(const FPendingAccoladeEntry&
 		{
 			if (PendingAccoladeDisplays[Index].Row.AccoladeTags.HasAny(Entry.Row.CancelAccoladesWithTag))
 			{
-				if (UUserWidget* OldWidget = PendingAccoladeDisplays[Index].AllocatedWidget)
+				if (PendingAccoladeDisplays[Index].AllocatedWidget != nullptr)
 				{
-					DestroyAccoladeWidget(OldWidget);
+					RecycleAccoladeWidget(PendingAccoladeDisplays[Index]);
 					bRecreateWidget = true;
 				}
 				PendingAccoladeDisplays.RemoveAt(Index);
@@ -146,7 +298,7 @@ void ULyraAccoladeHostWidget::DisplayNextAccolade()
 		FPendingAccoladeEntry& Entry = PendingAccoladeDisplays[0];
 
 		GetWorld()->GetTimerManager().SetTimer(NextTimeToReconsiderHandle, this, &ThisClass::PopDisplayedAccolade, Entry.Row.DisplayDuration);
-		Entry.AllocatedWidget = CreateAccoladeWidget(Entry);
+		Entry.AllocatedWidget = AcquireAccoladeWidget(Entry);
 	}
 }
 
@@ -154,13 +306,88 @@ void ULyraAccoladeHostWidget::PopDisplayedAccolade()
 {
 	if (PendingAccoladeDisplays.Num() > 0)
 	{
-		if (UUserWidget* OldWidget = PendingAccoladeDisplays[0].AllocatedWidget)
-		{
-			DestroyAccoladeWidget(OldWidget);
-		}
+		RecycleAccoladeWidget(PendingAccoladeDisplays[0]);
 		PendingAccoladeDisplays.RemoveAt(0);
 	}
 
 	DisplayNextAccolade();
 }
 
+UUserWidget* ULyraAccoladeHostWidget::AcquireAccoladeWidget(const FPendingAccoladeEntry& Entry)
+{
+	if (FLyraAccoladeWidgetPool* Pool = WidgetPools.Find(Entry.AccoladeName))
+	{
+		while (Pool->Widgets.Num() > 0)
+		{
+			UUserWidget* PooledWidget = Pool->Widgets.Pop();
+			if (IsValid(PooledWidget))
+			{
+				ReuseAccoladeWidget(PooledWidget, Entry);
+				return PooledWidget;
+			}
+
+			ReleasedWidgetSlots.Remove(PooledWidget);
+		}
+	}
+
+	return CreateAccoladeWidget(Entry);
+}
+
+void ULyraAccoladeHostWidget::RecycleAccoladeWidget(const FPendingAccoladeEntry& Entry)
+{
+	UUserWidget* Widget = Entry.AllocatedWidget;
+	if (Widget == nullptr)
+	{
+		return;
+	}
+
+	if ((MaxPooledWidgetsPerAccolade > 0) && !Entry.AccoladeName.IsNone())
+	{
+		FLyraAccoladeWidgetPool& Pool = WidgetPools.FindOrAdd(Entry.AccoladeName);
+		if (Pool.Widgets.Num() < MaxPooledWidgetsPerAccolade)
+		{
+			ReleaseAccoladeWidget(Widget);
+			Pool.Widgets.Add(Widget);
+			return;
+		}
+	}
+
+	DestroyAccoladeWidget(Widget);
+}
+
+void ULyraAccoladeHostWidget::ReuseAccoladeWidget_Implementation(UUserWidget* Widget, const FPendingAccoladeEntry& Entry)
+{
+	FLyraReleasedAccoladeWidgetSlot ReleasedSlot;
+	if (ReleasedWidgetSlots.RemoveAndCopyValue(Widget, /*out*/ ReleasedSlot) && (ReleasedSlot.Parent != nullptr))
+	{
+		// Adding it back constructs it again, which replays the animations it plays when it's first shown
+		UPanelSlot* NewSlot = ReleasedSlot.Parent->AddChild(Widget);
+		CopyPanelSlotLayout(ReleasedSlot.Slot, NewSlot);
+	}
+	else
+	{
+		Widget->SetVisibility(ESlateVisibility::HitTestInvisible);
+	}
+
+	if (Entry.Sound != nullptr)
+	{
+		PlaySound(Entry.Sound);
+	}
+}
+
+void ULyraAccoladeHostWidget::ReleaseAccoladeWidget_Implementation(UUserWidget* Widget)
+{
+	// Taking the widget out of its panel destructs it and stops its animations, without losing what it was set up to display
+	if (UPanelWidget* Parent = Widget->GetParent())
+	{
+		FLyraReleasedAccoladeWidgetSlot& ReleasedSlot = ReleasedWidgetSlots.Add(Widget);
+		ReleasedSlot.Parent = Parent;
+		ReleasedSlot.Slot = Widget->Slot;
+		Widget->RemoveFromParent();
+	}
+	else
+	{
+		Widget->SetVisibility(ESlateVisibility::Collapsed);
+	}
+}
+
@@ -13,6 +13,7 @@
 #include "Player/LyraPlayerState.h"
 #include "Character/LyraHealthComponent.h"
 #include "Input/IAimAssistTargetInterface.h"
+#include "Async/ParallelFor.h"
 #include "ShooterCoreRuntimeSettings.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(AimAssistTargetManagerComponent)
@@ -25,17 +26,20 @@ namespace LyraConsoleVariables
 		bDrawDebugViewfinder,
 		TEXT("Should we draw a debug box for the aim assist target viewfinder?"),
 		ECVF_Cheat);
-}
-
-const FLyraAimAssistTarget* FindTarget(const TArray<FLyraAimAssistTarget>& Targets, const UShapeComponent* TargetComponent)
-{
-	const FLyraAimAssistTarget* FoundTarget = Targets.FindByPredicate(
-	[&TargetComponent](const FLyraAimAssistTarget& Target)
-	{
-		return (Target.TargetShapeComponent == TargetComponent);
-	});
 
-	return FoundTarget;
+	static bool bParallelTargetScoring = true;
+	static FAutoConsoleVariableRef CVarParallelTargetScoring(
+		TEXT("lyra.Weapon.AimAssist.ParallelTargetScoring"),
+		bParallelTargetScoring,
+		TEXT("Should aim assist targets be projected and scored on worker threads?"),
+		ECVF_Default);
+
+	static int32 ParallelTargetScoringMinCandidates = 8;
+	static FAutoConsoleVariableRef CVarParallelTargetScoringMinCandidates(
+		TEXT("lyra.Weapon.AimAssist.ParallelTargetScoringMinCandidates"),
+		ParallelTargetScoringMinCandidates,
+		TEXT("Aim assist targets are only scored in parallel when there are at least this many candidates"),
+		ECVF_Default);
 }
 
 static bool GatherTargetInfo(const AActor* Actor, const UShapeComponent* ShapeComponent, FTransform& OutTransform, FCollisionShape& OutShape, FVector& OutShapeOrigin)
@@ -118,12 +122,13 @@ void UAimAssistTargetManagerComponent::GetVisibleTargets(const FAimAssistFilter&
 	const FBox2D AssistOuterReticleBounds = OwnerData.ProjectReticleToScreen(Settings.AssistOuterReticleWidth.GetValue(), Settings.AssistOuterReticleHeight.GetValue(), ReticleDepth);
 	const FBox2D TargetingReticleBounds = OwnerData.ProjectReticleToScreen(Settings.TargetingReticleWidth.GetValue(), Settings.TargetingReticleHeight.GetValue(), ReticleDepth);
 
-	static TArray<FOverlapResult> OverlapResults;
+	FAimAssistTargetScratch& Scratch = GetScratchForPlayer(PC);
+
 	// Do a world trace on the Aim Assist channel to get any visible targets
 	{
 		UWorld* World = GetWorld();
 		
-		OverlapResults.Reset();
+		Scratch.OverlapResults.Reset();
 
 		const FVector PawnLocation = OwnerPawn->GetActorLocation();
 		ECollisionChannel AimAssistChannel = GetAimAssistChannel();
@@ -132,7 +137,7 @@ void UAimAssistTargetManagerComponent::GetVisibleTargets(const FAimAssistFilter&
 
 		// Need to multiply these by 0.5 because MakeBox takes in half extents
 		FCollisionShape BoxShape = FCollisionShape::MakeBox(FVector3f(ReticleDepth * 0.5f, Settings.AssistOuterReticleWidth.GetValue() * 0.5f, Settings.AssistOuterReticleHeight.GetValue() * 0.5f));						
-		World->OverlapMultiByChannel(OUT OverlapResults, PawnLocation, OwnerData.PlayerTransform.GetRotation(), AimAssistChannel, BoxShape, Params);
+		World->OverlapMultiByChannel(OUT Scratch.OverlapResults, PawnLocation, OwnerData.PlayerTransform.GetRotation(), AimAssistChannel, BoxShape, Params);
 
 #if ENABLE_DRAW_DEBUG && !UE_BUILD_SHIPPING
 		if(LyraConsoleVariables::bDrawDebugViewfinder)
@@ -143,32 +148,37 @@ void UAimAssistTargetManagerComponent::GetVisibleTargets(const FAimAssistFilter&
 	}
 
 	// Gather target options from any visibile hit results that implement the IAimAssistTarget interface
-	TArray<FAimAssistTargetOptions> NewTargetData;
+	TArray<FAimAssistTargetOptions>& NewTargetData = Scratch.TargetOptions;
+	NewTargetData.Reset();
 	{
-		for (const FOverlapResult& Overlap : OverlapResults)
+		for (const FOverlapResult& Overlap : Scratch.OverlapResults)
 		{
 			TScriptInterface<IAimAssistTaget> TargetActor(Overlap.GetActor());
 			if (TargetActor)
 			{
-				FAimAssistTargetOptions TargetData;
+				FAimAssistTargetOptions& TargetData = NewTargetData.AddDefaulted_GetRef();
 				TargetActor->GatherTargetOptions(TargetData);
-				NewTargetData.Add(TargetData);
 			}
 			
 			TScriptInterface<IAimAssistTaget> TargetComponent(Overlap.GetComponent());
 			if (TargetComponent)
 			{
-				FAimAssistTargetOptions TargetData;
+				FAimAssistTargetOptions& TargetData = NewTargetData.AddDefaulted_GetRef();
 				TargetComponent->GatherTargetOptions(TargetData);
-				NewTargetData.Add(TargetData);
 			}			
 		}
 	}
-	
-	// Gather targets that are in front of the player
+
+	Scratch.OldTargetIndices.Reset();
+	for (int32 OldTargetIndex = 0; OldTargetIndex < OldTargets.Num(); ++OldTargetIndex)
+	{
+		Scratch.OldTargetIndices.Add(OldTargets[OldTargetIndex].TargetShapeComponent.Get(), OldTargetIndex);
+	}
+
+	// Filter the targets and read their transforms into a flat candidate list. Anything that touches other objects stays on the game thread.
+	TArray<FAimAssistTargetCandidate>& Candidates = Scratch.Candidates;
+	Candidates.Reset();
 	{
-		const FVector PawnLocation = OwnerPawn->GetActorLocation();		
-		
 		for (FAimAssistTargetOptions& AimAssistTarget : NewTargetData)
 		{
 			if (!DoesTargetPassFilter(OwnerData, Filter, AimAssistTarget, TargetRange))
@@ -176,83 +186,90 @@ void UAimAssistTargetManagerComponent::GetVisibleTargets(const FAimAssistFilter&
 				continue;
 			}
 			
-			AActor* OwningActor = AimAssistTarget.TargetShapeComponent->GetOwner();
+			UShapeComponent* ShapeComponent = AimAssistTarget.TargetShapeComponent.Get();
+			AActor* OwningActor = ShapeComponent->GetOwner();
 
-			FTransform TargetTransform;
-			FCollisionShape TargetShape;
-			FVector TargetShapeOrigin;
-
-			if (!GatherTargetInfo(OwningActor, AimAssistTarget.TargetShapeComponent.Get(), TargetTransform, TargetShape, TargetShapeOrigin))
-			{
-				continue;
-			}
-			
-			const FVector TargetViewLocation = TargetTransform.TransformPositionNoScale(TargetShapeOrigin);
-			const FVector TargetViewVector = (TargetViewLocation - ViewLocation);
-
-			FVector TargetViewDirection;
-			float TargetViewDistance;
-			TargetViewVector.ToDirectionAndLength(TargetViewDirection, TargetViewDistance);
-			const float TargetViewDot = FVector::DotProduct(TargetViewDirection, ViewForward);
-			if (TargetViewDot <= 0.0f)
+			FAimAssistTargetCandidate& Candidate = Candidates.AddDefaulted_GetRef();
+			if (!GatherTargetInfo(OwningActor, ShapeComponent, Candidate.Transform, Candidate.Shape, Candidate.ShapeOrigin))
 			{
+				Candidates.Pop(false);
 				continue;
 			}
-			
-			const FLyraAimAssistTarget* OldTarget = FindTarget(OldTargets, AimAssistTarget.TargetShapeComponent.Get());
 
-			// Calculate the screen bounds for this target
-			FBox2D TargetScreenBounds(ForceInitToZero);
-			const bool bUpdateTargetProjections = true;
-			if (bUpdateTargetProjections)
-			{
-				TargetScreenBounds = OwnerData.ProjectShapeToScreen(TargetShape, TargetShapeOrigin, TargetTransform);
-			}
-			else
-			{
-				// Target projections are not being updated so use the values from the previous frame if the target existed.
-				if (OldTarget)
-				{
-					TargetScreenBounds = OldTarget->ScreenBounds;
-				}
-			}
+			Candidate.ShapeComponent = ShapeComponent;
 
-			if (!TargetScreenBounds.bIsValid)
+			if (const int32* OldTargetIndex = Scratch.OldTargetIndices.Find(ShapeComponent))
 			{
-				continue;
+				Candidate.OldTarget = &OldTargets[*OldTargetIndex];
 			}
+		}
+	}
 
-			if (!TargetingReticleBounds.Intersect(TargetScreenBounds))
-			{
-				continue;
-			}
+	// Project and score the candidates that are in front of the player. This is pure math on the candidate, so it can run in parallel.
+	auto ScoreCandidate = [&](int32 CandidateIndex)
+	{
+		FAimAssistTargetCandidate& Candidate = Candidates[CandidateIndex];
 
-			FLyraAimAssistTarget NewTarget;
+		const FVector TargetViewLocation = Candidate.Transform.TransformPositionNoScale(Candidate.ShapeOrigin);
+		const FVector TargetViewVector = (TargetViewLocation - ViewLocation);
 
-			NewTarget.TargetShapeComponent = AimAssistTarget.TargetShapeComponent;
-			NewTarget.Location = TargetTransform.GetTranslation();
-			NewTarget.ScreenBounds = TargetScreenBounds;
-			NewTarget.ViewDistance = TargetViewDistance;
-			NewTarget.bUnderAssistInnerReticle = AssistInnerReticleBounds.Intersect(TargetScreenBounds);
-			NewTarget.bUnderAssistOuterReticle = AssistOuterReticleBounds.Intersect(TargetScreenBounds);
-			
-			// Transfer target data from last frame.
-			if (OldTarget)
-			{
-				NewTarget.DeltaMovement = (NewTarget.Location - OldTarget->Location);
-				NewTarget.AssistTime = OldTarget->AssistTime;
-				NewTarget.AssistWeight = OldTarget->AssistWeight;
-				NewTarget.VisibilityTraceHandle = OldTarget->VisibilityTraceHandle;
-			}
+		FVector TargetViewDirection;
+		float TargetViewDistance;
+		TargetViewVector.ToDirectionAndLength(TargetViewDirection, TargetViewDistance);
+		const float TargetViewDot = FVector::DotProduct(TargetViewDirection, ViewForward);
+		if (TargetViewDot <= 0.0f)
+		{
+			return;
+		}
+
+		// Calculate the screen bounds for this target
+		const FBox2D TargetScreenBounds = OwnerData.ProjectShapeToScreen(Candidate.Shape, Candidate.ShapeOrigin, Candidate.Transform);
+
+		if (!TargetScreenBounds.bIsValid)
+		{
+			return;
+		}
+
+		if (!TargetingReticleBounds.Intersect(TargetScreenBounds))
+		{
+			return;
+		}
+
+		FLyraAimAssistTarget& NewTarget = Candidate.Target;
+		NewTarget.TargetShapeComponent = Candidate.ShapeComponent;
+		NewTarget.Location = Candidate.Transform.GetTranslation();
+		NewTarget.ScreenBounds = TargetScreenBounds;
+		NewTarget.ViewDistance = TargetViewDistance;
+		NewTarget.bUnderAssistInnerReticle = AssistInnerReticleBounds.Intersect(TargetScreenBounds);
+		NewTarget.bUnderAssistOuterReticle = AssistOuterReticleBounds.Intersect(TargetScreenBounds);
+		
+		// Transfer target data from last frame.
+		if (const FLyraAimAssistTarget* OldTarget = Candidate.OldTarget)
+		{
+			NewTarget.DeltaMovement = (NewTarget.Location - OldTarget->Location);
+			NewTarget.AssistTime = OldTarget->AssistTime;
+			NewTarget.AssistWeight = OldTarget->AssistWeight;
+			NewTarget.VisibilityTraceHandle = OldTarget->VisibilityTraceHandle;
+			NewTarget.bIsVisible = OldTarget->bIsVisible;
+		}
+
+		// Calculate a score used for sorting based on previous weight, distance from target, and distance from reticle.
+		const float AssistWeightScore = (NewTarget.AssistWeight * Settings.TargetScore_AssistWeight);
+		const float ViewDotScore = ((TargetViewDot * Settings.TargetScore_ViewDot) - Settings.TargetScore_ViewDotOffset);
+		const float ViewDistanceScore = ((1.0f - (TargetViewDistance / TargetRange)) * Settings.TargetScore_ViewDistance);
 
-			// Calculate a score used for sorting based on previous weight, distance from target, and distance from reticle.
-			const float AssistWeightScore = (NewTarget.AssistWeight * Settings.TargetScore_AssistWeight);
-			const float ViewDotScore = ((TargetViewDot * Settings.TargetScore_ViewDot) - Settings.TargetScore_ViewDotOffset);
-			const float ViewDistanceScore = ((1.0f - (TargetViewDistance / TargetRange)) * Settings.TargetScore_ViewDistance);
+		NewTarget.SortScore = (AssistWeightScore + ViewDotScore + ViewDistanceScore);
+		Candidate.bIsTarget = true;
+	};
 
-			NewTarget.SortScore = (AssistWeightScore + ViewDotScore + ViewDistanceScore);
+	const bool bScoreInParallel = LyraConsoleVariables::bParallelTargetScoring && (Candidates.Num() >= LyraConsoleVariables::ParallelTargetScoringMinCandidates);
+	ParallelFor(Candidates.Num(), ScoreCandidate, bScoreInParallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
 
-			OutNewTargets.Add(NewTarget);
+	for (const FAimAssistTargetCandidate& Candidate : Candidates)
+	{
+		if (Candidate.bIsTarget)
+		{
+			OutNewTargets.Add(Candidate.Target);
 		}
 	}
 
@@ -268,12 +285,26 @@ void UAimAssistTargetManagerComponent::GetVisibleTargets(const FAimAssistFilter&
 	}
 
 	// Do visibliity traces on the targets
+	UpdateTargetVisibility(OutNewTargets, Settings, Filter, OwnerData);
+}
+
+FAimAssistTargetScratch& UAimAssistTargetManagerComponent::GetScratchForPlayer(const APlayerController* PC)
+{
+	if (FAimAssistTargetScratch* Scratch = PlayerScratch.Find(PC))
+	{
+		return *Scratch;
+	}
+
+	// A new player is showing up, so it's a good time to forget about any that have gone away
+	for (auto It = PlayerScratch.CreateIterator(); It; ++It)
 	{
-		for (FLyraAimAssistTarget& Target : OutNewTargets)
+		if (!It.Key().ResolveObjectPtr())
 		{
-			DetermineTargetVisibility(Target, Settings, Filter, OwnerData);
+			It.RemoveCurrent();
 		}
 	}
+
+	return PlayerScratch.Add(PC);
 }
 
 bool UAimAssistTargetManagerComponent::DoesTargetPassFilter(const FAimAssistOwnerViewData& OwnerData, const FAimAssistFilter& Filter, const FAimAssistTargetOptions& Target, const float AcceptableRange) const
@@ -381,25 +412,39 @@ float UAimAssistTargetManagerComponent::GetFOVScale(const APlayerController* PC,
 	return FovScale;
 }
 
-void UAimAssistTargetManagerComponent::DetermineTargetVisibility(FLyraAimAssistTarget& Target, const FAimAssistSettings& Settings, const FAimAssistFilter& Filter, const FAimAssistOwnerViewData& OwnerData)
+void UAimAssistTargetManagerComponent::UpdateTargetVisibility(TArrayView<FLyraAimAssistTarget> Targets, const FAimAssistSettings& Settings, const FAimAssistFilter& Filter, const FAimAssistOwnerViewData& OwnerData)
 {
 	UWorld* World = GetWorld();
 	check(World);
 
-	const AActor* Actor = Target.TargetShapeComponent->GetOwner();
-	if (!Actor)
+	// Targets whose async trace just came back blocked stay hidden for this frame, and get a synchronous trace next frame
+	TBitArray<> HiddenByAsyncTrace(false, Targets.Num());
+
+	// Query for the previous asynchronous trace results.
+	if (Settings.bEnableAsyncVisibilityTrace)
 	{
-		ensure(false);
-		return;
-	}
+		for (int32 TargetIndex = 0; TargetIndex < Targets.Num(); ++TargetIndex)
+		{
+			FLyraAimAssistTarget& Target = Targets[TargetIndex];
+			if (Target.bIsVisible && Target.VisibilityTraceHandle.IsValid())
+			{
+				FTraceDatum TraceDatum;
+				if (World->QueryTraceData(Target.VisibilityTraceHandle, TraceDatum))
+				{
+					Target.bIsVisible = (FHitResult::GetFirstBlockingHit(TraceDatum.OutHits) == nullptr);
+				}
+				else
+				{
+					UE_LOG(LogAimAssist, Warning, TEXT("UAimAssistTargetManagerComponent::UpdateTargetVisibility() - Failed to find async visibility trace data!"));
+					Target.bIsVisible = false;
+				}
 
-	FVector TargetEyeLocation;
-	FRotator TargetEyeRotation;
-	Actor->GetActorEyesViewPoint(TargetEyeLocation, TargetEyeRotation);
-	
-	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(AimAssist_DetermineTargetVisibility), true);
-	InitTargetSelectionCollisionParams(QueryParams, *Actor, Filter);
-	QueryParams.AddIgnoredActor(Actor);
+				// Invalidate the async trace handle.
+				Target.VisibilityTraceHandle = FTraceHandle();
+				HiddenByAsyncTrace[TargetIndex] = !Target.bIsVisible;
+			}
+		}
+	}
 
 	const UShooterCoreRuntimeSettings* ShooterSettings = GetDefault<UShooterCoreRuntimeSettings>();
 	const ECollisionChannel AimAssistChannel = ShooterSettings->GetAimAssistCollisionChannel();
@@ -408,38 +453,43 @@ void UAimAssistTargetManagerComponent::DetermineTargetVisibility(FLyraAimAssistT
 	ResponseParams.CollisionResponse.SetResponse(ECC_Pawn, ECR_Ignore);	
 	ResponseParams.CollisionResponse.SetResponse(AimAssistChannel, ECR_Ignore);
 
-	if (Target.bIsVisible && Settings.bEnableAsyncVisibilityTrace)
+	const FVector ViewLocation = OwnerData.ViewTransform.GetTranslation();
+
+	for (int32 TargetIndex = 0; TargetIndex < Targets.Num(); ++TargetIndex)
 	{
-		// Query for previous asynchronous trace result.
-		if (Target.VisibilityTraceHandle.IsValid())
+		if (HiddenByAsyncTrace[TargetIndex])
 		{
-			FTraceDatum TraceDatum;
-			if (World->QueryTraceData(Target.VisibilityTraceHandle, TraceDatum))
-			{
-				Target.bIsVisible = (FHitResult::GetFirstBlockingHit(TraceDatum.OutHits) == nullptr);
-			}
-			else
-			{
-				UE_LOG(LogAimAssist, Warning, TEXT("UAimAssistTargetManagerComponent::DetermineTargetVisibility() - Failed to find async visibility trace data!"));
-				Target.bIsVisible = false;
-			}
+			continue;
+		}
 
-			// Invalidate the async trace handle.
-			Target.VisibilityTraceHandle = FTraceHandle();
+		FLyraAimAssistTarget& Target = Targets[TargetIndex];
+		const AActor* Actor = Target.TargetShapeComponent->GetOwner();
+		if (!Actor)
+		{
+			ensure(false);
+			continue;
 		}
 
-		// Only start a new asynchronous trace for next frame if the target is still visible.
-		if (Target.bIsVisible)
+		FVector TargetEyeLocation;
+		FRotator TargetEyeRotation;
+		Actor->GetActorEyesViewPoint(TargetEyeLocation, TargetEyeRotation);
+		
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(AimAssist_DetermineTargetVisibility), true);
+		InitTargetSelectionCollisionParams(QueryParams, *Actor, Filter);
+		QueryParams.AddIgnoredActor(Actor);
+
+		if (Target.bIsVisible && Settings.bEnableAsyncVisibilityTrace)
 		{
-			Target.VisibilityTraceHandle = World->AsyncLineTraceByChannel(EAsyncTraceType::Test, OwnerData.ViewTransform.GetTranslation(), TargetEyeLocation, ECC_Visibility, QueryParams, ResponseParams);
+			// Only start a new asynchronous trace for next frame if the target is still visible.
+			Target.VisibilityTraceHandle = World->AsyncLineTraceByChannel(EAsyncTraceType::Test, ViewLocation, TargetEyeLocation, ECC_Visibility, QueryParams, ResponseParams);
 		}
-	}
-	else
-	{
-		Target.bIsVisible = !World->LineTraceTestByChannel(OwnerData.ViewTransform.GetTranslation(), TargetEyeLocation, ECC_Visibility, QueryParams, ResponseParams);
+		else
+		{
+			Target.bIsVisible = !World->LineTraceTestByChannel(ViewLocation, TargetEyeLocation, ECC_Visibility, QueryParams, ResponseParams);
 
-		// Invalidate the async trace handle.
-		Target.VisibilityTraceHandle = FTraceHandle();		
+			// Invalidate the async trace handle.
+			Target.VisibilityTraceHandle = FTraceHandle();		
+		}
 	}
 }
 
@@ -10,10 +10,14 @@
 #include "LyraAccoladeHostWidget.generated.h"
 
 class UObject;
+class ULyraExperienceDefinition;
+class UPanelSlot;
+class UPanelWidget;
 class USoundBase;
 class UUserWidget;
 struct FDataRegistryAcquireResult;
 struct FLyraNotificationMessage;
+struct FStreamableHandle;
 
 USTRUCT(BlueprintType)
 struct FPendingAccoladeEntry
@@ -23,6 +27,10 @@ struct FPendingAccoladeEntry
 	UPROPERTY(BlueprintReadOnly)
 	FLyraAccoladeDefinitionRow Row; 
 
+	// The accolade's registry item name, widgets are pooled per accolade
+	UPROPERTY(BlueprintReadOnly)
+	FName AccoladeName;
+
 	UPROPERTY(BlueprintReadOnly)
 	TObjectPtr<USoundBase> Sound = nullptr;
 
@@ -39,6 +47,29 @@ struct FPendingAccoladeEntry
 	void CancelDisplay();
 };
 
+USTRUCT()
+struct FLyraAccoladeWidgetPool
+{
+	GENERATED_BODY()
+
+	// Hidden widgets that were displaying this accolade, ready to be shown again
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UUserWidget>> Widgets;
+};
+
+USTRUCT()
+struct FLyraReleasedAccoladeWidgetSlot
+{
+	GENERATED_BODY()
+
+	// The panel a released widget was taken out of, and its old slot so it goes back in with the same layout
+	UPROPERTY(Transient)
+	TObjectPtr<UPanelWidget> Parent = nullptr;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UPanelSlot> Slot = nullptr;
+};
+
 /**
  * 
  */
@@ -62,6 +93,22 @@ public:
 
 	UFUNCTION(BlueprintImplementableEvent)
 	UUserWidget* CreateAccoladeWidget(const FPendingAccoladeEntry& Entry);
+
+	// Called instead of CreateAccoladeWidget when a pooled widget of the same accolade is shown again
+	// The default implementation adds it back to the panel it was released from, so it's constructed again
+	// and replays its display animations, and plays the accolade sound
+	UFUNCTION(BlueprintNativeEvent)
+	void ReuseAccoladeWidget(UUserWidget* Widget, const FPendingAccoladeEntry& Entry);
+
+	// Called instead of DestroyAccoladeWidget when a widget is kept for reuse
+	// The default implementation takes it out of its panel (or collapses it if it isn't in one)
+	UFUNCTION(BlueprintNativeEvent)
+	void ReleaseAccoladeWidget(UUserWidget* Widget);
+
+	// The maximum number of hidden widgets kept per accolade for reuse (0 disables pooling)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	int32 MaxPooledWidgetsPerAccolade = 2;
+
 private:
 	FGameplayMessageListenerHandle ListenerHandle;
 
@@ -78,10 +125,38 @@ private:
 	UPROPERTY(Transient)
 	TArray<FPendingAccoladeEntry> PendingAccoladeDisplays;
 
+	// Rows and loaded assets of every accolade in the registry, keyed by registry item name, so displaying one never waits on a load
+	UPROPERTY(Transient)
+	TMap<FName, FPendingAccoladeEntry> PrefetchedAccolades;
+
+	// Rows whose sound and icon are still being prefetched
+	TMap<FName, FLyraAccoladeDefinitionRow> PrefetchingAccoladeRows;
+
+	TArray<TSharedPtr<FStreamableHandle>> PrefetchHandles;
+
+	bool bStartedPrefetch = false;
+
+	UPROPERTY(Transient)
+	TMap<FName, FLyraAccoladeWidgetPool> WidgetPools;
+
+	// Where the default ReleaseAccoladeWidget took pooled widgets out of their panel
+	UPROPERTY(Transient)
+	TMap<TObjectPtr<UUserWidget>, FLyraReleasedAccoladeWidgetSlot> ReleasedWidgetSlots;
 
 	void OnNotificationMessage(FGameplayTag Channel, const FLyraNotificationMessage& Notification);
 	void OnRegistryLoadCompleted(const FDataRegistryAcquireResult& AccoladeHandle, int32 SequenceID);
 
+	void OnExperienceLoaded(const ULyraExperienceDefinition* Experience);
+	void PrefetchAccolades();
+	void OnPrefetchRowAcquired(const FDataRegistryAcquireResult& AccoladeHandle);
+	void OnPrefetchAssetsLoaded(FName AccoladeName);
+
+	// Returns a pooled widget for the entry's accolade if there is one, otherwise creates a new one
+	UUserWidget* AcquireAccoladeWidget(const FPendingAccoladeEntry& Entry);
+
+	// Returns the entry's widget to its accolade's pool, or destroys it if the pool is full
+	void RecycleAccoladeWidget(const FPendingAccoladeEntry& Entry);
+
 	void ConsiderLoadedAccolades();
 	void PopDisplayedAccolade();
 	void ProcessLoadedAccolade(const FPendingAccoladeEntry& Entry);
@@ -3,6 +3,8 @@
 #pragma once
 
 #include "Components/GameStateComponent.h"
+#include "Input/IAimAssistTargetInterface.h"
+#include "UObject/ObjectKey.h"
 
 #include "AimAssistTargetManagerComponent.generated.h"
 
@@ -13,9 +15,33 @@ class UObject;
 struct FAimAssistFilter;
 struct FAimAssistOwnerViewData;
 struct FAimAssistSettings;
-struct FAimAssistTargetOptions;
 struct FCollisionQueryParams;
-struct FLyraAimAssistTarget;
+
+/** A target from the overlap that passed the filter, waiting to be projected and scored */
+struct FAimAssistTargetCandidate
+{
+	UShapeComponent* ShapeComponent = nullptr;
+
+	/** This target's entry in last frame's targets, if it had one */
+	const FLyraAimAssistTarget* OldTarget = nullptr;
+
+	FTransform Transform;
+	FCollisionShape Shape;
+	FVector ShapeOrigin = FVector::ZeroVector;
+
+	/** Written by the scoring pass, only used if bIsTarget is set */
+	FLyraAimAssistTarget Target;
+	bool bIsTarget = false;
+};
+
+/** Buffers reused by every GetVisibleTargets call for one player, so split screen players don't share any state */
+struct FAimAssistTargetScratch
+{
+	TArray<FOverlapResult> OverlapResults;
+	TArray<FAimAssistTargetOptions> TargetOptions;
+	TArray<FAimAssistTargetCandidate> Candidates;
+	TMap<const UShapeComponent*, int32> OldTargetIndices;
+};
 
 /**
  * The Aim Assist Target Manager Component is used to gather all aim assist targets that are within
@@ -46,9 +72,17 @@ protected:
 	 */
 	bool DoesTargetPassFilter(const FAimAssistOwnerViewData& OwnerData, const FAimAssistFilter& Filter, const FAimAssistTargetOptions& Target, const float AcceptableRange) const;
 
-	/** Determine if the given target is visible based on our current view data. */
-	void DetermineTargetVisibility(FLyraAimAssistTarget& Target, const FAimAssistSettings& Settings, const FAimAssistFilter& Filter, const FAimAssistOwnerViewData& OwnerData);
+	/**
+	 * Determine which of the given targets are visible based on our current view data.
+	 * Last frame's async trace results are all collected before any new traces are started, so each frame's traces go out as one batch.
+	 */
+	void UpdateTargetVisibility(TArrayView<FLyraAimAssistTarget> Targets, const FAimAssistSettings& Settings, const FAimAssistFilter& Filter, const FAimAssistOwnerViewData& OwnerData);
 	
 	/** Setup CollisionQueryParams to ignore a set of actors based on filter settings. Such as Ignoring Requester or Instigator. */
 	void InitTargetSelectionCollisionParams(FCollisionQueryParams& OutParams, const AActor& RequestedBy, const FAimAssistFilter& Filter) const;
+
+	/** Returns the scratch buffers for the given player, creating them the first time they ask for targets */
+	FAimAssistTargetScratch& GetScratchForPlayer(const APlayerController* PC);
+
+	TMap<TObjectKey<APlayerController>, FAimAssistTargetScratch> PlayerScratch;
 };
@@ -10,6 +10,27 @@
 
 class FSubsystemCollectionBase;
 
+namespace UIExtensionCVars
+{
+	static bool bBatchNotifications = true;
+	static FAutoConsoleVariableRef CVarBatchNotifications(
+		TEXT("UIExtension.BatchNotifications"),
+		bBatchNotifications,
+		TEXT("Should registrations inside a notification batch be notified once when the batch ends, grouped per extension point?"),
+		ECVF_Default);
+}
+
+namespace UIExtensionSystem
+{
+	static void GatherTagChain(const FGameplayTag& Tag, TArray<FGameplayTag>& OutTagChain)
+	{
+		for (FGameplayTag ChainTag = Tag; ChainTag.IsValid(); ChainTag = ChainTag.RequestDirectParent())
+		{
+			OutTagChain.Add(ChainTag);
+		}
+	}
+}
+
 //=========================================================
 
 void FUIExtensionPointHandle::Unregister()
@@ -45,13 +66,23 @@ bool FUIExtensionPoint::DoesExtensionPassContract(const FUIExtension* Extension)
 		{
 			// The data can either be the literal class of the data type, or a instance of the class type.
 			const UClass* DataClass = DataPtr->IsA(UClass::StaticClass()) ? Cast<UClass>(DataPtr) : DataPtr->GetClass();
+			if (const bool* bCachedCompatible = DataClassCompatibility.Find(DataClass))
+			{
+				return *bCachedCompatible;
+			}
+
+			bool bCompatible = false;
 			for (const UClass* AllowedDataClass : AllowedDataClasses)
 			{
 				if (DataClass->IsChildOf(AllowedDataClass) || DataClass->ImplementsInterface(AllowedDataClass))
 				{
-					return true;
+					bCompatible = true;
+					break;
 				}
 			}
+
+			DataClassCompatibility.Add(DataClass, bCompatible);
+			return bCompatible;
 		}
 	}
 
@@ -89,9 +120,30 @@ void UUIExtensionSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 
 void UUIExtensionSubsystem::Deinitialize()
 {
+	PendingExtensionPoints.Reset();
+	PendingExtensions.Reset();
+	NotificationBatchDepth = 0;
+
 	Super::Deinitialize();
 }
 
+void UUIExtensionSubsystem::BeginNotificationBatch()
+{
+	++NotificationBatchDepth;
+}
+
+void UUIExtensionSubsystem::EndNotificationBatch()
+{
+	if (ensure(NotificationBatchDepth > 0))
+	{
+		--NotificationBatchDepth;
+		if (NotificationBatchDepth == 0)
+		{
+			FlushPendingNotifications();
+		}
+	}
+}
+
 FUIExtensionPointHandle UUIExtensionSubsystem::RegisterExtensionPoint(const FGameplayTag& ExtensionPointTag, EUIExtensionPointMatch ExtensionPointTagMatchType, const TArray<UClass*>& AllowedDataClasses, FExtendExtensionPointDelegate ExtensionCallback)
 {
 	return RegisterExtensionPointForContext(ExtensionPointTag, nullptr, ExtensionPointTagMatchType, AllowedDataClasses, ExtensionCallback);
@@ -117,18 +169,28 @@ FUIExtensionPointHandle UUIExtensionSubsystem::RegisterExtensionPointForContext(
 		return FUIExtensionPointHandle();
 	}
 
-	FExtensionPointList& List = ExtensionPointMap.FindOrAdd(ExtensionPointTag);
+	const FObjectKey ContextKey(ContextObject);
+	FExtensionPointList& List = ExtensionPointMap.FindOrAdd(FExtensionKey(ExtensionPointTag, ContextKey));
 
-	TSharedPtr<FUIExtensionPoint>& Entry = List.Add_GetRef(MakeShared<FUIExtensionPoint>());
+	TSharedPtr<FUIExtensionPoint> Entry = List.Add_GetRef(MakeShared<FUIExtensionPoint>());
 	Entry->ExtensionPointTag = ExtensionPointTag;
 	Entry->ContextObject = ContextObject;
 	Entry->ExtensionPointTagMatchType = ExtensionPointTagMatchType;
 	Entry->AllowedDataClasses = AllowedDataClasses;
 	Entry->Callback = MoveTemp(ExtensionCallback);
+	Entry->ContextKey = ContextKey;
+	UIExtensionSystem::GatherTagChain(ExtensionPointTag, Entry->TagChain);
 
 	UE_LOG(LogUIExtension, Verbose, TEXT("Extension Point [%s] Registered"), *ExtensionPointTag.ToString());
 
-	NotifyExtensionPointOfExtensions(Entry);
+	if ((NotificationBatchDepth > 0) && UIExtensionCVars::bBatchNotifications)
+	{
+		PendingExtensionPoints.Add(Entry);
+	}
+	else
+	{
+		NotifyExtensionPointOfExtensions(Entry);
+	}
 
 	return FUIExtensionPointHandle(this, Entry);
 }
@@ -157,13 +219,16 @@ FUIExtensionHandle UUIExtensionSubsystem::RegisterExtensionAsData(const FGamepla
 		return FUIExtensionHandle();
 	}
 
-	FExtensionList& List = ExtensionMap.FindOrAdd(ExtensionPointTag);
+	const FObjectKey ContextKey(ContextObject);
+	FExtensionList& List = ExtensionMap.FindOrAdd(FExtensionKey(ExtensionPointTag, ContextKey));
 
-	TSharedPtr<FUIExtension>& Entry = List.Add_GetRef(MakeShared<FUIExtension>());
+	TSharedPtr<FUIExtension> Entry = List.Add_GetRef(MakeShared<FUIExtension>());
 	Entry->ExtensionPointTag = ExtensionPointTag;
 	Entry->ContextObject = ContextObject;
 	Entry->Data = Data;
 	Entry->Priority = Priority;
+	Entry->ContextKey = ContextKey;
+	UIExtensionSystem::GatherTagChain(ExtensionPointTag, Entry->TagChain);
 
 	if (ContextObject)
 	{
@@ -174,16 +239,23 @@ FUIExtensionHandle UUIExtensionSubsystem::RegisterExtensionAsData(const FGamepla
 		UE_LOG(LogUIExtension, Verbose, TEXT("Extension [%s] for [%s] @ [%s] Registered"), *GetNameSafe(Data), *GetNameSafe(ContextObject), *ExtensionPointTag.ToString());
 	}
 
-	NotifyExtensionPointsOfExtension(EUIExtensionAction::Added, Entry);
+	if ((NotificationBatchDepth > 0) && UIExtensionCVars::bBatchNotifications)
+	{
+		PendingExtensions.Add(Entry);
+	}
+	else
+	{
+		NotifyExtensionPointsOfExtension(EUIExtensionAction::Added, Entry);
+	}
 
 	return FUIExtensionHandle(this, Entry);
 }
 
 void UUIExtensionSubsystem::NotifyExtensionPointOfExtensions(TSharedPtr<FUIExtensionPoint>& ExtensionPoint)
 {
-	for (FGameplayTag Tag = ExtensionPoint->ExtensionPointTag; Tag.IsValid(); Tag = Tag.RequestDirectParent())
+	for (const FGameplayTag& Tag : ExtensionPoint->TagChain)
 	{
-		if (const FExtensionList* ListPtr = ExtensionMap.Find(Tag))
+		if (const FExtensionList* ListPtr = ExtensionMap.Find(FExtensionKey(Tag, ExtensionPoint->ContextKey)))
 		{
 			// Copy in case there are removals while handling callbacks
 			FExtensionList ExtensionArray(*ListPtr);
@@ -208,9 +280,9 @@ void UUIExtensionSubsystem::NotifyExtensionPointOfExtensions(TSharedPtr<FUIExten
 void UUIExtensionSubsystem::NotifyExtensionPointsOfExtension(EUIExtensionAction Action, TSharedPtr<FUIExtension>& Extension)
 {
 	bool bOnInitialTag = true;
-	for (FGameplayTag Tag = Extension->ExtensionPointTag; Tag.IsValid(); Tag = Tag.RequestDirectParent())
+	for (const FGameplayTag& Tag : Extension->TagChain)
 	{
-		if (const FExtensionPointList* ListPtr = ExtensionPointMap.Find(Tag))
+		if (const FExtensionPointList* ListPtr = ExtensionPointMap.Find(FExtensionKey(Tag, Extension->ContextKey)))
 		{
 			// Copy in case there are removals while handling callbacks
 			FExtensionPointList ExtensionPointArray(*ListPtr);
@@ -232,6 +304,73 @@ void UUIExtensionSubsystem::NotifyExtensionPointsOfExtension(EUIExtensionAction
 	}
 }
 
+void UUIExtensionSubsystem::FlushPendingNotifications()
+{
+	if (PendingExtensionPoints.IsEmpty() && PendingExtensions.IsEmpty())
+	{
+		return;
+	}
+
+	FExtensionPointList NewExtensionPoints = MoveTemp(PendingExtensionPoints);
+	FExtensionList NewExtensions = MoveTemp(PendingExtensions);
+
+	UE_LOG(LogUIExtension, Verbose, TEXT("Flushing batched notifications for %d extension points and %d extensions"), NewExtensionPoints.Num(), NewExtensions.Num());
+
+	// New extension points learn about every extension, including the ones added in this batch
+	TSet<TSharedPtr<FUIExtensionPoint>> NewExtensionPointSet;
+	NewExtensionPointSet.Reserve(NewExtensionPoints.Num());
+	for (TSharedPtr<FUIExtensionPoint>& ExtensionPoint : NewExtensionPoints)
+	{
+		NewExtensionPointSet.Add(ExtensionPoint);
+	}
+
+	for (TSharedPtr<FUIExtensionPoint>& ExtensionPoint : NewExtensionPoints)
+	{
+		if (ExtensionPoint->bRegistered)
+		{
+			NotifyExtensionPointOfExtensions(ExtensionPoint);
+		}
+	}
+
+	// Group the new extensions by the existing extension points they match, so each point handles all of them in one pass
+	TMap<TSharedPtr<FUIExtensionPoint>, FExtensionList> ExtensionsByPoint;
+	for (const TSharedPtr<FUIExtension>& Extension : NewExtensions)
+	{
+		bool bOnInitialTag = true;
+		for (const FGameplayTag& Tag : Extension->TagChain)
+		{
+			if (const FExtensionPointList* ListPtr = ExtensionPointMap.Find(FExtensionKey(Tag, Extension->ContextKey)))
+			{
+				for (const TSharedPtr<FUIExtensionPoint>& ExtensionPoint : *ListPtr)
+				{
+					if ((bOnInitialTag || (ExtensionPoint->ExtensionPointTagMatchType == EUIExtensionPointMatch::PartialMatch)) &&
+						!NewExtensionPointSet.Contains(ExtensionPoint) &&
+						ExtensionPoint->DoesExtensionPassContract(Extension.Get()))
+					{
+						ExtensionsByPoint.FindOrAdd(ExtensionPoint).Add(Extension);
+					}
+				}
+			}
+
+			bOnInitialTag = false;
+		}
+	}
+
+	for (const TPair<TSharedPtr<FUIExtensionPoint>, FExtensionList>& Pair : ExtensionsByPoint)
+	{
+		const TSharedPtr<FUIExtensionPoint>& ExtensionPoint = Pair.Key;
+		for (const TSharedPtr<FUIExtension>& Extension : Pair.Value)
+		{
+			// Callbacks can unregister either side while we're delivering
+			if (ExtensionPoint->bRegistered && Extension->bRegistered)
+			{
+				FUIExtensionRequest Request = CreateExtensionRequest(Extension);
+				ExtensionPoint->Callback.ExecuteIfBound(EUIExtensionAction::Added, Request);
+			}
+		}
+	}
+}
+
 void UUIExtensionSubsystem::UnregisterExtension(const FUIExtensionHandle& ExtensionHandle)
 {
 	if (ExtensionHandle.IsValid())
@@ -239,7 +378,8 @@ void UUIExtensionSubsystem::UnregisterExtension(const FUIExtensionHandle& Extens
 		checkf(ExtensionHandle.ExtensionSource == this, TEXT("Trying to unregister an extension that's not from this extension subsystem."));
 
 		TSharedPtr<FUIExtension> Extension = ExtensionHandle.DataPtr;
-		if (FExtensionList* ListPtr = ExtensionMap.Find(Extension->ExtensionPointTag))
+		const FExtensionKey Key(Extension->ExtensionPointTag, Extension->ContextKey);
+		if (FExtensionList* ListPtr = ExtensionMap.Find(Key))
 		{
 			if (Extension->ContextObject.IsExplicitlyNull())
 			{
@@ -250,13 +390,22 @@ void UUIExtensionSubsystem::UnregisterExtension(const FUIExtensionHandle& Extens
 				UE_LOG(LogUIExtension, Verbose, TEXT("Extension [%s] for [%s] @ [%s] Unregistered"), *GetNameSafe(Extension->Data), *GetNameSafe(Extension->ContextObject.Get()), *Extension->ExtensionPointTag.ToString());
 			}
 
-			NotifyExtensionPointsOfExtension(EUIExtensionAction::Removed, Extension);
+			Extension->bRegistered = false;
 
-			ListPtr->RemoveSwap(Extension);
-			
-			if (ListPtr->Num() == 0)
+			// Extension points never heard about an extension that's still waiting on its batch
+			if (PendingExtensions.RemoveSingle(Extension) == 0)
 			{
-				ExtensionMap.Remove(Extension->ExtensionPointTag);
+				NotifyExtensionPointsOfExtension(EUIExtensionAction::Removed, Extension);
+			}
+
+			// The callbacks may have added to the map, so find the list again
+			if (FExtensionList* CurrentListPtr = ExtensionMap.Find(Key))
+			{
+				CurrentListPtr->RemoveSwap(Extension);
+				if (CurrentListPtr->Num() == 0)
+				{
+					ExtensionMap.Remove(Key);
+				}
 			}
 		}
 	}
@@ -273,14 +422,18 @@ void UUIExtensionSubsystem::UnregisterExtensionPoint(const FUIExtensionPointHand
 		check(ExtensionPointHandle.ExtensionSource == this);
 
 		const TSharedPtr<FUIExtensionPoint> ExtensionPoint = ExtensionPointHandle.DataPtr;
-		if (FExtensionPointList* ListPtr = ExtensionPointMap.Find(ExtensionPoint->ExtensionPointTag))
+		const FExtensionKey Key(ExtensionPoint->ExtensionPointTag, ExtensionPoint->ContextKey);
+		if (FExtensionPointList* ListPtr = ExtensionPointMap.Find(Key))
 		{
 			UE_LOG(LogUIExtension, Verbose, TEXT("Extension Point [%s] Unregistered"), *ExtensionPoint->ExtensionPointTag.ToString());
 
+			ExtensionPoint->bRegistered = false;
+			PendingExtensionPoints.RemoveSingle(ExtensionPoint);
+
 			ListPtr->RemoveSwap(ExtensionPoint);
 			if (ListPtr->Num() == 0)
 			{
-				ExtensionPointMap.Remove(ExtensionPoint->ExtensionPointTag);
+				ExtensionPointMap.Remove(Key);
 			}
 		}
 	}
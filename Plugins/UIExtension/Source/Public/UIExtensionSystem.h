@@ -5,6 +5,7 @@
 #include "GameplayTagContainer.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
 
 #include "UIExtensionSystem.generated.h"
 
@@ -51,6 +52,13 @@ public:
 	TWeakObjectPtr<UObject> ContextObject;
 	//Kept alive by UUIExtensionSubsystem::AddReferencedObjects
 	TObjectPtr<UObject> Data = nullptr;
+
+	// Key of the context object when it was registered, the subsystem indexes extensions by (tag, context)
+	FObjectKey ContextKey;
+	// ExtensionPointTag followed by its parents, gathered once at registration
+	TArray<FGameplayTag> TagChain;
+	// Cleared when unregistered so pending batched notifications skip it
+	bool bRegistered = true;
 };
 
 /**
@@ -65,9 +73,20 @@ public:
 	TArray<TObjectPtr<UClass>> AllowedDataClasses;
 	FExtendExtensionPointDelegate Callback;
 
+	// Key of the context object when it was registered, the subsystem indexes extension points by (tag, context)
+	FObjectKey ContextKey;
+	// ExtensionPointTag followed by its parents, gathered once at registration
+	TArray<FGameplayTag> TagChain;
+	// Cleared when unregistered so pending batched notifications skip it
+	bool bRegistered = true;
+
 	// Tests if the extension and the extension point match up, if they do then this extension point should learn
 	// about this extension.
 	bool DoesExtensionPassContract(const FUIExtension* Extension) const;
+
+private:
+	// Whether each data class seen so far passes AllowedDataClasses, these never change after registration
+	mutable TMap<TObjectKey<UClass>, bool> DataClassCompatibility;
 };
 
 /**
@@ -207,6 +226,14 @@ public:
 
 	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
 
+	/**
+	 * Extension points registered and extensions added until the matching EndNotificationBatch are notified when the
+	 * outermost batch ends, grouped so each extension point handles all of its new extensions in one pass.
+	 * Removals are still notified immediately. Prefer FUIExtensionNotificationBatch over calling these directly.
+	 */
+	void BeginNotificationBatch();
+	void EndNotificationBatch();
+
 protected:
 	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
 	virtual void Deinitialize() override;
@@ -214,6 +241,9 @@ protected:
 	void NotifyExtensionPointOfExtensions(TSharedPtr<FUIExtensionPoint>& ExtensionPoint);
 	void NotifyExtensionPointsOfExtension(EUIExtensionAction Action, TSharedPtr<FUIExtension>& Extension);
 
+	// Sends the Added notifications deferred by the batch that just ended
+	void FlushPendingNotifications();
+
 	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category="UI Extension", meta = (DisplayName = "Register Extension Point"))
 	FUIExtensionPointHandle K2_RegisterExtensionPoint(FGameplayTag ExtensionPointTag, EUIExtensionPointMatch ExtensionPointTagMatchType, const TArray<UClass*>& AllowedDataClasses, FExtendExtensionPointDynamicDelegate ExtensionCallback);
 	
@@ -242,11 +272,44 @@ protected:
 	FUIExtensionRequest CreateExtensionRequest(const TSharedPtr<FUIExtension>& Extension);
 
 private:
+	// Extensions and extension points are indexed by their tag and context object, only entries with the same context can match
+	typedef TPair<FGameplayTag, FObjectKey> FExtensionKey;
+
 	typedef TArray<TSharedPtr<FUIExtensionPoint>> FExtensionPointList;
-	TMap<FGameplayTag, FExtensionPointList> ExtensionPointMap;
+	TMap<FExtensionKey, FExtensionPointList> ExtensionPointMap;
 
 	typedef TArray<TSharedPtr<FUIExtension>> FExtensionList;
-	TMap<FGameplayTag, FExtensionList> ExtensionMap;
+	TMap<FExtensionKey, FExtensionList> ExtensionMap;
+
+	// Registered while a notification batch is open, in registration order
+	FExtensionPointList PendingExtensionPoints;
+	FExtensionList PendingExtensions;
+
+	int32 NotificationBatchDepth = 0;
+};
+
+/** Batches the UI extension notifications of everything registered in its scope, see UUIExtensionSubsystem::BeginNotificationBatch */
+struct FUIExtensionNotificationBatch : public FNoncopyable
+{
+	explicit FUIExtensionNotificationBatch(UUIExtensionSubsystem* InExtensionSubsystem)
+		: ExtensionSubsystem(InExtensionSubsystem)
+	{
+		if (UUIExtensionSubsystem* ExtensionSubsystemPtr = ExtensionSubsystem.Get())
+		{
+			ExtensionSubsystemPtr->BeginNotificationBatch();
+		}
+	}
+
+	~FUIExtensionNotificationBatch()
+	{
+		if (UUIExtensionSubsystem* ExtensionSubsystemPtr = ExtensionSubsystem.Get())
+		{
+			ExtensionSubsystemPtr->EndNotificationBatch();
+		}
+	}
+
+private:
+	TWeakObjectPtr<UUIExtensionSubsystem> ExtensionSubsystem;
 };
 
 
@@ -0,0 +1,278 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "LyraDamageJournalCommandlet.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Weapons/LyraDamageJournalSubsystem.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(LyraDamageJournalCommandlet)
+
+DEFINE_LOG_CATEGORY_STATIC(LogLyraDamageJournal, Log, Log);
+
+namespace LyraDamageJournalCommandlet
+{
+	struct FWeaponStats
+	{
+		int64 Shots = 0;
+		int64 DamageEvents = 0;
+		int64 Kills = 0;
+		double TotalDamage = 0.0;
+		double TotalDistance = 0.0;
+
+		// Number of damage events per histogram bucket
+		TMap<int32, int32> DamageHistogram;
+
+		TArray<double> TimesToKill;
+	};
+
+	struct FJournalTotals
+	{
+		TMap<FString, FWeaponStats> Weapons;
+		int32 NumFiles = 0;
+		int64 NumRecords = 0;
+	};
+
+	static bool ReadJournal(const FString& Filename, float BucketSize, FJournalTotals& Totals)
+	{
+		TArray<uint8> FileData;
+		if (!FFileHelper::LoadFileToArray(FileData, *Filename))
+		{
+			UE_LOG(LogLyraDamageJournal, Error, TEXT("Failed to read %s"), *Filename);
+			return false;
+		}
+
+		FMemoryReader Reader(FileData);
+
+		uint32 Magic = 0;
+		uint32 Version = 0;
+		Reader << Magic;
+		Reader << Version;
+		if (Reader.IsError() || (Magic != LyraDamageJournal::FileMagic))
+		{
+			UE_LOG(LogLyraDamageJournal, Error, TEXT("%s is not a damage journal"), *Filename);
+			return false;
+		}
+		if (Version != LyraDamageJournal::FileVersion)
+		{
+			UE_LOG(LogLyraDamageJournal, Error, TEXT("%s has version %u, expected %u"), *Filename, Version, LyraDamageJournal::FileVersion);
+			return false;
+		}
+
+		// IDs are only unique within one file, so everything is keyed by ID here and converted to names when accumulating
+		TMap<uint32, FString> Names;
+
+		// Target -> (Source -> time of the first damage since the target last died)
+		TMap<uint32, TMap<uint32, double>> FirstDamageTimes;
+
+		auto GetName = [&Names](uint32 Id) -> const FString&
+		{
+			static const FString Unknown(TEXT("Unknown"));
+			const FString* Name = Names.Find(Id);
+			return (Name != nullptr) ? *Name : Unknown;
+		};
+
+		while (Reader.Tell() < Reader.TotalSize())
+		{
+			uint32 ChunkType = 0;
+			uint32 NumEntries = 0;
+			Reader << ChunkType;
+			Reader << NumEntries;
+			if (Reader.IsError())
+			{
+				break;
+			}
+
+			if (ChunkType == (uint32)LyraDamageJournal::EChunkType::Names)
+			{
+				for (uint32 Index = 0; (Index < NumEntries) && !Reader.IsError(); ++Index)
+				{
+					uint32 Id = 0;
+					FString Name;
+					Reader << Id;
+					Reader << Name;
+					Names.Add(Id, MoveTemp(Name));
+				}
+			}
+			else if (ChunkType == (uint32)LyraDamageJournal::EChunkType::Records)
+			{
+				const int64 NumBytes = (int64)NumEntries * sizeof(FLyraDamageJournalRecord);
+				if ((Reader.Tell() + NumBytes) > Reader.TotalSize())
+				{
+					// The server was probably shut down mid write, keep what we have
+					UE_LOG(LogLyraDamageJournal, Warning, TEXT("%s ends with a truncated chunk"), *Filename);
+					break;
+				}
+
+				TArray<FLyraDamageJournalRecord> Records;
+				Records.SetNumUninitialized(NumEntries);
+				Reader.Serialize(Records.GetData(), NumBytes);
+				Totals.NumRecords += NumEntries;
+
+				for (const FLyraDamageJournalRecord& Record : Records)
+				{
+					FWeaponStats& Stats = Totals.Weapons.FindOrAdd(GetName(Record.WeaponId));
+
+					if (Record.Type == ELyraDamageJournalRecordType::Shot)
+					{
+						++Stats.Shots;
+						continue;
+					}
+
+					++Stats.DamageEvents;
+					Stats.TotalDamage += Record.Amount;
+					Stats.TotalDistance += Record.Distance;
+					Stats.DamageHistogram.FindOrAdd(FMath::FloorToInt32(Record.Amount / BucketSize))++;
+
+					TMap<uint32, double>& TargetFirstDamage = FirstDamageTimes.FindOrAdd(Record.TargetId);
+					const double FirstDamageTime = TargetFirstDamage.FindOrAdd(Record.SourceId, Record.Timestamp);
+
+					if (Record.Type == ELyraDamageJournalRecordType::Kill)
+					{
+						++Stats.Kills;
+						Stats.TimesToKill.Add(Record.Timestamp - FirstDamageTime);
+
+						// The next life starts from a clean slate
+						TargetFirstDamage.Reset();
+					}
+				}
+			}
+			else
+			{
+				UE_LOG(LogLyraDamageJournal, Error, TEXT("%s has an unknown chunk type %u"), *Filename, ChunkType);
+				break;
+			}
+		}
+
+		if (Reader.IsError())
+		{
+			UE_LOG(LogLyraDamageJournal, Warning, TEXT("%s ended unexpectedly, results may be incomplete"), *Filename);
+		}
+
+		++Totals.NumFiles;
+		return true;
+	}
+
+	static double GetMedian(TArray<double>& Values)
+	{
+		if (Values.Num() == 0)
+		{
+			return 0.0;
+		}
+
+		Values.Sort();
+		const int32 Middle = Values.Num() / 2;
+		return ((Values.Num() % 2) == 0) ? ((Values[Middle - 1] + Values[Middle]) * 0.5) : Values[Middle];
+	}
+}
+
+ULyraDamageJournalCommandlet::ULyraDamageJournalCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+}
+
+int32 ULyraDamageJournalCommandlet::Main(const FString& FullCommandLine)
+{
+	using namespace LyraDamageJournalCommandlet;
+
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> Params;
+	ParseCommandLine(*FullCommandLine, Tokens, Switches, Params);
+
+	const FString DefaultDirectory = FPaths::ProjectSavedDir() / TEXT("DamageJournal");
+
+	FString JournalPath = DefaultDirectory;
+	if (const FString* JournalParam = Params.Find(TEXT("Journal")))
+	{
+		JournalPath = *JournalParam;
+	}
+
+	FString OutputFilename = DefaultDirectory / TEXT("Summary.csv");
+	if (const FString* OutputParam = Params.Find(TEXT("Output")))
+	{
+		OutputFilename = *OutputParam;
+	}
+
+	float BucketSize = 10.0f;
+	if (const FString* BucketSizeParam = Params.Find(TEXT("BucketSize")))
+	{
+		BucketSize = FMath::Max(FCString::Atof(**BucketSizeParam), 1.0f);
+	}
+
+	TArray<FString> JournalFiles;
+	if (IFileManager::Get().DirectoryExists(*JournalPath))
+	{
+		IFileManager::Get().FindFiles(JournalFiles, *(JournalPath / FString(TEXT("*")) + LyraDamageJournal::FileExtension), /*Files=*/ true, /*Directories=*/ false);
+		for (FString& JournalFile : JournalFiles)
+		{
+			JournalFile = JournalPath / JournalFile;
+		}
+		JournalFiles.Sort();
+	}
+	else if (IFileManager::Get().FileExists(*JournalPath))
+	{
+		JournalFiles.Add(JournalPath);
+	}
+
+	if (JournalFiles.Num() == 0)
+	{
+		UE_LOG(LogLyraDamageJournal, Error, TEXT("No damage journals found at %s"), *JournalPath);
+		return 1;
+	}
+
+	FJournalTotals Totals;
+	for (const FString& JournalFile : JournalFiles)
+	{
+		ReadJournal(JournalFile, BucketSize, Totals);
+	}
+
+	UE_LOG(LogLyraDamageJournal, Display, TEXT("Read %lld records from %d journal(s)"), Totals.NumRecords, Totals.NumFiles);
+
+	Totals.Weapons.KeySort(TLess<FString>());
+
+	FString Csv = TEXT("Weapon,Shots,DamageEvents,Accuracy,TotalDamage,AverageDamage,AverageDistance,Kills,MeanTTK,MedianTTK,DamageHistogram\n");
+	for (TPair<FString, FWeaponStats>& Pair : Totals.Weapons)
+	{
+		FWeaponStats& Stats = Pair.Value;
+
+		// Shots come from the firing ability and damage from the health set, so this also covers projectiles
+		const double Accuracy = (Stats.Shots > 0) ? ((double)Stats.DamageEvents / (double)Stats.Shots) : 0.0;
+		const double AverageDamage = (Stats.DamageEvents > 0) ? (Stats.TotalDamage / (double)Stats.DamageEvents) : 0.0;
+		const double AverageDistance = (Stats.DamageEvents > 0) ? (Stats.TotalDistance / (double)Stats.DamageEvents) : 0.0;
+
+		double MeanTTK = 0.0;
+		for (double TimeToKill : Stats.TimesToKill)
+		{
+			MeanTTK += TimeToKill;
+		}
+		MeanTTK = (Stats.TimesToKill.Num() > 0) ? (MeanTTK / Stats.TimesToKill.Num()) : 0.0;
+		const double MedianTTK = GetMedian(Stats.TimesToKill);
+
+		Stats.DamageHistogram.KeySort(TLess<int32>());
+		TArray<FString> HistogramEntries;
+		for (const TPair<int32, int32>& Bucket : Stats.DamageHistogram)
+		{
+			HistogramEntries.Add(FString::Printf(TEXT("%g-%g:%d"), Bucket.Key * BucketSize, (Bucket.Key + 1) * BucketSize, Bucket.Value));
+		}
+		const FString Histogram = FString::Join(HistogramEntries, TEXT(" "));
+
+		UE_LOG(LogLyraDamageJournal, Display, TEXT("%s: %lld shots, %lld hits (%.1f%%), %.1f damage (%.1f avg at %.0f cm), %lld kills, TTK mean %.2fs median %.2fs"),
+			*Pair.Key, Stats.Shots, Stats.DamageEvents, Accuracy * 100.0, Stats.TotalDamage, AverageDamage, AverageDistance, Stats.Kills, MeanTTK, MedianTTK);
+		UE_LOG(LogLyraDamageJournal, Display, TEXT("    Damage histogram: %s"), *Histogram);
+
+		Csv += FString::Printf(TEXT("%s,%lld,%lld,%.4f,%.2f,%.2f,%.1f,%lld,%.3f,%.3f,%s\n"),
+			*Pair.Key, Stats.Shots, Stats.DamageEvents, Accuracy, Stats.TotalDamage, AverageDamage, AverageDistance, Stats.Kills, MeanTTK, MedianTTK, *Histogram);
+	}
+
+	if (!FFileHelper::SaveStringToFile(Csv, *OutputFilename))
+	{
+		UE_LOG(LogLyraDamageJournal, Error, TEXT("Failed to write %s"), *OutputFilename);
+		return 1;
+	}
+
+	UE_LOG(LogLyraDamageJournal, Display, TEXT("Wrote summary to %s"), *OutputFilename);
+	return 0;
+}
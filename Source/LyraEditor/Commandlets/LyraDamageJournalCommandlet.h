@@ -0,0 +1,24 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+
+#include "LyraDamageJournalCommandlet.generated.h"
+
+/**
+ * Aggregates damage journals recorded by ULyraDamageJournalSubsystem into per weapon statistics
+ * (accuracy, damage histograms and time to kill)
+ *
+ * Usage: -run=LyraDamageJournal [-Journal=<file or directory>] [-Output=<csv file>] [-BucketSize=<damage per histogram bucket>]
+ */
+UCLASS()
+class ULyraDamageJournalCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+	// Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	// End UCommandlet Interface
+};
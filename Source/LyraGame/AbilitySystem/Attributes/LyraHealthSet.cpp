@@ -5,10 +5,12 @@
 #include "LyraGameplayTags.h"
 #include "Net/UnrealNetwork.h"
 #include "AbilitySystem/LyraAbilitySystemComponent.h"
+#include "AbilitySystem/LyraGameplayEffectContext.h"
 #include "Engine/World.h"
 #include "GameplayEffectExtension.h"
 #include "Messages/LyraVerbMessage.h"
 #include "GameFramework/GameplayMessageSubsystem.h"
+#include "Weapons/LyraDamageJournalSubsystem.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraHealthSet)
 
@@ -148,6 +150,30 @@ void ULyraHealthSet::PostGameplayEffectExecute(const FGameplayEffectModCallbackD
 		// Convert into -Health and then clamp
 		SetHealth(FMath::Clamp(GetHealth() - GetDamage(), MinimumHealth, GetMaxHealth()));
 		SetDamage(0.0f);
+
+		// Record the hit for offline weapon balancing
+		if (Data.EvaluatedData.Magnitude > 0.0f)
+		{
+			ULyraDamageJournalSubsystem* DamageJournal = ULyraDamageJournalSubsystem::Get(GetOwningActor());
+			if ((DamageJournal != nullptr) && DamageJournal->IsRecording())
+			{
+				const FLyraGameplayEffectContext* TypedContext = FLyraGameplayEffectContext::ExtractEffectContext(EffectContext);
+				const FHitResult* HitResult = EffectContext.GetHitResult();
+				const AActor* TargetActor = GetOwningAbilitySystemComponent()->GetAvatarActor_Direct();
+
+				float Distance = 0.0f;
+				if (EffectContext.HasOrigin() && (TargetActor != nullptr))
+				{
+					Distance = FVector::Dist(EffectContext.GetOrigin(), (HitResult != nullptr) ? FVector(HitResult->ImpactPoint) : TargetActor->GetActorLocation());
+				}
+
+				const bool bKilledTarget = (HealthBeforeAttributeChange > 0.0f) && (GetHealth() <= 0.0f);
+				DamageJournal->RecordDamage((Instigator != nullptr) ? Instigator : Causer, TargetActor,
+					(TypedContext != nullptr) ? TypedContext->GetAbilitySourceObject() : nullptr,
+					(HitResult != nullptr) ? HitResult->BoneName : NAME_None,
+					Data.EvaluatedData.Magnitude, Distance, bKilledTarget);
+			}
+		}
 	}
 	else if (Data.EvaluatedData.Attribute == GetHealingAttribute())
 	{
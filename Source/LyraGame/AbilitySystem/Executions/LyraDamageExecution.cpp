@@ -6,10 +6,64 @@
 #include "AbilitySystem/LyraGameplayEffectContext.h"
 #include "AbilitySystem/LyraAbilitySourceInterface.h"
 #include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
 #include "Teams/LyraTeamSubsystem.h"
+#include "UObject/ObjectKey.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraDamageExecution)
 
+DECLARE_STATS_GROUP(TEXT("LyraDamage"), STATGROUP_LyraDamage, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT(TEXT("Damage Execution"), STAT_LyraDamageExecution, STATGROUP_LyraDamage);
+DECLARE_CYCLE_STAT(TEXT("Capture Attributes"), STAT_LyraDamageExecution_Capture, STATGROUP_LyraDamage);
+DECLARE_CYCLE_STAT(TEXT("Team Check"), STAT_LyraDamageExecution_TeamCheck, STATGROUP_LyraDamage);
+DECLARE_CYCLE_STAT(TEXT("Attenuation"), STAT_LyraDamageExecution_Attenuation, STATGROUP_LyraDamage);
+DECLARE_CYCLE_STAT(TEXT("Output"), STAT_LyraDamageExecution_Output, STATGROUP_LyraDamage);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Team Checks Cached"), STAT_LyraDamageExecution_TeamCacheHits, STATGROUP_LyraDamage);
+
+namespace LyraDamageExecution
+{
+	static bool bCacheTeamRelationships = true;
+	static FAutoConsoleVariableRef CVarCacheTeamRelationships(
+		TEXT("Lyra.Damage.CacheTeamRelationships"),
+		bCacheTeamRelationships,
+		TEXT("If true, whether a causer can damage a target is only worked out once per frame for each (causer, target) pair."),
+		ECVF_Default);
+
+	// Results of CanCauseDamage for the current frame, shotguns and high rate of fire weapons hit the same pairs repeatedly
+	struct FTeamRelationshipCache
+	{
+		uint64 FrameNumber = 0;
+		TMap<TPair<FObjectKey, FObjectKey>, bool> CanDamageByPair;
+	};
+
+	static bool CanCauseDamage(const ULyraTeamSubsystem& TeamSubsystem, const AActor* EffectCauser, const AActor* HitActor)
+	{
+		if (!bCacheTeamRelationships || !IsInGameThread())
+		{
+			return TeamSubsystem.CanCauseDamage(EffectCauser, HitActor);
+		}
+
+		static FTeamRelationshipCache Cache;
+		if (Cache.FrameNumber != GFrameCounter)
+		{
+			Cache.FrameNumber = GFrameCounter;
+			Cache.CanDamageByPair.Reset();
+		}
+
+		const TPair<FObjectKey, FObjectKey> Pair(FObjectKey(EffectCauser), FObjectKey(HitActor));
+		if (const bool* bCachedResult = Cache.CanDamageByPair.Find(Pair))
+		{
+			INC_DWORD_STAT(STAT_LyraDamageExecution_TeamCacheHits);
+			return *bCachedResult;
+		}
+
+		const bool bCanCauseDamage = TeamSubsystem.CanCauseDamage(EffectCauser, HitActor);
+		Cache.CanDamageByPair.Add(Pair, bCanCauseDamage);
+		return bCanCauseDamage;
+	}
+}
+
 struct FDamageStatics
 {
 	FGameplayEffectAttributeCaptureDefinition BaseDamageDef;
@@ -35,6 +89,8 @@ ULyraDamageExecution::ULyraDamageExecution()
 void ULyraDamageExecution::Execute_Implementation(const FGameplayEffectCustomExecutionParameters& ExecutionParams, FGameplayEffectCustomExecutionOutput& OutExecutionOutput) const
 {
 #if WITH_SERVER_CODE
+	SCOPE_CYCLE_COUNTER(STAT_LyraDamageExecution);
+
 	const FGameplayEffectSpec& Spec = ExecutionParams.GetOwningSpec();
 	FLyraGameplayEffectContext* TypedContext = FLyraGameplayEffectContext::ExtractEffectContext(Spec.GetContext());
 	check(TypedContext);
@@ -47,7 +103,10 @@ void ULyraDamageExecution::Execute_Implementation(const FGameplayEffectCustomExe
 	EvaluateParameters.TargetTags = TargetTags;
 
 	float BaseDamage = 0.0f;
-	ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(DamageStatics().BaseDamageDef, EvaluateParameters, BaseDamage);
+	{
+		SCOPE_CYCLE_COUNTER(STAT_LyraDamageExecution_Capture);
+		ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(DamageStatics().BaseDamageDef, EvaluateParameters, BaseDamage);
+	}
 
 	const AActor* EffectCauser = TypedContext->GetEffectCauser();
 	const FHitResult* HitActorResult = TypedContext->GetHitResult();
@@ -89,10 +148,12 @@ void ULyraDamageExecution::Execute_Implementation(const FGameplayEffectCustomExe
 	float DamageInteractionAllowedMultiplier = 0.0f;
 	if (HitActor)
 	{
+		SCOPE_CYCLE_COUNTER(STAT_LyraDamageExecution_TeamCheck);
+
 		ULyraTeamSubsystem* TeamSubsystem = HitActor->GetWorld()->GetSubsystem<ULyraTeamSubsystem>();
 		if (ensure(TeamSubsystem))
 		{
-			DamageInteractionAllowedMultiplier = TeamSubsystem->CanCauseDamage(EffectCauser, HitActor) ? 1.0 : 0.0;
+			DamageInteractionAllowedMultiplier = LyraDamageExecution::CanCauseDamage(*TeamSubsystem, EffectCauser, HitActor) ? 1.0 : 0.0;
 		}
 	}
 
@@ -117,6 +178,8 @@ void ULyraDamageExecution::Execute_Implementation(const FGameplayEffectCustomExe
 	float DistanceAttenuation = 1.0f;
 	if (const ILyraAbilitySourceInterface* AbilitySource = TypedContext->GetAbilitySource())
 	{
+		SCOPE_CYCLE_COUNTER(STAT_LyraDamageExecution_Attenuation);
+
 		if (const UPhysicalMaterial* PhysMat = TypedContext->GetPhysicalMaterial())
 		{
 			PhysicalMaterialAttenuation = AbilitySource->GetPhysicalMaterialAttenuation(PhysMat, SourceTags, TargetTags);
@@ -126,6 +189,8 @@ void ULyraDamageExecution::Execute_Implementation(const FGameplayEffectCustomExe
 	}
 	DistanceAttenuation = FMath::Max(DistanceAttenuation, 0.0f);
 
+	SCOPE_CYCLE_COUNTER(STAT_LyraDamageExecution_Output);
+
 	// Inventory MOD
 	float BaseArmor = 0.0f;
 	BaseArmor = TargetAbilitySystemComponent->GetNumericAttribute(ULyraCombatSet::GetBaseArmorAttribute());
@@ -16,6 +16,21 @@
 
 UE_DEFINE_GAMEPLAY_TAG(TAG_Gameplay_AbilityInputBlocked, "Gameplay.AbilityInputBlocked");
 
+DECLARE_STATS_GROUP(TEXT("LyraAbilitySystem"), STATGROUP_LyraAbilitySystem, STATCAT_Advanced);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Target Data RPCs Sent"), STAT_LyraASC_TargetDataRPCsSent, STATGROUP_LyraAbilitySystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Target Data Sent In Activation Batch"), STAT_LyraASC_TargetDataBatched, STATGROUP_LyraAbilitySystem);
+
+namespace LyraAbilitySystemComponentCVars
+{
+	static bool bBatchServerRPCs = true;
+	static FAutoConsoleVariableRef CVarBatchServerRPCs(
+		TEXT("Lyra.AbilitySystem.BatchServerRPCs"),
+		bBatchServerRPCs,
+		TEXT("If true, ability activation, target data and end ability RPCs sent in the same frame are batched into one RPC."),
+		ECVF_Default);
+}
+
 ULyraAbilitySystemComponent::ULyraAbilitySystemComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
@@ -28,6 +43,8 @@ ULyraAbilitySystemComponent::ULyraAbilitySystemComponent(const FObjectInitialize
 
 void ULyraAbilitySystemComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
+	FlushPendingServerTargetData();
+
 	if (ULyraGlobalAbilitySystem* GlobalAbilitySystem = UWorld::GetSubsystem<ULyraGlobalAbilitySystem>(GetWorld()))
 	{
 		GlobalAbilitySystem->UnregisterASC(this);
@@ -184,12 +201,12 @@ void ULyraAbilitySystemComponent::AbilityInputTagPressed(const FGameplayTag& Inp
 {
 	if (InputTag.IsValid())
 	{
-		for (const FGameplayAbilitySpec& AbilitySpec : ActivatableAbilities.Items)
+		if (const TArray<FGameplayAbilitySpecHandle>* SpecHandles = InputTagToSpecHandles.Find(InputTag))
 		{
-			if (AbilitySpec.Ability && (AbilitySpec.DynamicAbilityTags.HasTagExact(InputTag)))
+			for (const FGameplayAbilitySpecHandle& SpecHandle : *SpecHandles)
 			{
-				InputPressedSpecHandles.AddUnique(AbilitySpec.Handle);
-				InputHeldSpecHandles.AddUnique(AbilitySpec.Handle);
+				InputPressedSpecHandles.AddUnique(SpecHandle);
+				InputHeldSpecHandles.AddUnique(SpecHandle);
 			}
 		}
 	}
@@ -199,12 +216,12 @@ void ULyraAbilitySystemComponent::AbilityInputTagReleased(const FGameplayTag& In
 {
 	if (InputTag.IsValid())
 	{
-		for (const FGameplayAbilitySpec& AbilitySpec : ActivatableAbilities.Items)
+		if (const TArray<FGameplayAbilitySpecHandle>* SpecHandles = InputTagToSpecHandles.Find(InputTag))
 		{
-			if (AbilitySpec.Ability && (AbilitySpec.DynamicAbilityTags.HasTagExact(InputTag)))
+			for (const FGameplayAbilitySpecHandle& SpecHandle : *SpecHandles)
 			{
-				InputReleasedSpecHandles.AddUnique(AbilitySpec.Handle);
-				InputHeldSpecHandles.Remove(AbilitySpec.Handle);
+				InputReleasedSpecHandles.AddUnique(SpecHandle);
+				InputHeldSpecHandles.Remove(SpecHandle);
 			}
 		}
 	}
@@ -218,26 +235,19 @@ void ULyraAbilitySystemComponent::ProcessAbilityInput(float DeltaTime, bool bGam
 		return;
 	}
 
-	static TArray<FGameplayAbilitySpecHandle> AbilitiesToActivate;
 	AbilitiesToActivate.Reset();
 
-	//@TODO: See if we can use FScopedServerAbilityRPCBatcher ScopedRPCBatcher in some of these loops
-
 	//
 	// Process all abilities that activate when the input is held.
 	//
 	for (const FGameplayAbilitySpecHandle& SpecHandle : InputHeldSpecHandles)
 	{
-		if (const FGameplayAbilitySpec* AbilitySpec = FindAbilitySpecFromHandle(SpecHandle))
+		const FLyraAbilitySpecIndexEntry* IndexEntry = nullptr;
+		if (const FGameplayAbilitySpec* AbilitySpec = FindIndexedAbilitySpec(SpecHandle, &IndexEntry))
 		{
-			if (AbilitySpec->Ability && !AbilitySpec->IsActive())
+			if (!AbilitySpec->IsActive() && IndexEntry->bHasActivationPolicy && (IndexEntry->ActivationPolicy == ELyraAbilityActivationPolicy::WhileInputActive))
 			{
-				const ULyraGameplayAbility* LyraAbilityCDO = CastChecked<ULyraGameplayAbility>(AbilitySpec->Ability);
-
-				if (LyraAbilityCDO->GetActivationPolicy() == ELyraAbilityActivationPolicy::WhileInputActive)
-				{
-					AbilitiesToActivate.AddUnique(AbilitySpec->Handle);
-				}
+				AbilitiesToActivate.Add(SpecHandle);
 			}
 		}
 	}
@@ -247,26 +257,20 @@ void ULyraAbilitySystemComponent::ProcessAbilityInput(float DeltaTime, bool bGam
 	//
 	for (const FGameplayAbilitySpecHandle& SpecHandle : InputPressedSpecHandles)
 	{
-		if (FGameplayAbilitySpec* AbilitySpec = FindAbilitySpecFromHandle(SpecHandle))
+		const FLyraAbilitySpecIndexEntry* IndexEntry = nullptr;
+		if (FGameplayAbilitySpec* AbilitySpec = FindIndexedAbilitySpec(SpecHandle, &IndexEntry))
 		{
-			if (AbilitySpec->Ability)
-			{
-				AbilitySpec->InputPressed = true;
+			AbilitySpec->InputPressed = true;
 
-				if (AbilitySpec->IsActive())
-				{
-					// Ability is active so pass along the input event.
-					AbilitySpecInputPressed(*AbilitySpec);
-				}
-				else
-				{
-					const ULyraGameplayAbility* LyraAbilityCDO = CastChecked<ULyraGameplayAbility>(AbilitySpec->Ability);
-
-					if (LyraAbilityCDO->GetActivationPolicy() == ELyraAbilityActivationPolicy::OnInputTriggered)
-					{
-						AbilitiesToActivate.AddUnique(AbilitySpec->Handle);
-					}
-				}
+			if (AbilitySpec->IsActive())
+			{
+				// Ability is active so pass along the input event.
+				AbilitySpecInputPressed(*AbilitySpec);
+			}
+			else if (IndexEntry->bHasActivationPolicy && (IndexEntry->ActivationPolicy == ELyraAbilityActivationPolicy::OnInputTriggered))
+			{
+				// No uniqueness check needed, held handles only add WhileInputActive abilities and pressed handles are already unique.
+				AbilitiesToActivate.Add(SpecHandle);
 			}
 		}
 	}
@@ -278,6 +282,8 @@ void ULyraAbilitySystemComponent::ProcessAbilityInput(float DeltaTime, bool bGam
 	//
 	for (const FGameplayAbilitySpecHandle& AbilitySpecHandle : AbilitiesToActivate)
 	{
+		// Abilities that fire, send target data and end in the same frame (e.g. instant hit weapons) only send one RPC to the server.
+		FScopedServerAbilityRPCBatcher ScopedRPCBatcher(this, AbilitySpecHandle);
 		TryActivateAbility(AbilitySpecHandle);
 	}
 
@@ -286,17 +292,14 @@ void ULyraAbilitySystemComponent::ProcessAbilityInput(float DeltaTime, bool bGam
 	//
 	for (const FGameplayAbilitySpecHandle& SpecHandle : InputReleasedSpecHandles)
 	{
-		if (FGameplayAbilitySpec* AbilitySpec = FindAbilitySpecFromHandle(SpecHandle))
+		if (FGameplayAbilitySpec* AbilitySpec = FindIndexedAbilitySpec(SpecHandle))
 		{
-			if (AbilitySpec->Ability)
-			{
-				AbilitySpec->InputPressed = false;
+			AbilitySpec->InputPressed = false;
 
-				if (AbilitySpec->IsActive())
-				{
-					// Ability is active so pass along the input event.
-					AbilitySpecInputReleased(*AbilitySpec);
-				}
+			if (AbilitySpec->IsActive())
+			{
+				// Ability is active so pass along the input event.
+				AbilitySpecInputReleased(*AbilitySpec);
 			}
 		}
 	}
@@ -315,6 +318,197 @@ void ULyraAbilitySystemComponent::ClearAbilityInput()
 	InputHeldSpecHandles.Reset();
 }
 
+bool ULyraAbilitySystemComponent::ShouldDoServerAbilityRPCBatch() const
+{
+	return LyraAbilitySystemComponentCVars::bBatchServerRPCs;
+}
+
+void ULyraAbilitySystemComponent::EndServerAbilityRPCBatch(FGameplayAbilitySpecHandle AbilityHandle)
+{
+	// Queued target data has to reach the server after the activation but before the ability ends,
+	// otherwise the server ends the ability first and drops the data. Hold the end back until it has been sent.
+	FServerAbilityRPCBatch* ActivationBatch = LocalServerAbilityRPCBatchData.FindByKey(AbilityHandle);
+	const bool bHasPendingData = PendingServerTargetData.ContainsByPredicate([AbilityHandle](const FLyraPendingServerTargetData& PendingData) { return PendingData.AbilityHandle == AbilityHandle; });
+	const bool bDeferEnd = (ActivationBatch != nullptr) && ActivationBatch->Ended && bHasPendingData;
+
+	FPredictionKey BatchPredictionKey;
+	if (bDeferEnd)
+	{
+		BatchPredictionKey = ActivationBatch->PredictionKey;
+		ActivationBatch->Ended = false;
+	}
+
+	Super::EndServerAbilityRPCBatch(AbilityHandle);
+
+	FlushPendingServerTargetData(AbilityHandle);
+
+	if (bDeferEnd)
+	{
+		// Matches the activation info the server builds when it ends an ability from a batch
+		FGameplayAbilityActivationInfo ActivationInfo;
+		ActivationInfo.ServerSetActivationPredictionKey(BatchPredictionKey);
+		ServerEndAbility(AbilityHandle, ActivationInfo, BatchPredictionKey);
+	}
+}
+
+void ULyraAbilitySystemComponent::CallServerSetReplicatedTargetDataBatched(FGameplayAbilitySpecHandle AbilityHandle, FPredictionKey AbilityOriginalPredictionKey, const FGameplayAbilityTargetDataHandle& TargetData, FGameplayTag ApplicationTag, FPredictionKey CurrentPredictionKey)
+{
+	const FServerAbilityRPCBatch* ActivationBatch = ShouldDoServerAbilityRPCBatch() ? LocalServerAbilityRPCBatchData.FindByKey(AbilityHandle) : nullptr;
+	if ((ActivationBatch == nullptr) || !ActivationBatch->Started)
+	{
+		INC_DWORD_STAT(STAT_LyraASC_TargetDataRPCsSent);
+		CallServerSetReplicatedTargetData(AbilityHandle, AbilityOriginalPredictionKey, TargetData, ApplicationTag, CurrentPredictionKey);
+		return;
+	}
+
+	// The batch RPC carries one target data per activation and doesn't carry the application tag.
+	// Each call is still sent on its own, so the server commits once per call just like the client.
+	if ((ActivationBatch->TargetData.Num() == 0) && !ApplicationTag.IsValid())
+	{
+		INC_DWORD_STAT(STAT_LyraASC_TargetDataBatched);
+		CallServerSetReplicatedTargetData(AbilityHandle, AbilityOriginalPredictionKey, TargetData, ApplicationTag, CurrentPredictionKey);
+		return;
+	}
+
+	// Anything else waits for the batch to be sent, so the server doesn't get the data before the activation.
+	FLyraPendingServerTargetData& PendingData = PendingServerTargetData.AddDefaulted_GetRef();
+	PendingData.AbilityHandle = AbilityHandle;
+	PendingData.AbilityOriginalPredictionKey = AbilityOriginalPredictionKey;
+	PendingData.ApplicationTag = ApplicationTag;
+	PendingData.CurrentPredictionKey = CurrentPredictionKey;
+	PendingData.TargetData = TargetData;
+}
+
+void ULyraAbilitySystemComponent::FlushPendingServerTargetData(FGameplayAbilitySpecHandle AbilityHandle)
+{
+	if (PendingServerTargetData.IsEmpty())
+	{
+		return;
+	}
+
+	// Move the data out first since sending can end abilities, which can flush again.
+	TArray<FLyraPendingServerTargetData> DataToSend;
+
+	if (AbilityHandle.IsValid())
+	{
+		for (int32 Index = 0; Index < PendingServerTargetData.Num(); )
+		{
+			if (PendingServerTargetData[Index].AbilityHandle == AbilityHandle)
+			{
+				DataToSend.Add(MoveTemp(PendingServerTargetData[Index]));
+				PendingServerTargetData.RemoveAt(Index);
+			}
+			else
+			{
+				++Index;
+			}
+		}
+	}
+	else
+	{
+		DataToSend = MoveTemp(PendingServerTargetData);
+		PendingServerTargetData.Reset();
+	}
+
+	for (const FLyraPendingServerTargetData& PendingData : DataToSend)
+	{
+		INC_DWORD_STAT(STAT_LyraASC_TargetDataRPCsSent);
+		CallServerSetReplicatedTargetData(PendingData.AbilityHandle, PendingData.AbilityOriginalPredictionKey, PendingData.TargetData, PendingData.ApplicationTag, PendingData.CurrentPredictionKey);
+	}
+}
+
+void ULyraAbilitySystemComponent::OnGiveAbility(FGameplayAbilitySpec& AbilitySpec)
+{
+	Super::OnGiveAbility(AbilitySpec);
+
+	if (!AbilitySpec.Ability)
+	{
+		return;
+	}
+
+	// Plain UGameplayAbility grants are allowed, they're still indexed so their input events get forwarded
+	const ULyraGameplayAbility* LyraAbilityCDO = Cast<ULyraGameplayAbility>(AbilitySpec.Ability);
+
+	FLyraAbilitySpecIndexEntry& IndexEntry = AbilitySpecIndex.FindOrAdd(AbilitySpec.Handle);
+	IndexEntry.bHasActivationPolicy = (LyraAbilityCDO != nullptr);
+	IndexEntry.ActivationPolicy = LyraAbilityCDO ? LyraAbilityCDO->GetActivationPolicy() : ELyraAbilityActivationPolicy::OnInputTriggered;
+
+	// The spec passed in normally lives in ActivatableAbilities, so we can usually get its index without searching.
+	const TArray<FGameplayAbilitySpec>& Items = ActivatableAbilities.Items;
+	const int32 SpecIndex = (int32)(&AbilitySpec - Items.GetData());
+	IndexEntry.SpecIndex = Items.IsValidIndex(SpecIndex) ? SpecIndex : INDEX_NONE;
+
+	for (const FGameplayTag& Tag : IndexEntry.IndexedTags)
+	{
+		if (TArray<FGameplayAbilitySpecHandle>* SpecHandles = InputTagToSpecHandles.Find(Tag))
+		{
+			SpecHandles->Remove(AbilitySpec.Handle);
+		}
+	}
+
+	IndexEntry.IndexedTags = AbilitySpec.DynamicAbilityTags;
+
+	for (const FGameplayTag& Tag : IndexEntry.IndexedTags)
+	{
+		InputTagToSpecHandles.FindOrAdd(Tag).AddUnique(AbilitySpec.Handle);
+	}
+}
+
+void ULyraAbilitySystemComponent::OnRemoveAbility(FGameplayAbilitySpec& AbilitySpec)
+{
+	FLyraAbilitySpecIndexEntry IndexEntry;
+	if (AbilitySpecIndex.RemoveAndCopyValue(AbilitySpec.Handle, IndexEntry))
+	{
+		for (const FGameplayTag& Tag : IndexEntry.IndexedTags)
+		{
+			if (TArray<FGameplayAbilitySpecHandle>* SpecHandles = InputTagToSpecHandles.Find(Tag))
+			{
+				SpecHandles->Remove(AbilitySpec.Handle);
+				if (SpecHandles->IsEmpty())
+				{
+					InputTagToSpecHandles.Remove(Tag);
+				}
+			}
+		}
+	}
+
+	Super::OnRemoveAbility(AbilitySpec);
+}
+
+FGameplayAbilitySpec* ULyraAbilitySystemComponent::FindIndexedAbilitySpec(FGameplayAbilitySpecHandle Handle, const FLyraAbilitySpecIndexEntry** OutEntry)
+{
+	FLyraAbilitySpecIndexEntry* IndexEntry = AbilitySpecIndex.Find(Handle);
+	if (!IndexEntry)
+	{
+		return nullptr;
+	}
+
+	TArray<FGameplayAbilitySpec>& Items = ActivatableAbilities.Items;
+
+	if (!Items.IsValidIndex(IndexEntry->SpecIndex) || (Items[IndexEntry->SpecIndex].Handle != Handle))
+	{
+		// The spec moved because another ability was removed or the list was replicated in a different order.
+		IndexEntry->SpecIndex = Items.IndexOfByPredicate([Handle](const FGameplayAbilitySpec& Spec) { return Spec.Handle == Handle; });
+		if (IndexEntry->SpecIndex == INDEX_NONE)
+		{
+			return nullptr;
+		}
+	}
+
+	FGameplayAbilitySpec& AbilitySpec = Items[IndexEntry->SpecIndex];
+	if (!AbilitySpec.Ability)
+	{
+		return nullptr;
+	}
+
+	if (OutEntry)
+	{
+		*OutEntry = IndexEntry;
+	}
+
+	return &AbilitySpec;
+}
+
 void ULyraAbilitySystemComponent::NotifyAbilityActivated(const FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability)
 {
 	Super::NotifyAbilityActivated(Handle, Ability);
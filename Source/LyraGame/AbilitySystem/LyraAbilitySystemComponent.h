@@ -17,6 +17,40 @@ struct FGameplayAbilityTargetDataHandle;
 
 LYRAGAME_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_Gameplay_AbilityInputBlocked);
 
+/**
+ * FLyraAbilitySpecIndexEntry
+ *
+ *	Cached data for a granted ability spec, built when the ability is given so input processing doesn't need to scan or cast.
+ */
+struct FLyraAbilitySpecIndexEntry
+{
+	// Last known index of the spec in ActivatableAbilities.Items.  Validated against the handle on every lookup.
+	int32 SpecIndex = INDEX_NONE;
+
+	// Activation policy of the ability CDO, only meaningful if bHasActivationPolicy is set.
+	ELyraAbilityActivationPolicy ActivationPolicy = ELyraAbilityActivationPolicy::OnInputTriggered;
+
+	// False for abilities that aren't ULyraGameplayAbility, input processing never activates those (it still forwards input events while they're active).
+	bool bHasActivationPolicy = false;
+
+	// Dynamic tags the spec was indexed under in InputTagToSpecHandles.
+	FGameplayTagContainer IndexedTags;
+};
+
+/**
+ * FLyraPendingServerTargetData
+ *
+ *	Target data waiting for an open ability RPC batch to be sent before it can be sent to the server.
+ */
+struct FLyraPendingServerTargetData
+{
+	FGameplayAbilitySpecHandle AbilityHandle;
+	FPredictionKey AbilityOriginalPredictionKey;
+	FGameplayTag ApplicationTag;
+	FPredictionKey CurrentPredictionKey;
+	FGameplayAbilityTargetDataHandle TargetData;
+};
+
 /**
  * ULyraAbilitySystemComponent
  *
@@ -59,6 +93,18 @@ public:
 	// Removes all active instances of the gameplay effect that was used to add the specified dynamic granted tag.
 	void RemoveDynamicTagGameplayEffect(const FGameplayTag& Tag);
 
+	/**
+	 * Sends target data to the server, riding along with the ability's RPC batch when one is open.
+	 * Data with an application tag, or more than one target data for the same batch, is sent on its own right after the batch
+	 * and before the ability's end, which is split out of the batch when needed.
+	 * Target data is never merged, the server commits once per call just like the client.
+	 */
+	void CallServerSetReplicatedTargetDataBatched(FGameplayAbilitySpecHandle AbilityHandle, FPredictionKey AbilityOriginalPredictionKey, const FGameplayAbilityTargetDataHandle& TargetData, FGameplayTag ApplicationTag, FPredictionKey CurrentPredictionKey);
+
+	//~UAbilitySystemComponent interface
+	virtual void EndServerAbilityRPCBatch(FGameplayAbilitySpecHandle AbilityHandle) override;
+	//~End of UAbilitySystemComponent interface
+
 	/** Gets the ability target data associated with the given ability handle and activation info */
 	void GetAbilityTargetData(const FGameplayAbilitySpecHandle AbilityHandle, FGameplayAbilityActivationInfo ActivationInfo, FGameplayAbilityTargetDataHandle& OutTargetDataHandle);
 
@@ -86,6 +132,18 @@ protected:
 	void ClientNotifyAbilityFailed(const UGameplayAbility* Ability, const FGameplayTagContainer& FailureReason);
 
 	void HandleAbilityFailed(const UGameplayAbility* Ability, const FGameplayTagContainer& FailureReason);
+
+	virtual bool ShouldDoServerAbilityRPCBatch() const override;
+
+	// Sends target data queued by CallServerSetReplicatedTargetDataBatched.  If AbilityHandle is valid only that ability's data is sent.
+	void FlushPendingServerTargetData(FGameplayAbilitySpecHandle AbilityHandle = FGameplayAbilitySpecHandle());
+
+	virtual void OnGiveAbility(FGameplayAbilitySpec& AbilitySpec) override;
+	virtual void OnRemoveAbility(FGameplayAbilitySpec& AbilitySpec) override;
+
+	// Finds the spec for the handle using the ability spec index.  Returns null if the handle isn't granted.
+	FGameplayAbilitySpec* FindIndexedAbilitySpec(FGameplayAbilitySpecHandle Handle, const FLyraAbilitySpecIndexEntry** OutEntry = nullptr);
+
 protected:
 
 	// If set, this table is used to look up tag relationships for activate and cancel
@@ -101,6 +159,18 @@ protected:
 	// Handles to abilities that have their input held.
 	TArray<FGameplayAbilitySpecHandle> InputHeldSpecHandles;
 
+	// Cached data for every granted ability, maintained in OnGiveAbility and OnRemoveAbility.
+	TMap<FGameplayAbilitySpecHandle, FLyraAbilitySpecIndexEntry> AbilitySpecIndex;
+
+	// Handles of granted abilities keyed by each of their dynamic ability tags (which is where input tags live).
+	TMap<FGameplayTag, TArray<FGameplayAbilitySpecHandle>> InputTagToSpecHandles;
+
+	// Handles of abilities to try to activate this frame.  Kept as a member to avoid reallocating every frame.
+	TArray<FGameplayAbilitySpecHandle> AbilitiesToActivate;
+
+	// Target data waiting for an open ability RPC batch to be sent.
+	TArray<FLyraPendingServerTargetData> PendingServerTargetData;
+
 	// Number of abilities running in each activation group.
 	int32 ActivationGroupCounts[(uint8)ELyraAbilityActivationGroup::MAX];
 };
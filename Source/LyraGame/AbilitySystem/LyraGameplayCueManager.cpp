@@ -4,10 +4,18 @@
 #include "Engine/AssetManager.h"
 #include "LyraLogChannels.h"
 #include "GameplayCueSet.h"
+#include "GameplayEffect.h"
 #include "AbilitySystemGlobals.h"
 #include "GameplayTagsManager.h"
+#include "UObject/UObjectHash.h"
 #include "UObject/UObjectThreadContext.h"
 #include "Async/Async.h"
+#include "AbilitySystem/LyraAbilitySet.h"
+#include "Character/LyraPawnData.h"
+#include "Equipment/LyraEquipmentDefinition.h"
+#include "GameFeatures/GameFeatureAction_AddAbilities.h"
+#include "GameModes/LyraExperienceActionSet.h"
+#include "GameModes/LyraExperienceDefinition.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraGameplayCueManager)
 
@@ -34,6 +42,18 @@ namespace LyraGameplayCueManagerCvars
 		TEXT("Shows all assets that were loaded via LyraGameplayCueManager and are currently in memory."),
 		FConsoleCommandWithArgsDelegate::CreateStatic(ULyraGameplayCueManager::DumpGameplayCues));
 
+	static FAutoConsoleCommand CVarDumpCuePreloadStats(
+		TEXT("Lyra.DumpGameplayCuePreloadStats"),
+		TEXT("Shows the experience cue preload plan progress and the cues that were not loaded when they were fired."),
+		FConsoleCommandWithArgsDelegate::CreateStatic(ULyraGameplayCueManager::DumpCuePreloadStats));
+
+	static bool bPreloadExperienceCues = true;
+	static FAutoConsoleVariableRef CVarPreloadExperienceCues(
+		TEXT("Lyra.PreloadExperienceGameplayCues"),
+		bPreloadExperienceCues,
+		TEXT("If true, the cues referenced by an experience's abilities, effects and equipment are streamed in while the experience loads."),
+		ECVF_Default);
+
 	static ELyraEditorLoadMode LoadMode = ELyraEditorLoadMode::LoadUpfront;
 }
 
@@ -177,6 +197,351 @@ void ULyraGameplayCueManager::DumpGameplayCues(const TArray<FString>& Args)
 	UE_LOG(LogLyra, Log, TEXT("  ... %d cues in total"), GCM->AlwaysLoadedCues.Num() + GCM->PreloadedCues.Num() + NumMissingCuesLoaded);
 }
 
+void ULyraGameplayCueManager::DumpCuePreloadStats(const TArray<FString>& Args)
+{
+	ULyraGameplayCueManager* GCM = Get();
+	if (!GCM)
+	{
+		UE_LOG(LogLyra, Error, TEXT("DumpCuePreloadStats failed. No ULyraGameplayCueManager found."));
+		return;
+	}
+
+	UE_LOG(LogLyra, Log, TEXT("=========== Experience Gameplay Cue Preload ==========="));
+	UE_LOG(LogLyra, Log, TEXT("  Experience: %s (generation %d)"), *GCM->CuePreloadExperienceId.ToString(), GCM->CuePreloadGeneration);
+	UE_LOG(LogLyra, Log, TEXT("  ... %d / %d cues loaded (%d critical pending)"), GCM->NumCuePreloadsCompleted, GCM->NumCuePreloadsRequested, GCM->NumCriticalCuePreloadsPending);
+
+	UE_LOG(LogLyra, Log, TEXT("=========== Gameplay Cues fired before they were loaded ==========="));
+	TArray<TPair<FGameplayTag, int32>> SortedCounts = GCM->FireTimeLoadCounts.Array();
+	SortedCounts.Sort([](const TPair<FGameplayTag, int32>& A, const TPair<FGameplayTag, int32>& B) { return A.Value > B.Value; });
+	for (const TPair<FGameplayTag, int32>& Pair : SortedCounts)
+	{
+		UE_LOG(LogLyra, Log, TEXT("  %s (%d times)"), *Pair.Key.ToString(), Pair.Value);
+	}
+	UE_LOG(LogLyra, Log, TEXT("  ... %d cues in total"), SortedCounts.Num());
+}
+
+bool ULyraGameplayCueManager::IsPreloadingCues() const
+{
+	switch (LyraGameplayCueManagerCvars::LoadMode)
+	{
+	case ELyraEditorLoadMode::LoadUpfront:
+		return false;
+	case ELyraEditorLoadMode::PreloadAsCuesAreReferenced_GameOnly:
+#if WITH_EDITOR
+		if (GIsEditor)
+		{
+			return false;
+		}
+#endif
+		break;
+	case ELyraEditorLoadMode::PreloadAsCuesAreReferenced:
+		break;
+	}
+
+	return ShouldDelayLoadGameplayCues();
+}
+
+void ULyraGameplayCueManager::PreloadCuesForExperience(const ULyraExperienceDefinition* Experience)
+{
+	check(Experience);
+
+	// Start a new generation, anything still loading for the previous plan is ignored when it completes
+	++CuePreloadGeneration;
+	NumCriticalCuePreloadsPending = 0;
+	NumCuePreloadsRequested = 0;
+	NumCuePreloadsCompleted = 0;
+
+	if (const ULyraExperienceDefinition* PreviousExperience = CuePreloadExperience.Get())
+	{
+		if (PreviousExperience != Experience)
+		{
+			RemovePreloadReferencer(PreviousExperience);
+		}
+	}
+
+	CuePreloadExperience = Experience;
+	CuePreloadExperienceId = Experience->GetPrimaryAssetId();
+
+	if (!LyraGameplayCueManagerCvars::bPreloadExperienceCues || !IsPreloadingCues() || !RuntimeGameplayCueObjectLibrary.CueSet)
+	{
+		return;
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(ULyraGameplayCueManager::PreloadCuesForExperience);
+
+	CuePreloadStartTime = FPlatformTime::Seconds();
+
+	// Critical: cues from abilities and effects the experience grants directly, these are expected to fire as soon as play starts
+	FGameplayTagContainer CriticalCueTags;
+
+	auto GatherCueTagsFromActions = [this, &CriticalCueTags](const TArray<TObjectPtr<UGameFeatureAction>>& ActionList)
+	{
+		for (const UGameFeatureAction* Action : ActionList)
+		{
+			if (const UGameFeatureAction_AddAbilities* AddAbilitiesAction = Cast<const UGameFeatureAction_AddAbilities>(Action))
+			{
+				for (const FGameFeatureAbilitiesEntry& Entry : AddAbilitiesAction->AbilitiesList)
+				{
+					for (const FLyraAbilityGrant& Grant : Entry.GrantedAbilities)
+					{
+						GatherCueTagsFromClass(Grant.AbilityType.Get(), CriticalCueTags);
+					}
+
+					for (const TSoftObjectPtr<const ULyraAbilitySet>& AbilitySet : Entry.GrantedAbilitySets)
+					{
+						GatherCueTagsFromAbilitySet(AbilitySet.Get(), CriticalCueTags);
+					}
+				}
+			}
+		}
+	};
+
+	GatherCueTagsFromActions(Experience->Actions);
+	for (const TObjectPtr<ULyraExperienceActionSet>& ActionSet : Experience->ActionSets)
+	{
+		if (ActionSet != nullptr)
+		{
+			GatherCueTagsFromActions(ActionSet->Actions);
+		}
+	}
+
+	if (const ULyraPawnData* PawnData = Experience->DefaultPawnData)
+	{
+		for (const ULyraAbilitySet* AbilitySet : PawnData->AbilitySets)
+		{
+			GatherCueTagsFromAbilitySet(AbilitySet, CriticalCueTags);
+		}
+	}
+
+	// Normal: cues from equipment that is loaded, and cues that were fired before they were loaded in earlier runs of this experience
+	FGameplayTagContainer NormalCueTags;
+
+	TArray<UClass*> EquipmentClasses;
+	GetDerivedClasses(ULyraEquipmentDefinition::StaticClass(), EquipmentClasses);
+	for (UClass* EquipmentClass : EquipmentClasses)
+	{
+		if (EquipmentClass->HasAnyClassFlags(CLASS_Abstract | CLASS_Deprecated | CLASS_NewerVersionExists))
+		{
+			continue;
+		}
+
+		for (const ULyraAbilitySet* AbilitySet : EquipmentClass->GetDefaultObject<ULyraEquipmentDefinition>()->AbilitySetsToGrant)
+		{
+			GatherCueTagsFromAbilitySet(AbilitySet, NormalCueTags);
+		}
+	}
+
+	if (const TSet<FGameplayTag>* FireTimeLoadedCues = FireTimeLoadedCuesByExperience.Find(CuePreloadExperienceId))
+	{
+		for (const FGameplayTag& Tag : *FireTimeLoadedCues)
+		{
+			NormalCueTags.AddTag(Tag);
+		}
+	}
+
+	for (const FGameplayTag& Tag : CriticalCueTags)
+	{
+		RequestExperienceCuePreload(Tag, /*bCritical=*/ true);
+	}
+
+	for (const FGameplayTag& Tag : NormalCueTags)
+	{
+		if (!CriticalCueTags.HasTagExact(Tag))
+		{
+			RequestExperienceCuePreload(Tag, /*bCritical=*/ false);
+		}
+	}
+
+	UE_LOG(LogLyra, Log, TEXT("ULyraGameplayCueManager: Preloading %d cues (%d critical) for experience %s"), NumCuePreloadsRequested, NumCriticalCuePreloadsPending, *CuePreloadExperienceId.ToString());
+}
+
+void ULyraGameplayCueManager::GatherCueTagsFromAbilitySet(const ULyraAbilitySet* AbilitySet, FGameplayTagContainer& OutCueTags) const
+{
+	if (AbilitySet == nullptr)
+	{
+		return;
+	}
+
+	for (const FLyraAbilitySet_GameplayAbility& AbilityToGrant : AbilitySet->GetGrantedGameplayAbilities())
+	{
+		GatherCueTagsFromClass(AbilityToGrant.Ability, OutCueTags);
+	}
+
+	for (const FLyraAbilitySet_GameplayEffect& EffectToGrant : AbilitySet->GetGrantedGameplayEffects())
+	{
+		GatherCueTagsFromClass(EffectToGrant.GameplayEffect, OutCueTags);
+	}
+}
+
+void ULyraGameplayCueManager::GatherCueTagsFromClass(const UClass* Class, FGameplayTagContainer& OutCueTags) const
+{
+	if (Class == nullptr)
+	{
+		return;
+	}
+
+	const UObject* CDO = Class->GetDefaultObject();
+	const TMap<FGameplayTag, int32>& CueDataMap = RuntimeGameplayCueObjectLibrary.CueSet->GameplayCueDataMap;
+
+	if (const UGameplayEffect* EffectCDO = Cast<const UGameplayEffect>(CDO))
+	{
+		for (const FGameplayEffectCue& Cue : EffectCDO->GameplayCues)
+		{
+			OutCueTags.AppendTags(Cue.GameplayCueTags);
+		}
+		return;
+	}
+
+	if (const UGameplayAbility* AbilityCDO = Cast<const UGameplayAbility>(CDO))
+	{
+		if (const UGameplayEffect* CostEffect = AbilityCDO->GetCostGameplayEffect())
+		{
+			GatherCueTagsFromClass(CostEffect->GetClass(), OutCueTags);
+		}
+
+		if (const UGameplayEffect* CooldownEffect = AbilityCDO->GetCooldownGameplayEffect())
+		{
+			GatherCueTagsFromClass(CooldownEffect->GetClass(), OutCueTags);
+		}
+	}
+
+	// Follow effect classes and cue tags the class exposes as properties (e.g., damage effects or cue tags set on blueprint abilities)
+	for (TFieldIterator<FProperty> PropIt(Class); PropIt; ++PropIt)
+	{
+		if (const FClassProperty* ClassProperty = CastField<FClassProperty>(*PropIt))
+		{
+			if (ClassProperty->MetaClass && ClassProperty->MetaClass->IsChildOf(UGameplayEffect::StaticClass()))
+			{
+				const UClass* EffectClass = Cast<UClass>(ClassProperty->GetObjectPropertyValue_InContainer(CDO));
+				if (EffectClass && EffectClass != Class)
+				{
+					GatherCueTagsFromClass(EffectClass, OutCueTags);
+				}
+			}
+		}
+		else if (const FStructProperty* StructProperty = CastField<FStructProperty>(*PropIt))
+		{
+			if (StructProperty->Struct == FGameplayTag::StaticStruct())
+			{
+				const FGameplayTag& Tag = *StructProperty->ContainerPtrToValuePtr<FGameplayTag>(CDO);
+				if (CueDataMap.Contains(Tag))
+				{
+					OutCueTags.AddTag(Tag);
+				}
+			}
+		}
+	}
+}
+
+void ULyraGameplayCueManager::RequestExperienceCuePreload(const FGameplayTag& Tag, bool bCritical)
+{
+	int32* DataIdx = RuntimeGameplayCueObjectLibrary.CueSet->GameplayCueDataMap.Find(Tag);
+	if (!DataIdx || !RuntimeGameplayCueObjectLibrary.CueSet->GameplayCueData.IsValidIndex(*DataIdx))
+	{
+		return;
+	}
+
+	const FGameplayCueNotifyData& CueData = RuntimeGameplayCueObjectLibrary.CueSet->GameplayCueData[*DataIdx];
+
+	++NumCuePreloadsRequested;
+
+	if (UClass* LoadedGameplayCueClass = Cast<UClass>(CueData.GameplayCueNotifyObj.ResolveObject()))
+	{
+		++NumCuePreloadsCompleted;
+		RegisterPreloadedCue(LoadedGameplayCueClass, const_cast<ULyraExperienceDefinition*>(CuePreloadExperience.Get()));
+		return;
+	}
+
+	if (bCritical)
+	{
+		++NumCriticalCuePreloadsPending;
+	}
+
+	const TAsyncLoadPriority Priority = bCritical ? FStreamableManager::AsyncLoadHighPriority : FStreamableManager::DefaultAsyncLoadPriority;
+	StreamableManager.RequestAsyncLoad(CueData.GameplayCueNotifyObj, FStreamableDelegate::CreateUObject(this, &ThisClass::OnExperienceCuePreloadComplete, CueData.GameplayCueNotifyObj, CuePreloadGeneration, bCritical), Priority, false, false, TEXT("GameplayCueManager"));
+}
+
+void ULyraGameplayCueManager::OnExperienceCuePreloadComplete(FSoftObjectPath Path, int32 Generation, bool bCritical)
+{
+	if (Generation != CuePreloadGeneration)
+	{
+		return;
+	}
+
+	++NumCuePreloadsCompleted;
+
+	if (bCritical && ensure(NumCriticalCuePreloadsPending > 0))
+	{
+		--NumCriticalCuePreloadsPending;
+		if (NumCriticalCuePreloadsPending == 0)
+		{
+			UE_LOG(LogLyra, Log, TEXT("ULyraGameplayCueManager: Critical cues for experience %s loaded in %.2f seconds"), *CuePreloadExperienceId.ToString(), FPlatformTime::Seconds() - CuePreloadStartTime);
+		}
+	}
+
+	const ULyraExperienceDefinition* Experience = CuePreloadExperience.Get();
+	if (Experience == nullptr)
+	{
+		return;
+	}
+
+	if (UClass* LoadedGameplayCueClass = Cast<UClass>(Path.ResolveObject()))
+	{
+		RegisterPreloadedCue(LoadedGameplayCueClass, const_cast<ULyraExperienceDefinition*>(Experience));
+	}
+}
+
+void ULyraGameplayCueManager::RemovePreloadReferencer(const FObjectKey& Referencer)
+{
+	for (auto CueIt = PreloadedCues.CreateIterator(); CueIt; ++CueIt)
+	{
+		TSet<FObjectKey>& ReferencerSet = PreloadedCueReferencers.FindChecked(*CueIt);
+		ReferencerSet.Remove(Referencer);
+		if (ReferencerSet.Num() == 0)
+		{
+			PreloadedCueReferencers.Remove(*CueIt);
+			CueIt.RemoveCurrent();
+		}
+	}
+}
+
+void ULyraGameplayCueManager::RouteGameplayCue(AActor* TargetActor, FGameplayTag GameplayCueTag, EGameplayCueEvent::Type EventType, const FGameplayCueParameters& Parameters, EGameplayCueExecutionOptions Options)
+{
+	TrackFireTimeLoad(GameplayCueTag);
+
+	Super::RouteGameplayCue(TargetActor, GameplayCueTag, EventType, Parameters, Options);
+}
+
+void ULyraGameplayCueManager::TrackFireTimeLoad(const FGameplayTag& Tag)
+{
+	if (!IsPreloadingCues() || !RuntimeGameplayCueObjectLibrary.CueSet)
+	{
+		return;
+	}
+
+	const int32* DataIdx = RuntimeGameplayCueObjectLibrary.CueSet->GameplayCueDataMap.Find(Tag);
+	if (!DataIdx || !RuntimeGameplayCueObjectLibrary.CueSet->GameplayCueData.IsValidIndex(*DataIdx))
+	{
+		return;
+	}
+
+	const FGameplayCueNotifyData& CueData = RuntimeGameplayCueObjectLibrary.CueSet->GameplayCueData[*DataIdx];
+	if (CueData.LoadedGameplayCueClass || CueData.GameplayCueNotifyObj.ResolveObject())
+	{
+		return;
+	}
+
+	// The cue isn't in memory so it will be loaded now and the effect will play late (or not at all)
+	FireTimeLoadCounts.FindOrAdd(Tag)++;
+
+	if (CuePreloadExperienceId.IsValid())
+	{
+		FireTimeLoadedCuesByExperience.FindOrAdd(CuePreloadExperienceId).Add(Tag);
+	}
+
+	UE_LOG(LogLyra, Verbose, TEXT("ULyraGameplayCueManager: Cue %s was fired before it was loaded"), *Tag.ToString());
+}
+
 void ULyraGameplayCueManager::OnGameplayTagLoaded(const FGameplayTag& Tag)
 {
 	FScopeLock ScopeLock(&LoadedGameplayTagsToProcessCS);
@@ -7,6 +7,8 @@
 #include "LyraGameplayCueManager.generated.h"
 
 class FString;
+class ULyraAbilitySet;
+class ULyraExperienceDefinition;
 class UClass;
 class UObject;
 class UWorld;
@@ -32,9 +34,17 @@ public:
 	virtual bool ShouldAsyncLoadRuntimeObjectLibraries() const override;
 	virtual bool ShouldSyncLoadMissingGameplayCues() const override;
 	virtual bool ShouldAsyncLoadMissingGameplayCues() const override;
+	virtual void RouteGameplayCue(AActor* TargetActor, FGameplayTag GameplayCueTag, EGameplayCueEvent::Type EventType, const FGameplayCueParameters& Parameters, EGameplayCueExecutionOptions Options = EGameplayCueExecutionOptions::Default) override;
 	//~End of UGameplayCueManager interface
 
 	static void DumpGameplayCues(const TArray<FString>& Args);
+	static void DumpCuePreloadStats(const TArray<FString>& Args);
+
+	// Starts streaming in the cues the experience is likely to fire, should be called once the experience's bundles have loaded
+	void PreloadCuesForExperience(const ULyraExperienceDefinition* Experience);
+
+	// Returns true while the critical cues for the current experience preload plan are still loading
+	bool IsCriticalCuePreloadPending() const { return NumCriticalCuePreloadsPending > 0; }
 
 	// When delay loading cues, this will load the cues that must be always loaded anyway
 	void LoadAlwaysLoadedCues();
@@ -52,6 +62,14 @@ private:
 	void HandlePostLoadMap(UWorld* NewWorld);
 	void UpdateDelayLoadDelegateListeners();
 	bool ShouldDelayLoadGameplayCues() const;
+	bool IsPreloadingCues() const;
+
+	void GatherCueTagsFromAbilitySet(const ULyraAbilitySet* AbilitySet, FGameplayTagContainer& OutCueTags) const;
+	void GatherCueTagsFromClass(const UClass* Class, FGameplayTagContainer& OutCueTags) const;
+	void RequestExperienceCuePreload(const FGameplayTag& Tag, bool bCritical);
+	void OnExperienceCuePreloadComplete(FSoftObjectPath Path, int32 Generation, bool bCritical);
+	void RemovePreloadReferencer(const FObjectKey& Referencer);
+	void TrackFireTimeLoad(const FGameplayTag& Tag);
 
 private:
 	struct FLoadedGameplayTagToProcessData
@@ -76,4 +94,22 @@ private:
 	TArray<FLoadedGameplayTagToProcessData> LoadedGameplayTagsToProcess;
 	FCriticalSection LoadedGameplayTagsToProcessCS;
 	bool bProcessLoadedTagsAfterGC = false;
+
+	// Incremented every time an experience preload plan starts, callbacks from older plans are ignored
+	int32 CuePreloadGeneration = 0;
+
+	// The experience the current preload plan was built for
+	TWeakObjectPtr<const ULyraExperienceDefinition> CuePreloadExperience;
+	FPrimaryAssetId CuePreloadExperienceId;
+
+	int32 NumCriticalCuePreloadsPending = 0;
+	int32 NumCuePreloadsRequested = 0;
+	int32 NumCuePreloadsCompleted = 0;
+	double CuePreloadStartTime = 0.0;
+
+	// Cues that were not loaded when they were fired, per experience.  These are added to the next preload plan for that experience.
+	TMap<FPrimaryAssetId, TSet<FGameplayTag>> FireTimeLoadedCuesByExperience;
+
+	// Number of times each cue was fired before it was loaded
+	TMap<FGameplayTag, int32> FireTimeLoadCounts;
 };
@@ -36,6 +36,9 @@ struct FLyraGameplayEffectContext : public FGameplayEffectContext
 	/** Returns the ability source interface associated with the source object. Only valid on the authority. */
 	const ILyraAbilitySourceInterface* GetAbilitySource() const;
 
+	/** Returns the object used as the ability source (e.g., the weapon instance). Only valid on the authority. */
+	const UObject* GetAbilitySourceObject() const { return AbilitySourceObject.Get(); }
+
 	virtual FGameplayEffectContext* Duplicate() const override
 	{
 		FLyraGameplayEffectContext* NewContext = new FLyraGameplayEffectContext();
@@ -6,6 +6,7 @@
 #include "Camera/LyraPenetrationAvoidanceFeeler.h"
 #include "Curves/CurveVector.h"
 #include "Engine/Canvas.h"
+#include "Engine/World.h"
 #include "GameFramework/CameraBlockingVolume.h"
 #include "LyraCameraAssistInterface.h"
 #include "GameFramework/Controller.h"
@@ -19,6 +20,30 @@ namespace LyraCameraMode_ThirdPerson_Statics
 	static const FName NAME_IgnoreCameraCollision = TEXT("IgnoreCameraCollision");
 }
 
+namespace LyraCameraCVars
+{
+	static bool bAsyncPenetrationFeelers = true;
+	static FAutoConsoleVariableRef CVarAsyncPenetrationFeelers(
+		TEXT("Lyra.Camera.AsyncPenetrationFeelers"),
+		bAsyncPenetrationFeelers,
+		TEXT("If true, the predictive camera penetration feelers are swept asynchronously and their results are used the next frame (the main ray is always synchronous)."),
+		ECVF_Default);
+
+	static float PenetrationFeelerReuseDistance = 2.0f;
+	static FAutoConsoleVariableRef CVarPenetrationFeelerReuseDistance(
+		TEXT("Lyra.Camera.PenetrationFeelerReuseDistance"),
+		PenetrationFeelerReuseDistance,
+		TEXT("An async feeler's last result is reused instead of sweeping again while the pivot and feeler end have moved less than this (in cm)."),
+		ECVF_Default);
+
+	static int32 PenetrationFeelerMaxReuseFrames = 10;
+	static FAutoConsoleVariableRef CVarPenetrationFeelerMaxReuseFrames(
+		TEXT("Lyra.Camera.PenetrationFeelerMaxReuseFrames"),
+		PenetrationFeelerMaxReuseFrames,
+		TEXT("How many frames an async feeler's result can be reused before it's swept again, so moving objects are still noticed."),
+		ECVF_Default);
+}
+
 ULyraCameraMode_ThirdPerson::ULyraCameraMode_ThirdPerson()
 {
 	TargetOffsetCurve = nullptr;
@@ -201,18 +226,24 @@ void ULyraCameraMode_ThirdPerson::PreventCameraPenetration(class AActor const& V
 	FCollisionShape SphereShape = FCollisionShape::MakeSphere(0.f);
 	UWorld* World = GetWorld();
 
+	FeelerTraceCaches.SetNum(PenetrationAvoidanceFeelers.Num());
+
 	for (int32 RayIdx = 0; RayIdx < NumRaysToShoot; ++RayIdx)
 	{
 		FLyraPenetrationAvoidanceFeeler& Feeler = PenetrationAvoidanceFeelers[RayIdx];
+
+		// The predictive feelers are traced asynchronously, ray 0 always stays synchronous so the camera can't end up inside anything
+		if ((RayIdx > 0) && LyraCameraCVars::bAsyncPenetrationFeelers)
+		{
+			UpdateAsyncFeeler(RayIdx, ViewTarget, SafeLoc, BaseRay, BaseRayLocalUp, BaseRayLocalRight, SphereParams, DistBlockedPctThisFrame);
+			SoftBlockedPct = DistBlockedPctThisFrame;
+			continue;
+		}
+
 		if (Feeler.FramesUntilNextTrace <= 0)
 		{
 			// calc ray target
-			FVector RayTarget;
-			{
-				FVector RotatedRay = BaseRay.RotateAngleAxis(Feeler.AdjustmentRot.Yaw, BaseRayLocalUp);
-				RotatedRay = RotatedRay.RotateAngleAxis(Feeler.AdjustmentRot.Pitch, BaseRayLocalRight);
-				RayTarget = SafeLoc + RotatedRay;
-			}
+			const FVector RayTarget = GetFeelerRayTarget(Feeler, SafeLoc, BaseRay, BaseRayLocalUp, BaseRayLocalRight);
 
 			// cast for world and pawn hits separately.  this is so we can safely ignore the 
 			// camera's target pawn
@@ -236,57 +267,13 @@ void ULyraCameraMode_ThirdPerson::PreventCameraPenetration(class AActor const& V
 
 			Feeler.FramesUntilNextTrace = Feeler.TraceInterval;
 
-			const AActor* HitActor = Hit.GetActor();
-
-			if (bHit && HitActor)
+			float NewBlockPct = 1.f;
+			if (bHit && EvaluateFeelerHit(ViewTarget, Feeler, Hit, SafeLoc, RayTarget, SphereParams, NewBlockPct))
 			{
-				bool bIgnoreHit = false;
-
-				if (HitActor->ActorHasTag(LyraCameraMode_ThirdPerson_Statics::NAME_IgnoreCameraCollision))
-				{
-					bIgnoreHit = true;
-					SphereParams.AddIgnoredActor(HitActor);
-				}
-
-				// Ignore CameraBlockingVolume hits that occur in front of the ViewTarget.
-				if (!bIgnoreHit && HitActor->IsA<ACameraBlockingVolume>())
-				{
-					const FVector ViewTargetForwardXY = ViewTarget.GetActorForwardVector().GetSafeNormal2D();
-					const FVector ViewTargetLocation = ViewTarget.GetActorLocation();
-					const FVector HitOffset = Hit.Location - ViewTargetLocation;
-					const FVector HitDirectionXY = HitOffset.GetSafeNormal2D();
-					const float DotHitDirection = FVector::DotProduct(ViewTargetForwardXY, HitDirectionXY);
-					if (DotHitDirection > 0.0f)
-					{
-						bIgnoreHit = true;
-						// Ignore this CameraBlockingVolume on the remaining sweeps.
-						SphereParams.AddIgnoredActor(HitActor);
-					}
-					else
-					{
-#if ENABLE_DRAW_DEBUG
-						DebugActorsHitDuringCameraPenetration.AddUnique(TObjectPtr<const AActor>(HitActor));
-#endif
-					}
-				}
-				
-				if (!bIgnoreHit)
-				{
-					float const Weight = Cast<APawn>(Hit.GetActor()) ? Feeler.PawnWeight : Feeler.WorldWeight;
-					float NewBlockPct = Hit.Time;
-					NewBlockPct += (1.f - NewBlockPct) * (1.f - Weight);
-
-					// Recompute blocked pct taking into account pushout distance.
-					NewBlockPct = ((Hit.Location - SafeLoc).Size() - CollisionPushOutDistance) / (RayTarget - SafeLoc).Size();
-					DistBlockedPctThisFrame = FMath::Min(NewBlockPct, DistBlockedPctThisFrame);
+				DistBlockedPctThisFrame = FMath::Min(NewBlockPct, DistBlockedPctThisFrame);
 
-					// This feeler got a hit, so do another trace next frame
-					Feeler.FramesUntilNextTrace = 0;
-
-#if ENABLE_DRAW_DEBUG
-					DebugActorsHitDuringCameraPenetration.AddUnique(TObjectPtr<const AActor>(HitActor));
-#endif
-				}
+				// This feeler got a hit, so do another trace next frame
+				Feeler.FramesUntilNextTrace = 0;
 			}
 
 			if (RayIdx == 0)
@@ -349,6 +336,133 @@ void ULyraCameraMode_ThirdPerson::PreventCameraPenetration(class AActor const& V
 	}
 }
 
+
+FVector ULyraCameraMode_ThirdPerson::GetFeelerRayTarget(const FLyraPenetrationAvoidanceFeeler& Feeler, const FVector& SafeLoc, const FVector& BaseRay, const FVector& BaseRayLocalUp, const FVector& BaseRayLocalRight)
+{
+	FVector RotatedRay = BaseRay.RotateAngleAxis(Feeler.AdjustmentRot.Yaw, BaseRayLocalUp);
+	RotatedRay = RotatedRay.RotateAngleAxis(Feeler.AdjustmentRot.Pitch, BaseRayLocalRight);
+	return SafeLoc + RotatedRay;
+}
+
+bool ULyraCameraMode_ThirdPerson::EvaluateFeelerHit(const AActor& ViewTarget, const FLyraPenetrationAvoidanceFeeler& Feeler, const FHitResult& Hit, const FVector& SafeLoc, const FVector& RayTarget, FCollisionQueryParams& SphereParams, float& OutBlockedPct)
+{
+	const AActor* HitActor = Hit.GetActor();
+	if (!HitActor)
+	{
+		return false;
+	}
+
+	if (HitActor->ActorHasTag(LyraCameraMode_ThirdPerson_Statics::NAME_IgnoreCameraCollision))
+	{
+		SphereParams.AddIgnoredActor(HitActor);
+		return false;
+	}
+
+	// Ignore CameraBlockingVolume hits that occur in front of the ViewTarget.
+	if (HitActor->IsA<ACameraBlockingVolume>())
+	{
+		const FVector ViewTargetForwardXY = ViewTarget.GetActorForwardVector().GetSafeNormal2D();
+		const FVector ViewTargetLocation = ViewTarget.GetActorLocation();
+		const FVector HitOffset = Hit.Location - ViewTargetLocation;
+		const FVector HitDirectionXY = HitOffset.GetSafeNormal2D();
+		const float DotHitDirection = FVector::DotProduct(ViewTargetForwardXY, HitDirectionXY);
+		if (DotHitDirection > 0.0f)
+		{
+			// Ignore this CameraBlockingVolume on the remaining sweeps.
+			SphereParams.AddIgnoredActor(HitActor);
+			return false;
+		}
+	}
+
+	float const Weight = Cast<APawn>(HitActor) ? Feeler.PawnWeight : Feeler.WorldWeight;
+	float NewBlockPct = Hit.Time;
+	NewBlockPct += (1.f - NewBlockPct) * (1.f - Weight);
+
+	// Recompute blocked pct taking into account pushout distance.
+	NewBlockPct = ((Hit.Location - SafeLoc).Size() - CollisionPushOutDistance) / (RayTarget - SafeLoc).Size();
+	OutBlockedPct = NewBlockPct;
+
+#if ENABLE_DRAW_DEBUG
+	DebugActorsHitDuringCameraPenetration.AddUnique(TObjectPtr<const AActor>(HitActor));
+#endif
+
+	return true;
+}
+
+void ULyraCameraMode_ThirdPerson::UpdateAsyncFeeler(int32 RayIdx, const AActor& ViewTarget, const FVector& SafeLoc, const FVector& BaseRay, const FVector& BaseRayLocalUp, const FVector& BaseRayLocalRight, FCollisionQueryParams& SphereParams, float& DistBlockedPctThisFrame)
+{
+	FLyraPenetrationAvoidanceFeeler& Feeler = PenetrationAvoidanceFeelers[RayIdx];
+	FLyraPenetrationFeelerTraceCache& Cache = FeelerTraceCaches[RayIdx];
+	UWorld* World = GetWorld();
+
+	// Pick up the result of the sweep started last frame
+	if (Cache.PendingTrace.IsValid())
+	{
+		FTraceDatum TraceDatum;
+		if (World->QueryTraceData(Cache.PendingTrace, TraceDatum))
+		{
+			const FHitResult* Hit = FHitResult::GetFirstBlockingHit(TraceDatum.OutHits);
+
+			float NewBlockPct = 1.f;
+			if (!Hit || !EvaluateFeelerHit(ViewTarget, Feeler, *Hit, TraceDatum.Start, TraceDatum.End, SphereParams, NewBlockPct))
+			{
+				NewBlockPct = 1.f;
+			}
+
+#if ENABLE_DRAW_DEBUG
+			if (World->TimeSince(LastDrawDebugTime) < 1.f)
+			{
+				DrawDebugSphere(World, TraceDatum.Start, Feeler.Extent, 8, FColor::Orange);
+				DrawDebugSphere(World, Hit ? Hit->Location : TraceDatum.End, Feeler.Extent, 8, FColor::Orange);
+				DrawDebugLine(World, TraceDatum.Start, Hit ? Hit->Location : TraceDatum.End, FColor::Orange);
+			}
+#endif // ENABLE_DRAW_DEBUG
+
+			Cache.BlockedPct = NewBlockPct;
+			Cache.SafeLoc = TraceDatum.Start;
+			Cache.RayTarget = TraceDatum.End;
+			Cache.FramesSinceTrace = 0;
+			Cache.bHasResult = true;
+
+			// A feeler that hit something keeps tracing every frame, like the synchronous feelers
+			Feeler.FramesUntilNextTrace = (NewBlockPct < 1.f) ? 0 : Feeler.TraceInterval;
+		}
+
+		Cache.PendingTrace = FTraceHandle();
+	}
+
+	const FVector RayTarget = GetFeelerRayTarget(Feeler, SafeLoc, BaseRay, BaseRayLocalUp, BaseRayLocalRight);
+
+	if (Cache.bHasResult)
+	{
+		DistBlockedPctThisFrame = FMath::Min(Cache.BlockedPct, DistBlockedPctThisFrame);
+		++Cache.FramesSinceTrace;
+	}
+
+	// Reuse the last result while the pivot and camera are (nearly) where it was traced from
+	const float ReuseDistanceSq = FMath::Square(LyraCameraCVars::PenetrationFeelerReuseDistance);
+	const bool bCanReuseResult = Cache.bHasResult
+		&& (Cache.FramesSinceTrace <= LyraCameraCVars::PenetrationFeelerMaxReuseFrames)
+		&& (FVector::DistSquared(Cache.SafeLoc, SafeLoc) <= ReuseDistanceSq)
+		&& (FVector::DistSquared(Cache.RayTarget, RayTarget) <= ReuseDistanceSq);
+
+	if (bCanReuseResult)
+	{
+		return;
+	}
+
+	if (Feeler.FramesUntilNextTrace > 0)
+	{
+		--Feeler.FramesUntilNextTrace;
+		return;
+	}
+
+	// The result is applied next frame
+	const FCollisionShape SphereShape = FCollisionShape::MakeSphere(Feeler.Extent);
+	Cache.PendingTrace = World->AsyncSweepByChannel(EAsyncTraceType::Single, SafeLoc, RayTarget, FQuat::Identity, ECC_Camera, SphereShape, SphereParams);
+	Feeler.FramesUntilNextTrace = Feeler.TraceInterval;
+}
+
 void ULyraCameraMode_ThirdPerson::SetTargetCrouchOffset(FVector NewTargetOffset)
 {
 	CrouchOffsetBlendPct = 0.0f;
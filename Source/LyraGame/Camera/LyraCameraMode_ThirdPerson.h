@@ -6,10 +6,25 @@
 #include "Curves/CurveFloat.h"
 #include "LyraPenetrationAvoidanceFeeler.h"
 #include "DrawDebugHelpers.h"
+#include "WorldCollision.h"
 #include "LyraCameraMode_ThirdPerson.generated.h"
 
 class UCurveVector;
 
+/** Last result and in-flight sweep of an asynchronously traced penetration feeler */
+struct FLyraPenetrationFeelerTraceCache
+{
+	FTraceHandle PendingTrace;
+
+	// Where the last result was traced from and to
+	FVector SafeLoc = FVector::ZeroVector;
+	FVector RayTarget = FVector::ZeroVector;
+
+	float BlockedPct = 1.f;
+	int32 FramesSinceTrace = 0;
+	bool bHasResult = false;
+};
+
 /**
  * ULyraCameraMode_ThirdPerson
  *
@@ -32,6 +47,14 @@ protected:
 	void UpdatePreventPenetration(float DeltaTime);
 	void PreventCameraPenetration(class AActor const& ViewTarget, FVector const& SafeLoc, FVector& CameraLoc, float const& DeltaTime, float& DistBlockedPct, bool bSingleRayOnly);
 
+	static FVector GetFeelerRayTarget(const FLyraPenetrationAvoidanceFeeler& Feeler, const FVector& SafeLoc, const FVector& BaseRay, const FVector& BaseRayLocalUp, const FVector& BaseRayLocalRight);
+
+	// Returns true if the hit blocks the feeler, with how far along the ray it's blocked in OutBlockedPct
+	bool EvaluateFeelerHit(const AActor& ViewTarget, const FLyraPenetrationAvoidanceFeeler& Feeler, const FHitResult& Hit, const FVector& SafeLoc, const FVector& RayTarget, FCollisionQueryParams& SphereParams, float& OutBlockedPct);
+
+	// Applies the feeler's latest async result and starts a new sweep if the cached one can't be reused
+	void UpdateAsyncFeeler(int32 RayIdx, const AActor& ViewTarget, const FVector& SafeLoc, const FVector& BaseRay, const FVector& BaseRayLocalUp, const FVector& BaseRayLocalRight, FCollisionQueryParams& SphereParams, float& DistBlockedPctThisFrame);
+
 	virtual void DrawDebug(UCanvas* Canvas) const override;
 
 protected:
@@ -97,6 +120,9 @@ public:
 	UPROPERTY(Transient)
 	TArray<TObjectPtr<const AActor>> DebugActorsHitDuringCameraPenetration;
 
+	/** Per feeler async sweep state, parallel to PenetrationAvoidanceFeelers */
+	TArray<FLyraPenetrationFeelerTraceCache> FeelerTraceCaches;
+
 #if ENABLE_DRAW_DEBUG
 	mutable float LastDrawDebugTime = -MAX_FLT;
 #endif
@@ -7,9 +7,11 @@
 #include "Equipment/LyraEquipmentManagerComponent.h"
 #include "GameFramework/GameplayMessageSubsystem.h"
 #include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
 #include "Inventory/InventoryFragment_EquippableItem.h"
 #include "NativeGameplayTags.h"
 #include "Net/UnrealNetwork.h"
+#include "TimerManager.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraQuickBarComponent)
 
@@ -19,6 +21,16 @@ class ULyraEquipmentDefinition;
 UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Lyra_QuickBar_Message_SlotsChanged, "Lyra.QuickBar.Message.SlotsChanged");
 UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Lyra_QuickBar_Message_ActiveIndexChanged, "Lyra.QuickBar.Message.ActiveIndexChanged");
 
+namespace LyraQuickBarCVars
+{
+	static bool bCoalesceSlotsChangedMessages = true;
+	static FAutoConsoleVariableRef CVarCoalesceSlotsChangedMessages(
+		TEXT("Lyra.QuickBar.CoalesceSlotsChangedMessages"),
+		bCoalesceSlotsChangedMessages,
+		TEXT("If true, the quick bar sends at most one SlotsChanged message per frame (with the final slots) instead of one per slot change."),
+		ECVF_Default);
+}
+
 ULyraQuickBarComponent::ULyraQuickBarComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
@@ -304,6 +316,31 @@ int32 ULyraQuickBarComponent::CountLoadedItems() const
 
 void ULyraQuickBarComponent::OnRep_Slots()
 {
+	UWorld* World = GetWorld();
+	if (LyraQuickBarCVars::bCoalesceSlotsChangedMessages && (World != nullptr))
+	{
+		// The message carries the full slot list, so listeners only need the state at the end of the frame
+		if (!bSlotsChangedMessagePending)
+		{
+			bSlotsChangedMessagePending = true;
+			World->GetTimerManager().SetTimerForNextTick(this, &ThisClass::FlushSlotsChangedMessage);
+		}
+	}
+	else
+	{
+		bSlotsChangedMessagePending = true;
+		FlushSlotsChangedMessage();
+	}
+}
+
+void ULyraQuickBarComponent::FlushSlotsChangedMessage()
+{
+	if (!bSlotsChangedMessagePending)
+	{
+		return;
+	}
+	bSlotsChangedMessagePending = false;
+
 	FLyraQuickBarSlotsChangedMessage Message;
 	Message.Owner = GetOwner();
 	Message.Slots = Slots;
@@ -314,6 +351,9 @@ void ULyraQuickBarComponent::OnRep_Slots()
 
 void ULyraQuickBarComponent::OnRep_ActiveSlotIndex()
 {
+	// Make sure listeners have seen the slot the new index refers to
+	FlushSlotsChangedMessage();
+
 	FLyraQuickBarActiveIndexChangedMessage Message;
 	Message.Owner = GetOwner();
 	Message.ActiveIndex = ActiveSlotIndex;
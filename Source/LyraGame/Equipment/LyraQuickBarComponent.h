@@ -85,6 +85,10 @@ protected:
 	UFUNCTION()
 	void OnRep_ActiveSlotIndex();
 
+private:
+	// Sends the slots changed message if one is waiting for the end of the frame
+	void FlushSlotsChangedMessage();
+
 private:
 	UPROPERTY(ReplicatedUsing=OnRep_Slots)
 	TArray<TObjectPtr<ULyraInventoryItemInstance>> Slots;
@@ -94,6 +98,9 @@ private:
 
 	UPROPERTY()
 	TObjectPtr<ULyraEquipmentInstance> EquippedItem;
+
+	// True when the slots changed at least once this frame and the message hasn't been sent yet
+	bool bSlotsChangedMessagePending = false;
 };
 
 
@@ -3,8 +3,10 @@
 
 #include "LyraContextEffectComponent.h"
 
+#include "Components/AudioComponent.h"
 #include "Engine/World.h"
 #include "LyraContextEffectsSubsystem.h"
+#include "NiagaraComponent.h"
 #include "PhysicalMaterials/PhysicalMaterial.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraContextEffectComponent)
@@ -99,10 +101,10 @@ void ULyraContextEffectComponent::AnimMotionEffect_Implementation(const FName Bo
 		}
 	}
 
-	// Cycle through Active Audio Components and cache
+	// Cycle through Active Audio Components and cache (finished components may be back in a pool, so only keep playing ones)
 	for (UAudioComponent* ActiveAudioComponent : ActiveAudioComponents)
 	{
-		if (ActiveAudioComponent)
+		if (ActiveAudioComponent && ActiveAudioComponent->IsPlaying())
 		{
 			AudioComponentsToAdd.Add(ActiveAudioComponent);
 		}
@@ -111,7 +113,7 @@ void ULyraContextEffectComponent::AnimMotionEffect_Implementation(const FName Bo
 	// Cycle through Active Niagara Components and cache
 	for (UNiagaraComponent* ActiveNiagaraComponent : ActiveNiagaraComponents)
 	{
-		if (ActiveNiagaraComponent)
+		if (ActiveNiagaraComponent && ActiveNiagaraComponent->IsActive())
 		{
 			NiagaraComponentsToAdd.Add(ActiveNiagaraComponent);
 		}
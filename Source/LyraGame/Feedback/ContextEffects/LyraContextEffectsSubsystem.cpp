@@ -4,8 +4,14 @@
 #include "LyraContextEffectsSubsystem.h"
 
 #include "Feedback/ContextEffects/LyraContextEffectsLibrary.h"
+#include "AudioDevice.h"
+#include "Components/AudioComponent.h"
+#include "Engine/World.h"
 #include "Feedback/ContextEffects/LyraContextEffectsSubsystem.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
 #include "Kismet/GameplayStatics.h"
+#include "NiagaraComponent.h"
 #include "NiagaraFunctionLibrary.h"
 #include "NiagaraSystem.h"
 
@@ -17,6 +23,104 @@ class UNiagaraSystem;
 class USceneComponent;
 class USoundBase;
 
+DECLARE_STATS_GROUP(TEXT("LyraContextEffects"), STATGROUP_LyraContextEffects, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT(TEXT("Spawn Context Effects"), STAT_LyraContextEffects_Spawn, STATGROUP_LyraContextEffects);
+DECLARE_CYCLE_STAT(TEXT("Resolve Effects"), STAT_LyraContextEffects_Resolve, STATGROUP_LyraContextEffects);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Resolved Effect Cache Hits"), STAT_LyraContextEffects_CacheHits, STATGROUP_LyraContextEffects);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Resolved Effect Cache Misses"), STAT_LyraContextEffects_CacheMisses, STATGROUP_LyraContextEffects);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Resolved Effect Cache Hit Rate %"), STAT_LyraContextEffects_CacheHitRate, STATGROUP_LyraContextEffects);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sounds Played"), STAT_LyraContextEffects_SoundsPlayed, STATGROUP_LyraContextEffects);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sounds Reusing A Pooled Component"), STAT_LyraContextEffects_SoundsReused, STATGROUP_LyraContextEffects);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Niagara Systems Spawned"), STAT_LyraContextEffects_NiagaraSpawned, STATGROUP_LyraContextEffects);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Effects Culled By Distance"), STAT_LyraContextEffects_DistanceCulled, STATGROUP_LyraContextEffects);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Effects Skipped By Concurrency"), STAT_LyraContextEffects_ConcurrencySkipped, STATGROUP_LyraContextEffects);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Audio Components"), STAT_LyraContextEffects_PooledAudioComponents, STATGROUP_LyraContextEffects);
+
+namespace LyraContextEffects
+{
+	static bool bCacheResolvedEffects = true;
+	static FAutoConsoleVariableRef CVarCacheResolvedEffects(
+		TEXT("Lyra.ContextEffects.CacheResolvedEffects"),
+		bCacheResolvedEffects,
+		TEXT("If true, the sounds and systems for each (effect, contexts) pair are only looked up in the libraries once per effects set."),
+		ECVF_Default);
+
+	static bool bPoolEffects = true;
+	static FAutoConsoleVariableRef CVarPoolEffects(
+		TEXT("Lyra.ContextEffects.PoolEffects"),
+		bPoolEffects,
+		TEXT("If true, context effect sounds reuse pooled audio components and Niagara systems use the Niagara component pool."),
+		ECVF_Default);
+}
+
+uint32 FLyraContextEffectsCacheKey::MakeHash(const FLyraContextEffectsCacheLookup& Lookup)
+{
+	// Sum the tag hashes so containers with the same tags in a different order share an entry
+	uint32 ContextsHash = 0;
+	for (const FGameplayTag& Tag : Lookup.Contexts)
+	{
+		ContextsHash += GetTypeHash(Tag);
+	}
+
+	return HashCombine(GetTypeHash(Lookup.Effect), ContextsHash);
+}
+
+const FLyraResolvedContextEffects& ULyraContextEffectsSet::FindOrResolveEffects(FGameplayTag Effect, const FGameplayTagContainer& Contexts, bool& bOutCacheHit)
+{
+	bOutCacheHit = false;
+
+	const FLyraContextEffectsCacheLookup Lookup{ Effect, Contexts };
+	const uint32 LookupHash = FLyraContextEffectsCacheKey::MakeHash(Lookup);
+	if (LyraContextEffects::bCacheResolvedEffects)
+	{
+		if (const FLyraResolvedContextEffects* CachedEffects = ResolvedEffects.FindByHash(LookupHash, Lookup))
+		{
+			bOutCacheHit = true;
+			return *CachedEffects;
+		}
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_LyraContextEffects_Resolve);
+
+	FLyraResolvedContextEffects NewEffects;
+	bool bAllLibrariesLoaded = true;
+
+	// Cycle through Effect Libraries
+	for (ULyraContextEffectsLibrary* EffectLibrary : LyraContextEffectsLibraries)
+	{
+		// Check if the Effect Library is valid and data Loaded
+		if (EffectLibrary && EffectLibrary->GetContextEffectsLibraryLoadState() == EContextEffectsLibraryLoadState::Loaded)
+		{
+			// Get Sounds and Niagara Systems
+			EffectLibrary->GetEffects(Effect, Contexts, NewEffects.Sounds, NewEffects.NiagaraSystems);
+		}
+		else if (EffectLibrary && EffectLibrary->GetContextEffectsLibraryLoadState() == EContextEffectsLibraryLoadState::Unloaded)
+		{
+			// Libraries are loaded when they're added, this only happens if one was unloaded since
+			EffectLibrary->LoadEffects();
+			bAllLibrariesLoaded = false;
+		}
+		else if (EffectLibrary)
+		{
+			bAllLibrariesLoaded = false;
+		}
+	}
+
+	if (LyraContextEffects::bCacheResolvedEffects && bAllLibrariesLoaded)
+	{
+		return ResolvedEffects.Emplace(FLyraContextEffectsCacheKey(Lookup, LookupHash), MoveTemp(NewEffects));
+	}
+
+	UncachedEffects = MoveTemp(NewEffects);
+	return UncachedEffects;
+}
+
+void ULyraContextEffectsSet::ResetResolvedEffects()
+{
+	ResolvedEffects.Reset();
+}
+
 void ULyraContextEffectsSubsystem::SpawnContextEffects(
 	const AActor* SpawningActor
 	, USceneComponent* AttachToComponent
@@ -37,40 +141,75 @@ void ULyraContextEffectsSubsystem::SpawnContextEffects(
 		// Validate the pointers from the Map Find
 		if (ULyraContextEffectsSet* EffectsLibraries = *EffectsLibrariesSetPtr)
 		{
-			// Prepare Arrays for Sounds and Niagara Systems
-			TArray<USoundBase*> TotalSounds;
-			TArray<UNiagaraSystem*> TotalNiagaraSystems;
+			SCOPE_CYCLE_COUNTER(STAT_LyraContextEffects_Spawn);
+
+			// Find the Sounds and Niagara Systems for this Effect and Context, usually already resolved by an earlier call
+			bool bCacheHit = false;
+			const FLyraResolvedContextEffects& ResolvedEffects = EffectsLibraries->FindOrResolveEffects(Effect, Contexts, /*out*/ bCacheHit);
 
-			// Cycle through Effect Libraries
-			for (ULyraContextEffectsLibrary* EffectLibrary : EffectsLibraries->LyraContextEffectsLibraries)
+			++NumResolvedEffectsCacheLookups;
+			if (bCacheHit)
 			{
-				// Check if the Effect Library is valid and data Loaded
-				if (EffectLibrary && EffectLibrary->GetContextEffectsLibraryLoadState() == EContextEffectsLibraryLoadState::Loaded)
-				{
-					// Set up local list of Sounds and Niagara Systems
-					TArray<USoundBase*> Sounds;
-					TArray<UNiagaraSystem*> NiagaraSystems;
+				++NumResolvedEffectsCacheHits;
+				INC_DWORD_STAT(STAT_LyraContextEffects_CacheHits);
+			}
+			else
+			{
+				INC_DWORD_STAT(STAT_LyraContextEffects_CacheMisses);
+			}
+			SET_FLOAT_STAT(STAT_LyraContextEffects_CacheHitRate, 100.0 * double(NumResolvedEffectsCacheHits) / double(NumResolvedEffectsCacheLookups));
 
-					// Get Sounds and Niagara Systems
-					EffectLibrary->GetEffects(Effect, Contexts, Sounds, NiagaraSystems);
+			const TArray<USoundBase*>& TotalSounds = ResolvedEffects.Sounds;
+			const TArray<UNiagaraSystem*>& TotalNiagaraSystems = ResolvedEffects.NiagaraSystems;
 
-					// Append to accumulating array
-					TotalSounds.Append(Sounds);
-					TotalNiagaraSystems.Append(NiagaraSystems);
-				}
-				else if (EffectLibrary && EffectLibrary->GetContextEffectsLibraryLoadState() == EContextEffectsLibraryLoadState::Unloaded)
+			if (TotalSounds.Num() == 0 && TotalNiagaraSystems.Num() == 0)
+			{
+				return;
+			}
+
+			// Don't spawn anything nobody is close enough to notice
+			if (AttachToComponent != nullptr)
+			{
+				const FVector EffectLocation = AttachToComponent->GetSocketTransform(AttachPoint).TransformPosition(LocationOffset);
+				if (!IsWithinSpawnDistance(EffectLocation))
 				{
-					// Else load effects
-					EffectLibrary->LoadEffects();
+					INC_DWORD_STAT_BY(STAT_LyraContextEffects_DistanceCulled, TotalSounds.Num() + TotalNiagaraSystems.Num());
+					return;
 				}
 			}
 
 			// Cycle through found Sounds
 			for (USoundBase* Sound : TotalSounds)
 			{
+				if (!HasConcurrencyBudget(Effect, NumActiveSoundsPerEffect, ActiveSoundEffects))
+				{
+					INC_DWORD_STAT(STAT_LyraContextEffects_ConcurrencySkipped);
+					continue;
+				}
+
 				// Spawn Sounds Attached, add Audio Component to List of ACs
-				UAudioComponent* AudioComponent = UGameplayStatics::SpawnSoundAttached(Sound, AttachToComponent, AttachPoint, LocationOffset, RotationOffset, EAttachLocation::KeepRelativeOffset,
-					false, AudioVolume, AudioPitch, 0.0f, nullptr, nullptr, true);
+				UAudioComponent* AudioComponent = nullptr;
+				if (LyraContextEffects::bPoolEffects)
+				{
+					AudioComponent = PlayPooledSound(Sound, AttachToComponent, AttachPoint, LocationOffset, RotationOffset, AudioVolume, AudioPitch);
+				}
+				else
+				{
+					AudioComponent = UGameplayStatics::SpawnSoundAttached(Sound, AttachToComponent, AttachPoint, LocationOffset, RotationOffset, EAttachLocation::KeepRelativeOffset,
+						false, AudioVolume, AudioPitch, 0.0f, nullptr, nullptr, true);
+
+					if (AudioComponent)
+					{
+						AudioComponent->OnAudioFinishedNative.AddUObject(this, &ThisClass::HandlePooledAudioFinished);
+					}
+				}
+
+				if (AudioComponent)
+				{
+					INC_DWORD_STAT(STAT_LyraContextEffects_SoundsPlayed);
+					ActiveSoundEffects.Add(AudioComponent, Effect);
+					++NumActiveSoundsPerEffect.FindOrAdd(Effect);
+				}
 
 				AudioOut.Add(AudioComponent);
 			}
@@ -78,9 +217,25 @@ void ULyraContextEffectsSubsystem::SpawnContextEffects(
 			// Cycle through found Niagara Systems
 			for (UNiagaraSystem* NiagaraSystem : TotalNiagaraSystems)
 			{
+				if (!HasConcurrencyBudget(Effect, NumActiveNiagaraPerEffect, ActiveNiagaraEffects))
+				{
+					INC_DWORD_STAT(STAT_LyraContextEffects_ConcurrencySkipped);
+					continue;
+				}
+
 				// Spawn Niagara Systems Attached, add Niagara Component to List of NCs
+				// (pooled components go back to the Niagara component pool when they finish)
+				const ENCPoolMethod PoolMethod = LyraContextEffects::bPoolEffects ? ENCPoolMethod::AutoRelease : ENCPoolMethod::None;
 				UNiagaraComponent* NiagaraComponent = UNiagaraFunctionLibrary::SpawnSystemAttached(NiagaraSystem, AttachToComponent, AttachPoint, LocationOffset,
-					RotationOffset, VFXScale, EAttachLocation::KeepRelativeOffset, true, ENCPoolMethod::None, true, true);
+					RotationOffset, VFXScale, EAttachLocation::KeepRelativeOffset, true, PoolMethod, true, true);
+
+				if (NiagaraComponent)
+				{
+					INC_DWORD_STAT(STAT_LyraContextEffects_NiagaraSpawned);
+					NiagaraComponent->OnSystemFinished.AddUniqueDynamic(this, &ThisClass::HandleNiagaraSystemFinished);
+					ActiveNiagaraEffects.Add(NiagaraComponent, Effect);
+					++NumActiveNiagaraPerEffect.FindOrAdd(Effect);
+				}
 
 				NiagaraOut.Add(NiagaraComponent);
 			}
@@ -88,6 +243,190 @@ void ULyraContextEffectsSubsystem::SpawnContextEffects(
 	}
 }
 
+bool ULyraContextEffectsSubsystem::IsWithinSpawnDistance(const FVector& Location)
+{
+	const float MaxSpawnDistance = GetDefault<ULyraContextEffectsSettings>()->MaxSpawnDistance;
+	if (MaxSpawnDistance <= 0.0f)
+	{
+		return true;
+	}
+
+	if (LocalViewLocationsFrame != GFrameCounter)
+	{
+		LocalViewLocationsFrame = GFrameCounter;
+		LocalViewLocations.Reset();
+
+		for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+		{
+			const APlayerController* PC = It->Get();
+			if (PC && PC->IsLocalController())
+			{
+				FVector ViewLocation;
+				FRotator ViewRotation;
+				PC->GetPlayerViewPoint(/*out*/ ViewLocation, /*out*/ ViewRotation);
+				LocalViewLocations.Add(ViewLocation);
+			}
+		}
+	}
+
+	const float MaxSpawnDistanceSquared = FMath::Square(MaxSpawnDistance);
+	for (const FVector& ViewLocation : LocalViewLocations)
+	{
+		if (FVector::DistSquared(ViewLocation, Location) <= MaxSpawnDistanceSquared)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool ULyraContextEffectsSubsystem::HasConcurrencyBudget(FGameplayTag Effect, TMap<FGameplayTag, int32>& NumActivePerEffect, TMap<TObjectKey<USceneComponent>, FGameplayTag>& ActiveEffects)
+{
+	const ULyraContextEffectsSettings* Settings = GetDefault<ULyraContextEffectsSettings>();
+	const int32* MaxForEffect = Settings->MaxConcurrentEffectsPerTag.Find(Effect);
+	const int32 MaxConcurrent = MaxForEffect ? *MaxForEffect : Settings->DefaultMaxConcurrentEffects;
+	if (MaxConcurrent <= 0)
+	{
+		return true;
+	}
+
+	const int32* NumActivePtr = NumActivePerEffect.Find(Effect);
+	if ((NumActivePtr == nullptr) || (*NumActivePtr < MaxConcurrent))
+	{
+		return true;
+	}
+
+	// At the limit, drop any entries whose components were destroyed without telling us they finished before giving up
+	for (auto It = ActiveEffects.CreateIterator(); It; ++It)
+	{
+		if ((It.Value() == Effect) && !It.Key().ResolveObjectPtr())
+		{
+			It.RemoveCurrent();
+			--NumActivePerEffect.FindChecked(Effect);
+		}
+	}
+
+	return NumActivePerEffect.FindChecked(Effect) < MaxConcurrent;
+}
+
+UAudioComponent* ULyraContextEffectsSubsystem::PlayPooledSound(USoundBase* Sound, USceneComponent* AttachToComponent, FName AttachPoint, const FVector& LocationOffset, const FRotator& RotationOffset, float AudioVolume, float AudioPitch)
+{
+	UWorld* World = GetWorld();
+	if ((Sound == nullptr) || (AttachToComponent == nullptr) || (World == nullptr) || !World->GetAudioDeviceRaw())
+	{
+		return nullptr;
+	}
+
+	UAudioComponent* AudioComponent = nullptr;
+	while ((AudioComponent == nullptr) && (FreeAudioComponents.Num() > 0))
+	{
+		UAudioComponent* PooledComponent = FreeAudioComponents.Pop();
+		DEC_DWORD_STAT(STAT_LyraContextEffects_PooledAudioComponents);
+
+		if (IsValid(PooledComponent))
+		{
+			AudioComponent = PooledComponent;
+		}
+	}
+
+	if (AudioComponent)
+	{
+		INC_DWORD_STAT(STAT_LyraContextEffects_SoundsReused);
+	}
+	else
+	{
+		AudioComponent = NewObject<UAudioComponent>(World);
+		AudioComponent->bAutoActivate = false;
+		AudioComponent->bAutoDestroy = false;
+		AudioComponent->bStopWhenOwnerDestroyed = true;
+		AudioComponent->RegisterComponentWithWorld(World);
+		AudioComponent->OnAudioFinishedNative.AddUObject(this, &ThisClass::HandlePooledAudioFinished);
+	}
+
+	AudioComponent->AttachToComponent(AttachToComponent, FAttachmentTransformRules::KeepRelativeTransform, AttachPoint);
+	AudioComponent->SetRelativeLocationAndRotation(LocationOffset, RotationOffset);
+	AudioComponent->SetSound(Sound);
+	AudioComponent->SetVolumeMultiplier(AudioVolume);
+	AudioComponent->SetPitchMultiplier(AudioPitch);
+	AudioComponent->Play();
+
+	BusyAudioComponents.Add(AudioComponent);
+
+	return AudioComponent;
+}
+
+void ULyraContextEffectsSubsystem::HandlePooledAudioFinished(UAudioComponent* AudioComponent)
+{
+	ReleaseEffect(AudioComponent, NumActiveSoundsPerEffect, ActiveSoundEffects);
+
+	if (BusyAudioComponents.Remove(AudioComponent) > 0)
+	{
+		AudioComponent->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+		AudioComponent->SetSound(nullptr);
+
+		if (FreeAudioComponents.Num() < GetDefault<ULyraContextEffectsSettings>()->MaxPooledAudioComponents)
+		{
+			FreeAudioComponents.Push(AudioComponent);
+			INC_DWORD_STAT(STAT_LyraContextEffects_PooledAudioComponents);
+		}
+		else
+		{
+			AudioComponent->DestroyComponent();
+		}
+	}
+}
+
+void ULyraContextEffectsSubsystem::HandleNiagaraSystemFinished(UNiagaraComponent* NiagaraComponent)
+{
+	// Pooled components can be reused by anyone once they finish, so stop listening to this one
+	NiagaraComponent->OnSystemFinished.RemoveDynamic(this, &ThisClass::HandleNiagaraSystemFinished);
+
+	ReleaseEffect(NiagaraComponent, NumActiveNiagaraPerEffect, ActiveNiagaraEffects);
+}
+
+void ULyraContextEffectsSubsystem::ReleaseEffect(const USceneComponent* Component, TMap<FGameplayTag, int32>& NumActivePerEffect, TMap<TObjectKey<USceneComponent>, FGameplayTag>& ActiveEffects)
+{
+	FGameplayTag Effect;
+	if (ActiveEffects.RemoveAndCopyValue(Component, /*out*/ Effect))
+	{
+		if (int32* NumActive = NumActivePerEffect.Find(Effect))
+		{
+			*NumActive = FMath::Max(*NumActive - 1, 0);
+		}
+	}
+}
+
+void ULyraContextEffectsSubsystem::Deinitialize()
+{
+	for (UAudioComponent* AudioComponent : FreeAudioComponents)
+	{
+		if (AudioComponent)
+		{
+			AudioComponent->DestroyComponent();
+		}
+	}
+	SET_DWORD_STAT(STAT_LyraContextEffects_PooledAudioComponents, 0);
+
+	for (UAudioComponent* AudioComponent : BusyAudioComponents)
+	{
+		if (AudioComponent)
+		{
+			AudioComponent->OnAudioFinishedNative.RemoveAll(this);
+			AudioComponent->DestroyComponent();
+		}
+	}
+
+	FreeAudioComponents.Reset();
+	BusyAudioComponents.Reset();
+	ActiveSoundEffects.Reset();
+	ActiveNiagaraEffects.Reset();
+	NumActiveSoundsPerEffect.Reset();
+	NumActiveNiagaraPerEffect.Reset();
+
+	Super::Deinitialize();
+}
+
 bool ULyraContextEffectsSubsystem::GetContextFromSurfaceType(
 	TEnumAsByte<EPhysicalSurface> PhysicalSurface, FGameplayTag& Context)
 {
@@ -124,8 +463,11 @@ void ULyraContextEffectsSubsystem::LoadAndAddContextEffectsLibraries(AActor* Own
 		// TODO Support Async Loading of Asset Data
 		if (ULyraContextEffectsLibrary* EffectsLibrary = ContextEffectSoftObj.LoadSynchronous())
 		{
-			// Call load on valid Libraries
-			EffectsLibrary->LoadEffects();
+			// Load the effects up front so SpawnContextEffects never has to, libraries shared between actors are only loaded once
+			if (EffectsLibrary->GetContextEffectsLibraryLoadState() == EContextEffectsLibraryLoadState::Unloaded)
+			{
+				EffectsLibrary->LoadEffects();
+			}
 
 			// Add new library to Set
 			EffectsLibrariesSet->LyraContextEffectsLibraries.Add(EffectsLibrary);
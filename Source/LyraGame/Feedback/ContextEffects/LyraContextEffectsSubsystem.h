@@ -5,6 +5,7 @@
 #include "Engine/DeveloperSettings.h"
 #include "GameplayTagContainer.h"
 #include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
 
 #include "LyraContextEffectsSubsystem.generated.h"
 
@@ -14,7 +15,9 @@ class AActor;
 class UAudioComponent;
 class ULyraContextEffectsLibrary;
 class UNiagaraComponent;
+class UNiagaraSystem;
 class USceneComponent;
+class USoundBase;
 struct FFrame;
 struct FGameplayTag;
 struct FGameplayTagContainer;
@@ -31,6 +34,66 @@ public:
 	//
 	UPROPERTY(config, EditAnywhere)
 	TMap<TEnumAsByte<EPhysicalSurface>, FGameplayTag> SurfaceTypeToContextMap;
+
+	// How many sounds (and, counted separately, Niagara systems) of each effect can play at once, 0 means no limit
+	UPROPERTY(config, EditAnywhere, Category = "Budget")
+	TMap<FGameplayTag, int32> MaxConcurrentEffectsPerTag;
+
+	// Limit used for effects that aren't in MaxConcurrentEffectsPerTag, 0 means no limit
+	UPROPERTY(config, EditAnywhere, Category = "Budget")
+	int32 DefaultMaxConcurrentEffects = 0;
+
+	// Effects further than this from every local player's view aren't spawned, 0 means no limit
+	UPROPERTY(config, EditAnywhere, Category = "Budget", meta = (Units = "cm"))
+	float MaxSpawnDistance = 0.0f;
+
+	// How many idle audio components are kept for reuse
+	UPROPERTY(config, EditAnywhere, Category = "Budget")
+	int32 MaxPooledAudioComponents = 64;
+};
+
+/** The sounds and Niagara systems an effects set resolves to for one effect tag and set of contexts */
+struct FLyraResolvedContextEffects
+{
+	// Kept alive by the libraries in the owning set
+	TArray<USoundBase*> Sounds;
+	TArray<UNiagaraSystem*> NiagaraSystems;
+};
+
+/** Looks up resolved effects without copying the contexts */
+struct FLyraContextEffectsCacheLookup
+{
+	FGameplayTag Effect;
+	const FGameplayTagContainer& Contexts;
+};
+
+/** Key for the resolved effects of an effects set, the context hash doesn't depend on the order of the tags */
+struct FLyraContextEffectsCacheKey
+{
+	FGameplayTag Effect;
+	FGameplayTagContainer Contexts;
+	uint32 Hash = 0;
+
+	FLyraContextEffectsCacheKey(const FLyraContextEffectsCacheLookup& Lookup, uint32 InHash)
+		: Effect(Lookup.Effect), Contexts(Lookup.Contexts), Hash(InHash)
+	{}
+
+	static uint32 MakeHash(const FLyraContextEffectsCacheLookup& Lookup);
+
+	friend bool operator==(const FLyraContextEffectsCacheKey& A, const FLyraContextEffectsCacheKey& B)
+	{
+		return (A.Hash == B.Hash) && (A.Effect == B.Effect) && (A.Contexts == B.Contexts);
+	}
+
+	friend bool operator==(const FLyraContextEffectsCacheKey& A, const FLyraContextEffectsCacheLookup& B)
+	{
+		return (A.Effect == B.Effect) && (A.Contexts == B.Contexts);
+	}
+
+	friend uint32 GetTypeHash(const FLyraContextEffectsCacheKey& Key)
+	{
+		return Key.Hash;
+	}
 };
 
 /**
@@ -44,6 +107,19 @@ class LYRAGAME_API ULyraContextEffectsSet : public UObject
 public:
 	UPROPERTY(Transient)
 	TSet<TObjectPtr<ULyraContextEffectsLibrary>> LyraContextEffectsLibraries;
+
+	// Returns the effects for Effect in Contexts, walking the libraries on the first request and reusing the result after that.
+	// Results are only cached once every library has loaded, bOutCacheHit says whether the walk was skipped.
+	const FLyraResolvedContextEffects& FindOrResolveEffects(FGameplayTag Effect, const FGameplayTagContainer& Contexts, bool& bOutCacheHit);
+
+	// Drops every cached result, needed if the libraries change
+	void ResetResolvedEffects();
+
+private:
+	TMap<FLyraContextEffectsCacheKey, FLyraResolvedContextEffects> ResolvedEffects;
+
+	// Used for results that can't be cached yet because a library is still loading
+	FLyraResolvedContextEffects UncachedEffects;
 };
 
 
@@ -84,9 +160,51 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "ContextEffects")
 	void UnloadAndRemoveContextEffectsLibraries(AActor* OwningActor);
 
+	//~USubsystem interface
+	virtual void Deinitialize() override;
+	//~End of USubsystem interface
+
 private:
+	// Returns false if the location is further than MaxSpawnDistance from every local player's view
+	bool IsWithinSpawnDistance(const FVector& Location);
+
+	// Returns false if Effect already has as many of this kind of component playing as it's allowed
+	bool HasConcurrencyBudget(FGameplayTag Effect, TMap<FGameplayTag, int32>& NumActivePerEffect, TMap<TObjectKey<USceneComponent>, FGameplayTag>& ActiveEffects);
+
+	// Plays the sound on an audio component from the pool (or a new one), returning nullptr if there's no audio device
+	UAudioComponent* PlayPooledSound(USoundBase* Sound, USceneComponent* AttachToComponent, FName AttachPoint, const FVector& LocationOffset, const FRotator& RotationOffset, float AudioVolume, float AudioPitch);
+
+	void HandlePooledAudioFinished(UAudioComponent* AudioComponent);
+
+	UFUNCTION()
+	void HandleNiagaraSystemFinished(UNiagaraComponent* NiagaraComponent);
+
+	void ReleaseEffect(const USceneComponent* Component, TMap<FGameplayTag, int32>& NumActivePerEffect, TMap<TObjectKey<USceneComponent>, FGameplayTag>& ActiveEffects);
+
 
 	UPROPERTY(Transient)
 	TMap<TObjectPtr<AActor>, TObjectPtr<ULyraContextEffectsSet>> ActiveActorEffectsMap;
 
+	// Lifetime resolved effect cache counters, for the hit rate stat
+	uint64 NumResolvedEffectsCacheHits = 0;
+	uint64 NumResolvedEffectsCacheLookups = 0;
+
+	// Audio components that finished playing and can be reused
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UAudioComponent>> FreeAudioComponents;
+
+	// Pooled audio components that are currently playing
+	UPROPERTY(Transient)
+	TSet<TObjectPtr<UAudioComponent>> BusyAudioComponents;
+
+	// The effect each playing component was spawned for, and how many are playing per effect
+	TMap<TObjectKey<USceneComponent>, FGameplayTag> ActiveSoundEffects;
+	TMap<TObjectKey<USceneComponent>, FGameplayTag> ActiveNiagaraEffects;
+	TMap<FGameplayTag, int32> NumActiveSoundsPerEffect;
+	TMap<FGameplayTag, int32> NumActiveNiagaraPerEffect;
+
+	// View locations of the local players, gathered once per frame for distance culling
+	TArray<FVector> LocalViewLocations;
+	uint64 LocalViewLocationsFrame = 0;
+
 };
@@ -0,0 +1,314 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "LyraNumberPopComponent_InstancedMeshText.h"
+
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "LyraDamagePopStyle.h"
+#include "LyraLogChannels.h"
+#include "TimerManager.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(LyraNumberPopComponent_InstancedMeshText)
+
+static FAutoConsoleCommandWithWorldAndArgs LyraNumberPopBenchmarkCmd(
+	TEXT("Lyra.NumberPops.Benchmark"),
+	TEXT("Adds pops to every instanced mesh number pop component in the world and logs the cost per pop. Usage: Lyra.NumberPops.Benchmark [NumPops=1000]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&ULyraNumberPopComponent_InstancedMeshText::RunBenchmark));
+
+ULyraNumberPopComponent_InstancedMeshText::ULyraNumberPopComponent_InstancedMeshText(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	PopLifespan = 1.f;
+	DistanceFromCameraBeforeDoublingSize = 1024.f;
+	CriticalHitSizeMultiplier = 1.7f;
+	MaxDigits = 7;
+	MaxLivePopsPerStyle = 512;
+	MinCompactInterval = 0.1f;
+}
+
+void ULyraNumberPopComponent_InstancedMeshText::AddNumberPop(const FLyraNumberPopRequest& NewRequest)
+{
+	// Drop requests for remote players on the floor
+	// (this prevents multiple pops from showing up for the host of a listen server)
+	APlayerController* PC = GetController<APlayerController>();
+	if ((PC != nullptr) && !PC->IsLocalController())
+	{
+		return;
+	}
+
+	UStaticMesh* MeshToUse = DetermineStaticMesh(NewRequest);
+	if (MeshToUse == nullptr)
+	{
+		return;
+	}
+
+	UWorld* LocalWorld = GetWorld();
+	check(LocalWorld);
+
+	FLyraInstancedNumberPopList& PopList = FindOrCreatePopList(MeshToUse);
+
+	// Drop the oldest pop rather than growing without bound (it's an instance removal, not a component)
+	if ((MaxLivePopsPerStyle > 0) && (PopList.Pops.Num() >= MaxLivePopsPerStyle))
+	{
+		PopList.Pops.RemoveAt(0);
+		PopList.Component->RemoveInstance(0);
+	}
+
+	// Determine the position
+	FTransform CameraTransform;
+	FVector NumberLocation(NewRequest.WorldLocation);
+	if (PC != nullptr)
+	{
+		if (APlayerCameraManager* PlayerCameraManager = PC->PlayerCameraManager)
+		{
+			CameraTransform = FTransform(PlayerCameraManager->GetCameraRotation(), PlayerCameraManager->GetCameraLocation());
+
+			const float RandomMagnitude = 5.0f; //@TODO: Make this style driven
+			NumberLocation += FMath::RandPointInBox(FBox(FVector(-RandomMagnitude), FVector(RandomMagnitude)));
+		}
+	}
+
+	// Clamp to what the digits (and the float custom data) can represent, showing all 9s like the mesh text pops
+	const int32 ClampedMaxDigits = FMath::Clamp(MaxDigits, 1, 7);
+	const int32 MaxNumber = static_cast<int32>(FMath::Pow(10.0f, static_cast<float>(ClampedMaxDigits))) - 1;
+	const int32 Number = FMath::Clamp(NewRequest.NumberToDisplay, 0, MaxNumber);
+
+	int32 NumDigits = 1;
+	for (int32 Remaining = Number / 10; Remaining > 0; Remaining /= 10)
+	{
+		++NumDigits;
+	}
+
+	const float DistanceFromCameraToNumber = (CameraTransform.GetLocation() - NumberLocation).Size();
+	const float DistanceScale = (DistanceFromCameraBeforeDoublingSize == 0.f) ? 1.f : FMath::Max(DistanceFromCameraToNumber / DistanceFromCameraBeforeDoublingSize, 1.f);
+	const float HitSizeMultiplier = NewRequest.bIsCriticalDamage ? CriticalHitSizeMultiplier : 1.f;
+	const FLinearColor Color = DetermineColor(NewRequest);
+
+	FLyraInstancedNumberPop& NewPop = PopList.Pops.AddDefaulted_GetRef();
+	NewPop.Transform = FTransform(CameraTransform.GetRotation(), NumberLocation);
+	const float CurrentTime = LocalWorld->GetTimeSeconds();
+	NewPop.ReleaseTime = CurrentTime + PopLifespan;
+	NewPop.CustomData[LyraNumberPopCustomData::Number] = static_cast<float>(Number);
+	NewPop.CustomData[LyraNumberPopCustomData::NumDigits] = static_cast<float>(NumDigits);
+	NewPop.CustomData[LyraNumberPopCustomData::ColorR] = Color.R;
+	NewPop.CustomData[LyraNumberPopCustomData::ColorG] = Color.G;
+	NewPop.CustomData[LyraNumberPopCustomData::ColorB] = Color.B;
+	NewPop.CustomData[LyraNumberPopCustomData::Scale] = DistanceScale * HitSizeMultiplier;
+	NewPop.CustomData[LyraNumberPopCustomData::SpawnTime] = CurrentTime;
+	NewPop.CustomData[LyraNumberPopCustomData::Lifespan] = PopLifespan;
+	NewPop.CustomData[LyraNumberPopCustomData::IsCriticalHit] = NewRequest.bIsCriticalDamage ? 1.f : 0.f;
+	NewPop.CustomData[LyraNumberPopCustomData::RandomSeed] = FMath::FRand();
+
+	const int32 InstanceIndex = PopList.Component->AddInstance(NewPop.Transform, /*bWorldSpace=*/ true);
+	PopList.Component->SetCustomData(InstanceIndex, MakeArrayView(NewPop.CustomData), /*bMarkRenderStateDirty=*/ true);
+
+	// Start the timer if it wasn't already running, or pull it in if this pop has a shorter lifespan than the ones it was set for
+	FTimerManager& TimerManager = LocalWorld->GetTimerManager();
+	const float CompactDelay = FMath::Max(PopLifespan, MinCompactInterval);
+	if (!TimerManager.IsTimerActive(CompactTimerHandle) || (TimerManager.GetTimerRemaining(CompactTimerHandle) > CompactDelay))
+	{
+		TimerManager.SetTimer(CompactTimerHandle, this, &ThisClass::HandleCompactTimer, CompactDelay);
+	}
+}
+
+int32 ULyraNumberPopComponent_InstancedMeshText::GetNumLivePops() const
+{
+	int32 NumLivePops = 0;
+	for (const auto& KVP : PopLists)
+	{
+		NumLivePops += KVP.Value.Pops.Num();
+	}
+	return NumLivePops;
+}
+
+FLyraInstancedNumberPopList& ULyraNumberPopComponent_InstancedMeshText::FindOrCreatePopList(UStaticMesh* Mesh)
+{
+	FLyraInstancedNumberPopList& PopList = PopLists.FindOrAdd(Mesh);
+	if (PopList.Component == nullptr)
+	{
+		UInstancedStaticMeshComponent* NewComponent = NewObject<UInstancedStaticMeshComponent>(GetOwner());
+		NewComponent->SetupAttachment(nullptr);
+		NewComponent->SetMobility(EComponentMobility::Movable);
+		NewComponent->SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+		NewComponent->SetStaticMesh(Mesh);
+		NewComponent->NumCustomDataFloats = LyraNumberPopCustomData::Count;
+
+		// Used to allow post-processes to opt out of affecting the number pop digits
+		NewComponent->SetRenderCustomDepth(true);
+		NewComponent->SetCustomDepthStencilValue(123);
+
+		// The digits travel a great distance from their original bounds due to
+		// world position offset (WPO) animation in the material, so expand bounds
+		NewComponent->SetBoundsScale(2000.0f);
+
+		NewComponent->RegisterComponent();
+
+		PopList.Component = NewComponent;
+	}
+
+	return PopList;
+}
+
+void ULyraNumberPopComponent_InstancedMeshText::HandleCompactTimer()
+{
+	UWorld* LocalWorld = GetWorld();
+	check(LocalWorld);
+
+	const float CurrentTime = LocalWorld->GetTimeSeconds();
+	CompactPops(CurrentTime);
+
+	// Schedule the next pass for when the next remaining pop expires, but not sooner than the minimum interval
+	float NextReleaseTime = TNumericLimits<float>::Max();
+	for (const auto& KVP : PopLists)
+	{
+		for (const FLyraInstancedNumberPop& Pop : KVP.Value.Pops)
+		{
+			NextReleaseTime = FMath::Min(NextReleaseTime, Pop.ReleaseTime);
+		}
+	}
+
+	if (NextReleaseTime < TNumericLimits<float>::Max())
+	{
+		const float TimeUntilNextRelease = FMath::Max(NextReleaseTime - CurrentTime, MinCompactInterval);
+		LocalWorld->GetTimerManager().SetTimer(CompactTimerHandle, this, &ThisClass::HandleCompactTimer, TimeUntilNextRelease);
+	}
+}
+
+void ULyraNumberPopComponent_InstancedMeshText::CompactPops(float CurrentTime)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_LyraNumberPop_CompactPops);
+
+	for (auto& KVP : PopLists)
+	{
+		FLyraInstancedNumberPopList& PopList = KVP.Value;
+
+		if (PopList.Component == nullptr)
+		{
+			continue;
+		}
+
+		// PopLifespan can change at runtime, so pops don't necessarily expire in the order they were added
+		const int32 NumExpired = PopList.Pops.RemoveAll([CurrentTime](const FLyraInstancedNumberPop& Pop) { return CurrentTime >= Pop.ReleaseTime; });
+		if (NumExpired == 0)
+		{
+			continue;
+		}
+
+		// Rebuild the remaining instances in one go rather than removing the expired ones one at a time
+		UInstancedStaticMeshComponent* Component = PopList.Component;
+		Component->ClearInstances();
+
+		if (PopList.Pops.Num() > 0)
+		{
+			TArray<FTransform> Transforms;
+			Transforms.Reserve(PopList.Pops.Num());
+			for (const FLyraInstancedNumberPop& Pop : PopList.Pops)
+			{
+				Transforms.Add(Pop.Transform);
+			}
+
+			Component->AddInstances(Transforms, /*bShouldReturnIndices=*/ false, /*bWorldSpace=*/ true);
+
+			for (int32 PopIndex = 0; PopIndex < PopList.Pops.Num(); ++PopIndex)
+			{
+				Component->SetCustomData(PopIndex, MakeArrayView(PopList.Pops[PopIndex].CustomData), /*bMarkRenderStateDirty=*/ false);
+			}
+
+			Component->MarkRenderStateDirty();
+		}
+	}
+}
+
+FLinearColor ULyraNumberPopComponent_InstancedMeshText::DetermineColor(const FLyraNumberPopRequest& Request) const
+{
+	for (ULyraDamagePopStyle* Style : Styles)
+	{
+		if ((Style != nullptr) && Style->bOverrideColor)
+		{
+			if (Style->MatchPattern.Matches(Request.TargetTags))
+			{
+				return Request.bIsCriticalDamage ? Style->CriticalColor : Style->Color;
+			}
+		}
+	}
+
+	return FLinearColor::White;
+}
+
+UStaticMesh* ULyraNumberPopComponent_InstancedMeshText::DetermineStaticMesh(const FLyraNumberPopRequest& Request) const
+{
+	for (ULyraDamagePopStyle* Style : Styles)
+	{
+		if ((Style != nullptr) && Style->bOverrideMesh)
+		{
+			if (Style->MatchPattern.Matches(Request.TargetTags))
+			{
+				return Style->TextMesh;
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+void ULyraNumberPopComponent_InstancedMeshText::RunBenchmark(const TArray<FString>& Args, UWorld* World)
+{
+	if (World == nullptr)
+	{
+		return;
+	}
+
+	const int32 NumPops = FMath::Max((Args.Num() > 0) ? FCString::Atoi(*Args[0]) : 1000, 1);
+
+	int32 NumComponents = 0;
+	for (TActorIterator<APlayerController> It(World); It; ++It)
+	{
+		TArray<ULyraNumberPopComponent_InstancedMeshText*> PopComponents;
+		It->GetComponents(/*out*/ PopComponents);
+
+		for (ULyraNumberPopComponent_InstancedMeshText* PopComponent : PopComponents)
+		{
+			++NumComponents;
+
+			// Requests without target tags only produce pops if a style matches them, the live pop count shows how many did
+			FLyraNumberPopRequest Request;
+
+			const FVector Origin = (It->GetPawn() != nullptr) ? It->GetPawn()->GetActorLocation() : FVector::ZeroVector;
+			const int32 NumPopsBefore = PopComponent->GetNumLivePops();
+
+			const double AddStartTime = FPlatformTime::Seconds();
+			for (int32 PopIndex = 0; PopIndex < NumPops; ++PopIndex)
+			{
+				Request.WorldLocation = Origin + FMath::VRand() * 500.0;
+				Request.NumberToDisplay = FMath::RandRange(1, 250);
+				Request.bIsCriticalDamage = (PopIndex % 8) == 0;
+				PopComponent->AddNumberPop(Request);
+			}
+			const double AddSeconds = FPlatformTime::Seconds() - AddStartTime;
+
+			const int32 NumPopsAdded = PopComponent->GetNumLivePops() - NumPopsBefore;
+
+			// Expire everything to time a full compaction pass
+			const double CompactStartTime = FPlatformTime::Seconds();
+			PopComponent->CompactPops(TNumericLimits<float>::Max());
+			const double CompactSeconds = FPlatformTime::Seconds() - CompactStartTime;
+
+			UE_LOG(LogLyra, Log, TEXT("Number pop benchmark on %s: %d requests (%d live pops) in %.2f ms, %.2f us per pop. Compaction took %.2f ms"),
+				*GetNameSafe(PopComponent),
+				NumPops,
+				NumPopsAdded,
+				AddSeconds * 1000.0,
+				(AddSeconds * 1000000.0) / NumPops,
+				CompactSeconds * 1000.0);
+		}
+	}
+
+	if (NumComponents == 0)
+	{
+		UE_LOG(LogLyra, Warning, TEXT("Number pop benchmark: no player controllers with a ULyraNumberPopComponent_InstancedMeshText in %s"), *GetNameSafe(World));
+	}
+}
@@ -0,0 +1,128 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "LyraNumberPopComponent.h"
+
+#include "LyraNumberPopComponent_InstancedMeshText.generated.h"
+
+class UInstancedStaticMeshComponent;
+class ULyraDamagePopStyle;
+class UObject;
+class UStaticMesh;
+class UWorld;
+
+// Per instance custom data written for every number pop, the text material reads these with PerInstanceCustomData
+namespace LyraNumberPopCustomData
+{
+	enum Type : int32
+	{
+		// The number to display, the material splits it into digits
+		Number,
+		NumDigits,
+		ColorR,
+		ColorG,
+		ColorB,
+		// Font scale, including the distance and critical hit multipliers
+		Scale,
+		// World time in seconds when the pop was spawned (the material's Time node uses the same clock), the age is Time - SpawnTime
+		SpawnTime,
+		// Lifespan of this pop, stored per instance since PopLifespan can change while pops are live
+		Lifespan,
+		IsCriticalHit,
+		// Random value in [0, 1] for varying the animation
+		RandomSeed,
+
+		Count
+	};
+}
+
+/** A live number pop, mirrored on the CPU so expired instances can be compacted out in one pass */
+struct FLyraInstancedNumberPop
+{
+	FTransform Transform;
+	float ReleaseTime = 0.0f;
+	float CustomData[LyraNumberPopCustomData::Count] = {};
+};
+
+USTRUCT()
+struct FLyraInstancedNumberPopList
+{
+	GENERATED_BODY()
+
+	/** Draws every pop using this mesh, one instance per pop */
+	UPROPERTY(transient)
+	TObjectPtr<UInstancedStaticMeshComponent> Component = nullptr;
+
+	/** The live pops in spawn order, matching the instance order in the component */
+	TArray<FLyraInstancedNumberPop> Pops;
+};
+
+/**
+ * Number pops drawn with one instanced static mesh per style mesh
+ *
+ * Spawning a pop appends one instance with its digits, color, scale and spawn time in the per instance
+ * custom data (see LyraNumberPopCustomData), so the style's text mesh needs a material that builds the
+ * digits from that data instead of the per digit parameters used by ULyraNumberPopComponent_MeshText.
+ * Expired pops are removed by periodically compacting the instances.
+ */
+UCLASS(Blueprintable)
+class ULyraNumberPopComponent_InstancedMeshText : public ULyraNumberPopComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	ULyraNumberPopComponent_InstancedMeshText(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	//~ULyraNumberPopComponent interface
+	virtual void AddNumberPop(const FLyraNumberPopRequest& NewRequest) override;
+	//~End of ULyraNumberPopComponent interface
+
+	// Returns the number of pops currently being drawn
+	int32 GetNumLivePops() const;
+
+	// Adds pops to every instanced number pop component in the world and logs the cost per pop
+	static void RunBenchmark(const TArray<FString>& Args, UWorld* World);
+
+protected:
+	FLinearColor DetermineColor(const FLyraNumberPopRequest& Request) const;
+	UStaticMesh* DetermineStaticMesh(const FLyraNumberPopRequest& Request) const;
+
+	FLyraInstancedNumberPopList& FindOrCreatePopList(UStaticMesh* Mesh);
+
+	/** Removes the pops that have exceeded their lifespan at CurrentTime, rebuilding the instances of any list that changed */
+	void CompactPops(float CurrentTime);
+
+	void HandleCompactTimer();
+
+	/** Style patterns to attempt to apply to the incoming number pops */
+	UPROPERTY(EditDefaultsOnly, Category="Number Pop|Style")
+	TArray<TObjectPtr<ULyraDamagePopStyle>> Styles;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Number Pop|Style")
+	float PopLifespan;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Number Pop|Style")
+	float DistanceFromCameraBeforeDoublingSize;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Number Pop|Style")
+	float CriticalHitSizeMultiplier;
+
+	/** Numbers with more digits than this show as all 9s */
+	UPROPERTY(EditDefaultsOnly, Category = "Number Pop|Style", meta=(ClampMin=1, ClampMax=7))
+	int32 MaxDigits;
+
+	/** The oldest pops of a style are dropped when it has more than this many live (0 means no limit) */
+	UPROPERTY(EditDefaultsOnly, Category = "Number Pop|Style")
+	int32 MaxLivePopsPerStyle;
+
+	/** Minimum time between compaction passes, expired pops are hidden by the material until then */
+	UPROPERTY(EditDefaultsOnly, Category = "Number Pop|Style")
+	float MinCompactInterval;
+
+	UPROPERTY(Transient)
+	TMap<TObjectPtr<UStaticMesh>, FLyraInstancedNumberPopList> PopLists;
+
+	FTimerHandle CompactTimerHandle;
+};
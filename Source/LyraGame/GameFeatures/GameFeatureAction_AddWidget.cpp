@@ -143,6 +143,10 @@ void UGameFeatureAction_AddWidgets::AddWidgets(AActor* Actor, FPerContextData& A
 	{
 		FPerActorData& ActorData = ActiveData.ActorData.FindOrAdd(HUD);
 
+		// Extension points in the new layouts and the widgets below are matched up in one pass at the end of the scope
+		UUIExtensionSubsystem* ExtensionSubsystem = HUD->GetWorld()->GetSubsystem<UUIExtensionSubsystem>();
+		FUIExtensionNotificationBatch NotificationBatch(ExtensionSubsystem);
+
 		for (const FLyraHUDLayoutRequest& Entry : Layout)
 		{
 			if (TSubclassOf<UCommonActivatableWidget> ConcreteWidgetClass = Entry.LayoutClass.Get())
@@ -151,7 +155,6 @@ void UGameFeatureAction_AddWidgets::AddWidgets(AActor* Actor, FPerContextData& A
 			}
 		}
 
-		UUIExtensionSubsystem* ExtensionSubsystem = HUD->GetWorld()->GetSubsystem<UUIExtensionSubsystem>();
 		for (const FLyraHUDElementEntry& Entry : Widgets)
 		{
 			ActorData.ExtensionHandles.Add(ExtensionSubsystem->RegisterExtensionAsWidgetForContext(Entry.SlotID, LocalPlayer, Entry.WidgetClass.Get(), -1));
@@ -10,9 +10,26 @@
 #include "AIController.h"
 #include "Kismet/GameplayStatics.h"
 #include "Character/LyraHealthComponent.h"
+#include "Character/LyraPawnData.h"
+#include "Engine/StreamableManager.h"
+#include "GameFeaturesSubsystemSettings.h"
+#include "HAL/IConsoleManager.h"
+#include "LyraLogChannels.h"
+#include "System/LyraAssetManager.h"
+#include "TimerManager.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraBotCreationComponent)
 
+namespace LyraBotCreation
+{
+	static float SpawnBudgetMs = 2.0f;
+	static FAutoConsoleVariableRef CVarSpawnBudgetMs(
+		TEXT("Lyra.Bots.SpawnBudgetMs"),
+		SpawnBudgetMs,
+		TEXT("Milliseconds per frame to spend spawning the initial bots (at least one bot is spawned per frame). 0 spawns them all in one frame."),
+		ECVF_Default);
+}
+
 ULyraBotCreationComponent::ULyraBotCreationComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
@@ -29,6 +46,25 @@ void ULyraBotCreationComponent::BeginPlay()
 	ExperienceComponent->CallOrRegister_OnExperienceLoaded_LowPriority(FOnLyraExperienceLoaded::FDelegate::CreateUObject(this, &ThisClass::OnExperienceLoaded));
 }
 
+void ULyraBotCreationComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearAllTimersForObject(this);
+	}
+
+	// Clear this first, cancelling the preload calls back into OnBotAssetsPreloaded
+	NumBotsPendingSpawn = 0;
+
+	if (BotPreloadHandle.IsValid())
+	{
+		BotPreloadHandle->CancelHandle();
+		BotPreloadHandle.Reset();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void ULyraBotCreationComponent::OnExperienceLoaded(const ULyraExperienceDefinition* Experience)
 {
 #if WITH_SERVER_CODE
@@ -70,11 +106,115 @@ void ULyraBotCreationComponent::ServerCreateBots()
 		EffectiveBotCount = UGameplayStatics::GetIntOption(GameModeBase->OptionsString, TEXT("NumBots"), EffectiveBotCount);
 	}
 
-	// Create them
-	for (int32 Count = 0; Count < EffectiveBotCount; ++Count)
+	if (EffectiveBotCount <= 0)
+	{
+		return;
+	}
+
+	NumBotsPendingSpawn = EffectiveBotCount;
+	NumBotCreationFrames = 0;
+	BotCreationStartTime = FPlatformTime::Seconds();
+	TimeToAllBotsReady = -1.0;
+
+	// Load everything the bots need up front so the spawns themselves don't block on loading
+	ULyraAssetManager& AssetManager = ULyraAssetManager::Get();
+
+	TArray<FPrimaryAssetId> BundleAssetList;
+	if (ALyraGameMode* GameMode = GetGameMode<ALyraGameMode>())
+	{
+		if (const ULyraPawnData* PawnData = GameMode->GetPawnDataForController(nullptr))
+		{
+			BundleAssetList.Add(PawnData->GetPrimaryAssetId());
+		}
+	}
+
+	TArray<FName> BundlesToLoad;
+	BundlesToLoad.Add(FLyraBundles::Equipped);
+	BundlesToLoad.Add(UGameFeaturesSubsystemSettings::LoadStateServer);
+	if (GIsEditor || (GetOwner()->GetNetMode() != NM_DedicatedServer))
+	{
+		BundlesToLoad.Add(UGameFeaturesSubsystemSettings::LoadStateClient);
+	}
+
+	TSharedPtr<FStreamableHandle> BundleLoadHandle = nullptr;
+	if (BundleAssetList.Num() > 0)
+	{
+		BundleLoadHandle = AssetManager.ChangeBundleStateForPrimaryAssets(BundleAssetList, BundlesToLoad, {}, false, FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority);
+	}
+
+	TSharedPtr<FStreamableHandle> RawLoadHandle = nullptr;
+	if (AssetsToPreloadForBots.Num() > 0)
+	{
+		RawLoadHandle = AssetManager.LoadAssetList(AssetsToPreloadForBots, FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority, TEXT("ServerCreateBots()"));
+	}
+
+	if (BundleLoadHandle.IsValid() && RawLoadHandle.IsValid())
+	{
+		BotPreloadHandle = AssetManager.GetStreamableManager().CreateCombinedHandle({ BundleLoadHandle, RawLoadHandle });
+	}
+	else
+	{
+		BotPreloadHandle = BundleLoadHandle.IsValid() ? BundleLoadHandle : RawLoadHandle;
+	}
+
+	FStreamableDelegate OnAssetsLoadedDelegate = FStreamableDelegate::CreateUObject(this, &ThisClass::OnBotAssetsPreloaded);
+	if (!BotPreloadHandle.IsValid() || BotPreloadHandle->HasLoadCompleted())
+	{
+		FStreamableHandle::ExecuteDelegate(OnAssetsLoadedDelegate);
+	}
+	else
+	{
+		BotPreloadHandle->BindCompleteDelegate(OnAssetsLoadedDelegate);
+
+		// Spawn anyways if the load gets cancelled, the bots will just load what they need synchronously
+		BotPreloadHandle->BindCancelDelegate(OnAssetsLoadedDelegate);
+	}
+}
+
+void ULyraBotCreationComponent::OnBotAssetsPreloaded()
+{
+	if (NumBotsPendingSpawn <= 0)
+	{
+		return;
+	}
+
+	BotPreloadEndTime = FPlatformTime::Seconds();
+	SpawnPendingBotsWithinBudget();
+}
+
+void ULyraBotCreationComponent::SpawnPendingBotsWithinBudget()
+{
+	const double FrameStartTime = FPlatformTime::Seconds();
+	const double BudgetSeconds = LyraBotCreation::SpawnBudgetMs * 0.001;
+	++NumBotCreationFrames;
+
+	// Always make progress, even if a single spawn is over budget
+	do
 	{
 		SpawnOneBot();
+		--NumBotsPendingSpawn;
 	}
+	while ((NumBotsPendingSpawn > 0) && ((BudgetSeconds <= 0.0) || ((FPlatformTime::Seconds() - FrameStartTime) < BudgetSeconds)));
+
+	if (NumBotsPendingSpawn > 0)
+	{
+		GetWorld()->GetTimerManager().SetTimerForNextTick(this, &ThisClass::SpawnPendingBotsWithinBudget);
+		return;
+	}
+
+	const double EndTime = FPlatformTime::Seconds();
+	TimeToAllBotsReady = EndTime - BotCreationStartTime;
+
+	UE_LOG(LogLyra, Log, TEXT("Bots ready: %d bots in %.1f ms (%.1f ms preloading, %.1f ms spawning over %d frames with a %.1f ms budget)"),
+		SpawnedBotList.Num(),
+		TimeToAllBotsReady * 1000.0,
+		(BotPreloadEndTime - BotCreationStartTime) * 1000.0,
+		(EndTime - BotPreloadEndTime) * 1000.0,
+		NumBotCreationFrames,
+		LyraBotCreation::SpawnBudgetMs);
+
+	// Spawned bots hold their own references now
+	BotPreloadHandle.Reset();
 }
 
 FString ULyraBotCreationComponent::CreateBotName(int32 PlayerIndex)
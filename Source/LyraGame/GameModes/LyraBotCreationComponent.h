@@ -9,6 +9,7 @@
 class ULyraExperienceDefinition;
 class ULyraPawnData;
 class AAIController;
+struct FStreamableHandle;
 
 UCLASS(Blueprintable, Abstract)
 class ULyraBotCreationComponent : public UGameStateComponent
@@ -20,8 +21,15 @@ public:
 
 	//~UActorComponent interface
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	//~End of UActorComponent interface
 
+	// Returns true while the initial set of bots is still being preloaded or spawned
+	bool IsCreatingBots() const { return NumBotsPendingSpawn > 0; }
+
+	// Returns how long it took from the experience loading to the last initial bot being spawned, or a negative value if that hasn't happened yet
+	double GetTimeToAllBotsReady() const { return TimeToAllBotsReady; }
+
 private:
 	void OnExperienceLoaded(const ULyraExperienceDefinition* Experience);
 
@@ -35,6 +43,10 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category=Gameplay)
 	TArray<FString> RandomBotNames;
 
+	// Additional assets the bots will need (e.g., cosmetic parts chosen at runtime), loaded asynchronously before any bot is spawned
+	UPROPERTY(EditDefaultsOnly, Category=Gameplay)
+	TArray<FSoftObjectPath> AssetsToPreloadForBots;
+
 	TArray<FString> RemainingBotNames;
 
 protected:
@@ -49,9 +61,25 @@ public:
 protected:
 	virtual void ServerCreateBots();
 
+	// Called when the pawn data and preloaded assets are ready, starts spawning the pending bots
+	void OnBotAssetsPreloaded();
+
+	// Spawns pending bots until the per frame budget is used up, then continues next frame
+	void SpawnPendingBotsWithinBudget();
+
 	virtual void SpawnOneBot();
 	virtual void RemoveOneBot();
 
 	FString CreateBotName(int32 PlayerIndex);
 #endif
+
+private:
+	// Keeps the bot pawn data and preloaded assets in memory while bots are being created
+	TSharedPtr<FStreamableHandle> BotPreloadHandle;
+
+	int32 NumBotsPendingSpawn = 0;
+	int32 NumBotCreationFrames = 0;
+	double BotCreationStartTime = 0.0;
+	double BotPreloadEndTime = 0.0;
+	double TimeToAllBotsReady = -1.0;
 };
@@ -13,6 +13,8 @@
 #include "TimerManager.h"
 #include "Settings/LyraSettingsLocal.h"
 #include "LyraLogChannels.h"
+#include "AbilitySystem/LyraGameplayCueManager.h"
+#include "Misc/Paths.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraExperienceManagerComponent)
 
@@ -45,6 +47,42 @@ namespace LyraConsoleVariables
 	{
 		return FMath::Max(0.0f, ExperienceLoadRandomDelayMin + FMath::FRand() * ExperienceLoadRandomDelayRange);
 	}
+
+	static bool bOverlapGameFeatureLoading = true;
+	static FAutoConsoleVariableRef CVarOverlapGameFeatureLoading(
+		TEXT("Lyra.Experience.OverlapGameFeatureLoading"),
+		bOverlapGameFeatureLoading,
+		TEXT("If true, game feature plugins that are already registered are loaded and activated while the experience asset bundles stream in, instead of afterwards"),
+		ECVF_Default);
+}
+
+FString FLyraExperienceLoadTimeline::ToString() const
+{
+	auto PhaseToString = [](const TCHAR* Name, double Start, double End)
+	{
+		if (Start < 0.0)
+		{
+			return FString::Printf(TEXT("%s skipped"), Name);
+		}
+		else if (End < 0.0)
+		{
+			return FString::Printf(TEXT("%s started at %.3fs"), Name, Start);
+		}
+		return FString::Printf(TEXT("%s %.3fs-%.3fs (%.3fs)"), Name, Start, End, End - Start);
+	};
+
+	FString Result = FString::Printf(TEXT("%s, %s, %s%s"),
+		*PhaseToString(TEXT("bundles"), BundleLoadStart, BundleLoadEnd),
+		*PhaseToString(TEXT("game features"), GameFeaturesStart, GameFeaturesEnd),
+		*PhaseToString(TEXT("actions"), ActionsStart, ActionsEnd),
+		bOverlappedGameFeatures ? TEXT(" [overlapped]") : TEXT(""));
+
+	for (const TPair<FString, double>& Completion : GameFeatureCompletionTimes)
+	{
+		Result += FString::Printf(TEXT("\n\t%s ready at %.3fs"), *FPaths::GetBaseFilename(Completion.Key), Completion.Value);
+	}
+
+	return Result;
 }
 
 ULyraExperienceManagerComponent::ULyraExperienceManagerComponent(const FObjectInitializer& ObjectInitializer)
@@ -130,6 +168,30 @@ void ULyraExperienceManagerComponent::StartExperienceLoad()
 		*GetClientServerContextString(this));
 
 	LoadState = ELyraExperienceLoadState::Loading;
+	bExperienceAssetsLoaded = false;
+
+	LoadTimeline = FLyraExperienceLoadTimeline();
+	LoadTimeline.LoadStartTime = FPlatformTime::Seconds();
+
+	// The plugin list is known up front, so registered plugins (already mounted, nothing in the bundles can depend
+	// on them finishing) can be loaded and activated while the bundles stream in
+	CollectGameFeaturePluginURLs();
+
+	bool bCanOverlapGameFeatures = LyraConsoleVariables::bOverlapGameFeatureLoading && (GameFeaturePluginURLs.Num() > 0);
+	for (const FString& PluginURL : GameFeaturePluginURLs)
+	{
+		if (bCanOverlapGameFeatures && !UGameFeaturesSubsystem::Get().IsGameFeaturePluginRegistered(PluginURL))
+		{
+			UE_LOG(LogLyraExperience, Verbose, TEXT("EXPERIENCE: Not overlapping game feature loading, %s is not registered yet"), *PluginURL);
+			bCanOverlapGameFeatures = false;
+		}
+	}
+
+	if (bCanOverlapGameFeatures)
+	{
+		LoadTimeline.bOverlappedGameFeatures = true;
+		StartLoadingGameFeaturePlugins();
+	}
 
 	ULyraAssetManager& AssetManager = ULyraAssetManager::Get();
 
@@ -186,6 +248,8 @@ void ULyraExperienceManagerComponent::StartExperienceLoad()
 		Handle = BundleLoadHandle.IsValid() ? BundleLoadHandle : RawLoadHandle;
 	}
 
+	LoadTimeline.BundleLoadStart = LoadTimeline.Now();
+
 	FStreamableDelegate OnAssetsLoadedDelegate = FStreamableDelegate::CreateUObject(this, &ThisClass::OnExperienceLoadComplete);
 	if (!Handle.IsValid() || Handle->HasLoadCompleted())
 	{
@@ -220,6 +284,42 @@ void ULyraExperienceManagerComponent::OnExperienceLoadComplete()
 		*CurrentExperience->GetPrimaryAssetId().ToString(),
 		*GetClientServerContextString(this));
 
+	bExperienceAssetsLoaded = true;
+	LoadTimeline.BundleLoadEnd = LoadTimeline.Now();
+
+	// Start streaming in the cues this experience is likely to fire while the rest of the experience loads
+	if (ULyraGameplayCueManager* CueManager = ULyraGameplayCueManager::Get())
+	{
+		CueManager->PreloadCuesForExperience(CurrentExperience);
+	}
+
+	if (LoadTimeline.bOverlappedGameFeatures)
+	{
+		// The features were started with the bundles, we're done once they are
+		if (NumGameFeaturePluginsLoading == 0)
+		{
+			OnExperienceFullLoadCompleted();
+		}
+		else
+		{
+			LoadState = ELyraExperienceLoadState::LoadingGameFeatures;
+		}
+		return;
+	}
+
+	// Load and activate the features
+	if (GameFeaturePluginURLs.Num() > 0)
+	{
+		StartLoadingGameFeaturePlugins();
+	}
+	else
+	{
+		OnExperienceFullLoadCompleted();
+	}
+}
+
+void ULyraExperienceManagerComponent::CollectGameFeaturePluginURLs()
+{
 	// find the URLs for our GameFeaturePlugins - filtering out dupes and ones that don't have a valid mapping
 	GameFeaturePluginURLs.Reset();
 
@@ -234,7 +334,7 @@ void ULyraExperienceManagerComponent::OnExperienceLoadComplete()
 			}
 			else
 			{
-				ensureMsgf(false, TEXT("OnExperienceLoadComplete failed to find plugin URL from PluginName %s for experience %s - fix data, ignoring for this run"), *PluginName, *Context->GetPrimaryAssetId().ToString());
+				ensureMsgf(false, TEXT("CollectGameFeaturePluginURLs failed to find plugin URL from PluginName %s for experience %s - fix data, ignoring for this run"), *PluginName, *Context->GetPrimaryAssetId().ToString());
 			}
 		}
 
@@ -257,32 +357,42 @@ void ULyraExperienceManagerComponent::OnExperienceLoadComplete()
 			CollectGameFeaturePluginURLs(ActionSet, ActionSet->GameFeaturesToEnable);
 		}
 	}
+}
 
-	// Load and activate the features	
+void ULyraExperienceManagerComponent::StartLoadingGameFeaturePlugins()
+{
 	NumGameFeaturePluginsLoading = GameFeaturePluginURLs.Num();
-	if (NumGameFeaturePluginsLoading > 0)
+	LoadTimeline.GameFeaturesStart = LoadTimeline.Now();
+
+	// Only switch states if the bundles are done, otherwise we're still in the Loading state
+	if (bExperienceAssetsLoaded)
 	{
 		LoadState = ELyraExperienceLoadState::LoadingGameFeatures;
-		for (const FString& PluginURL : GameFeaturePluginURLs)
-		{
-			ULyraExperienceManager::NotifyOfPluginActivation(PluginURL);
-			UGameFeaturesSubsystem::Get().LoadAndActivateGameFeaturePlugin(PluginURL, FGameFeaturePluginLoadComplete::CreateUObject(this, &ThisClass::OnGameFeaturePluginLoadComplete));
-		}
 	}
-	else
+
+	for (const FString& PluginURL : GameFeaturePluginURLs)
 	{
-		OnExperienceFullLoadCompleted();
+		ULyraExperienceManager::NotifyOfPluginActivation(PluginURL);
+		UGameFeaturesSubsystem::Get().LoadAndActivateGameFeaturePlugin(PluginURL, FGameFeaturePluginLoadComplete::CreateUObject(this, &ThisClass::OnGameFeaturePluginLoadComplete, PluginURL));
 	}
 }
 
-void ULyraExperienceManagerComponent::OnGameFeaturePluginLoadComplete(const UE::GameFeatures::FResult& Result)
+void ULyraExperienceManagerComponent::OnGameFeaturePluginLoadComplete(const UE::GameFeatures::FResult& Result, FString PluginURL)
 {
+	LoadTimeline.GameFeatureCompletionTimes.Emplace(MoveTemp(PluginURL), LoadTimeline.Now());
+
 	// decrement the number of plugins that are loading
 	NumGameFeaturePluginsLoading--;
 
 	if (NumGameFeaturePluginsLoading == 0)
 	{
-		OnExperienceFullLoadCompleted();
+		LoadTimeline.GameFeaturesEnd = LoadTimeline.Now();
+
+		// When overlapping, the bundles may still be streaming
+		if (bExperienceAssetsLoaded)
+		{
+			OnExperienceFullLoadCompleted();
+		}
 	}
 }
 
@@ -306,6 +416,7 @@ void ULyraExperienceManagerComponent::OnExperienceFullLoadCompleted()
 	}
 
 	LoadState = ELyraExperienceLoadState::ExecutingActions;
+	LoadTimeline.ActionsStart = LoadTimeline.Now();
 
 	// Execute the actions
 	FGameFeatureActivatingContext Context;
@@ -343,6 +454,16 @@ void ULyraExperienceManagerComponent::OnExperienceFullLoadCompleted()
 	}
 
 	LoadState = ELyraExperienceLoadState::Loaded;
+	LoadTimeline.ActionsEnd = LoadTimeline.Now();
+
+	UE_LOG(LogLyraExperience, Log, TEXT("EXPERIENCE: %s loaded in %.3fs (%s): %s"),
+		*CurrentExperience->GetPrimaryAssetId().ToString(),
+		LoadTimeline.ActionsEnd,
+		*GetClientServerContextString(this),
+		*LoadTimeline.ToString());
+
+	// Anything synchronously loaded from here on is a gameplay hitch
+	ULyraAssetManager::Get().SetSyncLoadAuditActive(true);
 
 	OnExperienceLoaded_HighPriority.Broadcast(CurrentExperience);
 	OnExperienceLoaded_HighPriority.Clear();
@@ -353,6 +474,14 @@ void ULyraExperienceManagerComponent::OnExperienceFullLoadCompleted()
 	OnExperienceLoaded_LowPriority.Broadcast(CurrentExperience);
 	OnExperienceLoaded_LowPriority.Clear();
 
+	// Report how long a dedicated server took to become ready for players (e.g., when booted with -nullrhi for fleet autoscaling measurements)
+	static bool bHasReportedBootToReady = false;
+	if (!bHasReportedBootToReady && IsRunningDedicatedServer())
+	{
+		bHasReportedBootToReady = true;
+		UE_LOG(LogLyraExperience, Display, TEXT("EXPERIENCE: Server boot-to-ready took %.2f seconds"), FPlatformTime::Seconds() - GStartTime);
+	}
+
 	// Apply any necessary scalability settings
 #if !UE_SERVER
 	ULyraSettingsLocal::Get()->OnExperienceLoaded();
@@ -394,6 +523,8 @@ void ULyraExperienceManagerComponent::EndPlay(const EEndPlayReason::Type EndPlay
 	//@TODO: Ensure proper handling of a partially-loaded state too
 	if (LoadState == ELyraExperienceLoadState::Loaded)
 	{
+		ULyraAssetManager::Get().SetSyncLoadAuditActive(false);
+
 		LoadState = ELyraExperienceLoadState::Deactivating;
 
 		// Make sure we won't complete the transition prematurely if someone registers as a pauser but fires immediately
@@ -448,7 +579,26 @@ bool ULyraExperienceManagerComponent::ShouldShowLoadingScreen(FString& OutReason
 {
 	if (LoadState != ELyraExperienceLoadState::Loaded)
 	{
-		OutReason = TEXT("Experience still loading");
+		switch (LoadState)
+		{
+		case ELyraExperienceLoadState::Loading:
+			OutReason = FString::Printf(TEXT("Experience still loading: asset bundles (%.1fs)"), LoadTimeline.Now());
+			break;
+		case ELyraExperienceLoadState::LoadingGameFeatures:
+			OutReason = FString::Printf(TEXT("Experience still loading: game features %d/%d (%.1fs)"), GameFeaturePluginURLs.Num() - NumGameFeaturePluginsLoading, GameFeaturePluginURLs.Num(), LoadTimeline.Now());
+			break;
+		case ELyraExperienceLoadState::ExecutingActions:
+			OutReason = FString::Printf(TEXT("Experience still loading: activating actions (%.1fs)"), LoadTimeline.Now());
+			break;
+		default:
+			OutReason = TEXT("Experience still loading");
+			break;
+		}
+		return true;
+	}
+	else if (const ULyraGameplayCueManager* CueManager = ULyraGameplayCueManager::Get(); CueManager && CueManager->IsCriticalCuePreloadPending())
+	{
+		OutReason = TEXT("Experience gameplay cues still loading");
 		return true;
 	}
 	else
@@ -24,6 +24,30 @@ enum class ELyraExperienceLoadState
 	Deactivating
 };
 
+// When each phase of an experience load started and finished, for profiling time to playable
+struct FLyraExperienceLoadTimeline
+{
+	// FPlatformTime::Seconds() when the load started, the other times are relative to this
+	double LoadStartTime = 0.0;
+
+	double BundleLoadStart = -1.0;
+	double BundleLoadEnd = -1.0;
+	double GameFeaturesStart = -1.0;
+	double GameFeaturesEnd = -1.0;
+	double ActionsStart = -1.0;
+	double ActionsEnd = -1.0;
+
+	// When each game feature plugin finished loading and activating
+	TArray<TPair<FString, double>> GameFeatureCompletionTimes;
+
+	// Whether the game features were loaded alongside the asset bundles rather than after them
+	bool bOverlappedGameFeatures = false;
+
+	double Now() const { return FPlatformTime::Seconds() - LoadStartTime; }
+
+	FString ToString() const;
+};
+
 UCLASS()
 class ULyraExperienceManagerComponent final : public UGameStateComponent, public ILoadingProcessInterface
 {
@@ -64,13 +88,18 @@ public:
 	// Returns true if the experience is fully loaded
 	bool IsExperienceLoaded() const;
 
+	// Returns the phase timings of the current (or last) experience load
+	const FLyraExperienceLoadTimeline& GetLoadTimeline() const { return LoadTimeline; }
+
 private:
 	UFUNCTION()
 	void OnRep_CurrentExperience();
 
 	void StartExperienceLoad();
 	void OnExperienceLoadComplete();
-	void OnGameFeaturePluginLoadComplete(const UE::GameFeatures::FResult& Result);
+	void CollectGameFeaturePluginURLs();
+	void StartLoadingGameFeaturePlugins();
+	void OnGameFeaturePluginLoadComplete(const UE::GameFeatures::FResult& Result, FString PluginURL);
 	void OnExperienceFullLoadCompleted();
 
 	void OnActionDeactivationCompleted();
@@ -85,6 +114,11 @@ private:
 	int32 NumGameFeaturePluginsLoading = 0;
 	TArray<FString> GameFeaturePluginURLs;
 
+	// True once the asset bundles for the experience have finished loading
+	bool bExperienceAssetsLoaded = false;
+
+	FLyraExperienceLoadTimeline LoadTimeline;
+
 	int32 NumObservedPausers = 0;
 	int32 NumExpectedPausers = 0;
 
@@ -0,0 +1,367 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "LyraInteractionScanSubsystem.h"
+
+#include "Components/PrimitiveComponent.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Interaction/IInteractableTarget.h"
+#include "Interaction/InteractionStatics.h"
+#include "Physics/LyraCollisionChannels.h"
+#include "TimerManager.h"
+#include "UObject/ScriptInterface.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(LyraInteractionScanSubsystem)
+
+DECLARE_CYCLE_STAT(TEXT("Interaction Scan Query"), STAT_LyraInteractionScan_Query, STATGROUP_Game);
+
+namespace LyraInteractionScanCVars
+{
+	// Off until the registry also covers interactable components added long after their actor spawned
+	static bool bUseInteractionScanSubsystem = false;
+	static FAutoConsoleVariableRef CVarUseInteractionScanSubsystem(
+		TEXT("Lyra.Interaction.UseScanSubsystem"),
+		bUseInteractionScanSubsystem,
+		TEXT("If true, interaction tasks find nearby interactables in the interaction scan subsystem's registry instead of running their own scene queries (takes effect for worlds created afterwards)."),
+		ECVF_Default);
+
+	static float CellSize = 1000.0f;
+	static FAutoConsoleVariableRef CVarCellSize(
+		TEXT("Lyra.Interaction.ScanCellSize"),
+		CellSize,
+		TEXT("Size (in cm) of the grid cells interactables are bucketed in (takes effect for worlds created afterwards)."),
+		ECVF_Default);
+}
+
+// Returns true if an overlap on the interaction channel could find this actor
+static bool RespondsToInteractionChannel(const AActor& Actor)
+{
+	if (!Actor.GetActorEnableCollision())
+	{
+		return false;
+	}
+
+	bool bResponds = false;
+	Actor.ForEachComponent<UPrimitiveComponent>(/*bIncludeFromChildActors=*/ false, [&bResponds](const UPrimitiveComponent* Primitive)
+	{
+		if (!bResponds && Primitive->IsQueryCollisionEnabled() && (Primitive->GetCollisionResponseToChannel(Lyra_TraceChannel_Interaction) != ECR_Ignore))
+		{
+			bResponds = true;
+		}
+	});
+
+	return bResponds;
+}
+
+//////////////////////////////////////////////////////////////////////
+// ULyraInteractionScanSubsystem
+
+bool ULyraInteractionScanSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// Registering actors costs something on every spawn and move, so don't do it unless the registry will be queried
+	return Super::ShouldCreateSubsystem(Outer) && IsEnabled();
+}
+
+void ULyraInteractionScanSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	CellSize = FMath::Max(LyraInteractionScanCVars::CellSize, 100.0f);
+
+	UWorld* World = GetWorld();
+	ActorSpawnedHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &ThisClass::HandleActorSpawned));
+	ActorDestroyedHandle = World->AddOnActorDestroyedHandler(FOnActorDestroyed::FDelegate::CreateUObject(this, &ThisClass::HandleActorDestroyed));
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &ThisClass::HandleLevelAddedToWorld);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &ThisClass::HandleLevelRemovedFromWorld);
+}
+
+void ULyraInteractionScanSubsystem::Deinitialize()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+		World->RemoveOnActorDestroyededHandler(ActorDestroyedHandle);
+	}
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+
+	PendingRecheckActors.Reset();
+
+	for (TPair<TObjectKey<AActor>, FEntry>& Pair : Entries)
+	{
+		if (USceneComponent* Root = Pair.Value.WatchedRoot.Get())
+		{
+			Root->TransformUpdated.Remove(Pair.Value.TransformUpdatedHandle);
+		}
+	}
+
+	Entries.Reset();
+	Cells.Reset();
+
+	Super::Deinitialize();
+}
+
+void ULyraInteractionScanSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Pick up everything that was loaded with the map, new actors are added as they spawn
+	for (ULevel* Level : InWorld.GetLevels())
+	{
+		RegisterLevelActors(Level);
+	}
+}
+
+ULyraInteractionScanSubsystem* ULyraInteractionScanSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<ULyraInteractionScanSubsystem>() : nullptr;
+}
+
+bool ULyraInteractionScanSubsystem::IsEnabled()
+{
+	return LyraInteractionScanCVars::bUseInteractionScanSubsystem;
+}
+
+template <typename FuncType>
+void ULyraInteractionScanSubsystem::ForEachEntryInRange(const FVector& Location, float Range, FuncType&& Func) const
+{
+	const float SearchRange = Range + MaxEntryRadius;
+	const FIntPoint MinCell = GetCell(Location - FVector(SearchRange, SearchRange, 0.0f));
+	const FIntPoint MaxCell = GetCell(Location + FVector(SearchRange, SearchRange, 0.0f));
+
+	for (int32 CellY = MinCell.Y; CellY <= MaxCell.Y; ++CellY)
+	{
+		for (int32 CellX = MinCell.X; CellX <= MaxCell.X; ++CellX)
+		{
+			const TArray<TWeakObjectPtr<AActor>>* CellActors = Cells.Find(FIntPoint(CellX, CellY));
+			if (CellActors == nullptr)
+			{
+				continue;
+			}
+
+			for (const TWeakObjectPtr<AActor>& ActorPtr : *CellActors)
+			{
+				AActor* Actor = ActorPtr.Get();
+				const FEntry* Entry = Actor ? Entries.Find(Actor) : nullptr;
+				if (Entry == nullptr)
+				{
+					continue;
+				}
+
+				if (FVector::DistSquared(Location, Entry->Location) <= FMath::Square(Range + Entry->Radius))
+				{
+					if (!Func(*Actor))
+					{
+						return;
+					}
+				}
+			}
+		}
+	}
+}
+
+void ULyraInteractionScanSubsystem::QueryInteractableTargets(const FVector& Location, float Range, TArray<TScriptInterface<IInteractableTarget>>& OutInteractableTargets) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_LyraInteractionScan_Query);
+
+	ForEachEntryInRange(Location, Range, [&OutInteractableTargets](AActor& Actor)
+	{
+		if (RespondsToInteractionChannel(Actor))
+		{
+			TArray<TScriptInterface<IInteractableTarget>> ActorTargets;
+			UInteractionStatics::GetInteractableTargetsFromActor(&Actor, ActorTargets);
+
+			for (const TScriptInterface<IInteractableTarget>& Target : ActorTargets)
+			{
+				OutInteractableTargets.AddUnique(Target);
+			}
+		}
+		return true;
+	});
+}
+
+bool ULyraInteractionScanSubsystem::HasInteractablesInRange(const FVector& Location, float Range) const
+{
+	bool bFound = false;
+	ForEachEntryInRange(Location, Range, [&bFound](AActor& Actor)
+	{
+		bFound = true;
+		return false;
+	});
+
+	return bFound;
+}
+
+void ULyraInteractionScanSubsystem::RegisterActor(AActor* Actor)
+{
+	if ((Actor == nullptr) || Entries.Contains(Actor) || !IsValid(Actor) || (Actor->GetWorld() != GetWorld()))
+	{
+		return;
+	}
+
+	TArray<TScriptInterface<IInteractableTarget>> InteractableTargets;
+	UInteractionStatics::GetInteractableTargetsFromActor(Actor, InteractableTargets);
+	if (InteractableTargets.Num() == 0)
+	{
+		return;
+	}
+
+	FEntry& Entry = Entries.Add(Actor);
+	Entry.Actor = Actor;
+	UpdateEntryBounds(Entry, *Actor);
+
+	Entry.Cell = GetCell(Entry.Location);
+	AddToCell(Actor, Entry.Cell);
+
+	// Static actors can't move, so there's no need to listen for it
+	USceneComponent* Root = Actor->GetRootComponent();
+	if (Root && (Root->Mobility != EComponentMobility::Static))
+	{
+		Entry.WatchedRoot = Root;
+		Entry.TransformUpdatedHandle = Root->TransformUpdated.AddUObject(this, &ThisClass::HandleRootComponentTransformUpdated);
+	}
+}
+
+void ULyraInteractionScanSubsystem::UnregisterActor(AActor* Actor)
+{
+	FEntry Entry;
+	if (Entries.RemoveAndCopyValue(Actor, /*out*/ Entry))
+	{
+		RemoveFromCell(Actor, Entry.Cell);
+
+		if (USceneComponent* Root = Entry.WatchedRoot.Get())
+		{
+			Root->TransformUpdated.Remove(Entry.TransformUpdatedHandle);
+		}
+	}
+}
+
+FIntPoint ULyraInteractionScanSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
+
+void ULyraInteractionScanSubsystem::UpdateEntryBounds(FEntry& Entry, const AActor& Actor)
+{
+	FVector Origin;
+	FVector Extent;
+	Actor.GetActorBounds(/*bOnlyCollidingComponents=*/ true, /*out*/ Origin, /*out*/ Extent);
+
+	const FVector RootLocation = Actor.GetActorLocation();
+	if (Extent.IsNearlyZero())
+	{
+		Origin = RootLocation;
+	}
+
+	Entry.Location = Origin;
+	Entry.RootOffset = Origin - RootLocation;
+	Entry.Radius = Extent.Size();
+
+	MaxEntryRadius = FMath::Max(MaxEntryRadius, Entry.Radius);
+}
+
+void ULyraInteractionScanSubsystem::AddToCell(AActor* Actor, const FIntPoint& Cell)
+{
+	Cells.FindOrAdd(Cell).Add(Actor);
+}
+
+void ULyraInteractionScanSubsystem::RemoveFromCell(const AActor* Actor, const FIntPoint& Cell)
+{
+	if (TArray<TWeakObjectPtr<AActor>>* CellActors = Cells.Find(Cell))
+	{
+		// Also drops any actors that were garbage collected without being destroyed
+		CellActors->RemoveAllSwap([Actor](const TWeakObjectPtr<AActor>& Other) { return !Other.IsValid() || (Other.Get() == Actor); });
+
+		if (CellActors->Num() == 0)
+		{
+			Cells.Remove(Cell);
+		}
+	}
+}
+
+void ULyraInteractionScanSubsystem::RegisterLevelActors(ULevel* Level)
+{
+	if (Level == nullptr)
+	{
+		return;
+	}
+
+	for (AActor* Actor : Level->Actors)
+	{
+		RegisterActor(Actor);
+	}
+}
+
+void ULyraInteractionScanSubsystem::HandleActorSpawned(AActor* Actor)
+{
+	RegisterActor(Actor);
+
+	// Components created in BeginPlay or added by game features when the actor becomes ready don't exist yet when it spawns
+	if ((Actor != nullptr) && !Entries.Contains(Actor))
+	{
+		PendingRecheckActors.Add(Actor);
+		if (PendingRecheckActors.Num() == 1)
+		{
+			GetWorld()->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateUObject(this, &ThisClass::RecheckSpawnedActors));
+		}
+	}
+}
+
+void ULyraInteractionScanSubsystem::RecheckSpawnedActors()
+{
+	TArray<TWeakObjectPtr<AActor>> ActorsToCheck = MoveTemp(PendingRecheckActors);
+	PendingRecheckActors.Reset();
+
+	for (const TWeakObjectPtr<AActor>& ActorPtr : ActorsToCheck)
+	{
+		RegisterActor(ActorPtr.Get());
+	}
+}
+
+void ULyraInteractionScanSubsystem::HandleActorDestroyed(AActor* Actor)
+{
+	UnregisterActor(Actor);
+}
+
+void ULyraInteractionScanSubsystem::HandleLevelAddedToWorld(ULevel* Level, UWorld* World)
+{
+	if (World == GetWorld())
+	{
+		RegisterLevelActors(Level);
+	}
+}
+
+void ULyraInteractionScanSubsystem::HandleLevelRemovedFromWorld(ULevel* Level, UWorld* World)
+{
+	if ((World == GetWorld()) && (Level != nullptr))
+	{
+		for (AActor* Actor : Level->Actors)
+		{
+			UnregisterActor(Actor);
+		}
+	}
+}
+
+void ULyraInteractionScanSubsystem::HandleRootComponentTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	AActor* Actor = UpdatedComponent->GetOwner();
+	FEntry* Entry = Actor ? Entries.Find(Actor) : nullptr;
+	if (Entry == nullptr)
+	{
+		return;
+	}
+
+	Entry->Location = UpdatedComponent->GetComponentLocation() + Entry->RootOffset;
+
+	if (GetCell(Entry->Location) != Entry->Cell)
+	{
+		// Only re-measure the bounds on cell changes, so actors that move every frame stay cheap
+		UpdateEntryBounds(*Entry, *Actor);
+
+		RemoveFromCell(Actor, Entry->Cell);
+		Entry->Cell = GetCell(Entry->Location);
+		AddToCell(Actor, Entry->Cell);
+	}
+}
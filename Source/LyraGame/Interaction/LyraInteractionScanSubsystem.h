@@ -0,0 +1,116 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+
+#include "LyraInteractionScanSubsystem.generated.h"
+
+template <typename InterfaceType> class TScriptInterface;
+
+class AActor;
+class IInteractableTarget;
+class ULevel;
+class USceneComponent;
+enum class EUpdateTransformFlags : int32;
+enum class ETeleportType : uint8;
+
+/**
+ * World level registry of the actors that have interactable targets, bucketed in a 2D grid
+ *
+ * Interaction tasks ask it for the targets near their avatar instead of each running their own
+ * overlap, so the cost scales with the number of interactables near players rather than with
+ * players times scan rate. Actors are added when they spawn (or their level is added to the world),
+ * moved to a new cell when their root component moves, and removed when they're destroyed.
+ * Spawned actors without targets are checked again on the next tick, to pick up components created in BeginPlay.
+ * Actors that only become interactable later than that must be added with RegisterActor.
+ * The subsystem is only created while Lyra.Interaction.UseScanSubsystem is on, so it costs nothing when it's disabled.
+ */
+UCLASS()
+class LYRAGAME_API ULyraInteractionScanSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//~USubsystem interface
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End of USubsystem interface
+
+	//~UWorldSubsystem interface
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	//~End of UWorldSubsystem interface
+
+	static ULyraInteractionScanSubsystem* Get(const UObject* WorldContextObject);
+
+	// Returns true if the scan subsystem should be used instead of scene queries
+	static bool IsEnabled();
+
+	// Adds the interactable targets on actors within Range of Location that respond to the interaction trace channel
+	void QueryInteractableTargets(const FVector& Location, float Range, TArray<TScriptInterface<IInteractableTarget>>& OutInteractableTargets) const;
+
+	// Returns true if any registered interactable is within Range of Location, without checking its collision
+	bool HasInteractablesInRange(const FVector& Location, float Range) const;
+
+	// Adds the actor if it has any interactable targets, does nothing if it's already registered
+	void RegisterActor(AActor* Actor);
+
+	void UnregisterActor(AActor* Actor);
+
+	int32 GetNumRegisteredActors() const { return Entries.Num(); }
+
+private:
+	struct FEntry
+	{
+		TWeakObjectPtr<AActor> Actor;
+
+		// Center and radius of the actor's colliding bounds, and the center's offset from the root component
+		FVector Location = FVector::ZeroVector;
+		FVector RootOffset = FVector::ZeroVector;
+		float Radius = 0.0f;
+
+		FIntPoint Cell = FIntPoint::ZeroValue;
+
+		TWeakObjectPtr<USceneComponent> WatchedRoot;
+		FDelegateHandle TransformUpdatedHandle;
+	};
+
+	FIntPoint GetCell(const FVector& Location) const;
+
+	void UpdateEntryBounds(FEntry& Entry, const AActor& Actor);
+
+	void AddToCell(AActor* Actor, const FIntPoint& Cell);
+	void RemoveFromCell(const AActor* Actor, const FIntPoint& Cell);
+
+	// Calls Func for every live entry whose bounds are within Range of Location
+	template <typename FuncType>
+	void ForEachEntryInRange(const FVector& Location, float Range, FuncType&& Func) const;
+
+	void RegisterLevelActors(ULevel* Level);
+
+	void HandleActorSpawned(AActor* Actor);
+	void RecheckSpawnedActors();
+	void HandleActorDestroyed(AActor* Actor);
+	void HandleLevelAddedToWorld(ULevel* Level, UWorld* World);
+	void HandleLevelRemovedFromWorld(ULevel* Level, UWorld* World);
+	void HandleRootComponentTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+
+private:
+	TMap<TObjectKey<AActor>, FEntry> Entries;
+	TMap<FIntPoint, TArray<TWeakObjectPtr<AActor>>> Cells;
+
+	// Actors that had no interactable targets when they spawned, checked again on the next tick
+	TArray<TWeakObjectPtr<AActor>> PendingRecheckActors;
+
+	float CellSize = 1000.0f;
+
+	// The largest radius of any entry so far, queries look this much further out for entries centered in other cells
+	float MaxEntryRadius = 0.0f;
+
+	FDelegateHandle ActorSpawnedHandle;
+	FDelegateHandle ActorDestroyedHandle;
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+};
@@ -9,6 +9,7 @@
 #include "Interaction/InteractionOption.h"
 #include "Interaction/InteractionQuery.h"
 #include "Interaction/InteractionStatics.h"
+#include "Interaction/LyraInteractionScanSubsystem.h"
 #include "Physics/LyraCollisionChannels.h"
 #include "TimerManager.h"
 
@@ -52,16 +53,26 @@ void UAbilityTask_GrantNearbyInteraction::QueryInteractables()
 	
 	if (World && ActorOwner)
 	{
-		FCollisionQueryParams Params(SCENE_QUERY_STAT(UAbilityTask_GrantNearbyInteraction), false);
+		TArray<TScriptInterface<IInteractableTarget>> InteractableTargets;
 
-		TArray<FOverlapResult> OverlapResults;
-		World->OverlapMultiByChannel(OUT OverlapResults, ActorOwner->GetActorLocation(), FQuat::Identity, Lyra_TraceChannel_Interaction, FCollisionShape::MakeSphere(InteractionScanRange), Params);
-
-		if (OverlapResults.Num() > 0)
+		// Look the interactables up in the shared registry rather than running a scene query for every player
+		ULyraInteractionScanSubsystem* ScanSubsystem = World->GetSubsystem<ULyraInteractionScanSubsystem>();
+		if (ScanSubsystem && ULyraInteractionScanSubsystem::IsEnabled())
+		{
+			ScanSubsystem->QueryInteractableTargets(ActorOwner->GetActorLocation(), InteractionScanRange, OUT InteractableTargets);
+		}
+		else
 		{
-			TArray<TScriptInterface<IInteractableTarget>> InteractableTargets;
+			FCollisionQueryParams Params(SCENE_QUERY_STAT(UAbilityTask_GrantNearbyInteraction), false);
+
+			TArray<FOverlapResult> OverlapResults;
+			World->OverlapMultiByChannel(OUT OverlapResults, ActorOwner->GetActorLocation(), FQuat::Identity, Lyra_TraceChannel_Interaction, FCollisionShape::MakeSphere(InteractionScanRange), Params);
+
 			UInteractionStatics::AppendInteractableTargetsFromOverlapResults(OverlapResults, OUT InteractableTargets);
-			
+		}
+
+		if (InteractableTargets.Num() > 0)
+		{
 			FInteractionQuery InteractionQuery;
 			InteractionQuery.RequestingAvatar = ActorOwner;
 			InteractionQuery.RequestingController = Cast<AController>(ActorOwner->GetOwner());
@@ -35,30 +35,47 @@ void UAbilityTask_WaitForInteractableTargets::LineTrace(FHitResult& OutHitResult
 
 void UAbilityTask_WaitForInteractableTargets::AimWithPlayerController(const AActor* InSourceActor, FCollisionQueryParams Params, const FVector& TraceStart, float MaxRange, FVector& OutTraceEnd, bool bIgnorePitch) const
 {
-	if (!Ability) // Server and launching client only
+	FVector ViewStart;
+	FVector ViewDir;
+	FVector ViewEnd;
+	if (!GetPlayerControllerAimRay(TraceStart, MaxRange, /*out*/ ViewStart, /*out*/ ViewDir, /*out*/ ViewEnd))
 	{
 		return;
 	}
 
+	FHitResult HitResult;
+	LineTrace(HitResult, InSourceActor->GetWorld(), ViewStart, ViewEnd, TraceProfile.Name, Params);
+
+	OutTraceEnd = GetAimedTraceEnd(HitResult, TraceStart, MaxRange, ViewDir, ViewEnd);
+}
+
+bool UAbilityTask_WaitForInteractableTargets::GetPlayerControllerAimRay(const FVector& TraceStart, float MaxRange, FVector& OutViewStart, FVector& OutViewDir, FVector& OutViewEnd) const
+{
+	if (!Ability) // Server and launching client only
+	{
+		return false;
+	}
+
 	//@TODO: Bots?
 	APlayerController* PC = Ability->GetCurrentActorInfo()->PlayerController.Get();
 	check(PC);
 
-	FVector ViewStart;
 	FRotator ViewRot;
-	PC->GetPlayerViewPoint(ViewStart, ViewRot);
+	PC->GetPlayerViewPoint(OutViewStart, ViewRot);
 
-	const FVector ViewDir = ViewRot.Vector();
-	FVector ViewEnd = ViewStart + (ViewDir * MaxRange);
+	OutViewDir = ViewRot.Vector();
+	OutViewEnd = OutViewStart + (OutViewDir * MaxRange);
 
-	ClipCameraRayToAbilityRange(ViewStart, ViewDir, TraceStart, MaxRange, ViewEnd);
+	ClipCameraRayToAbilityRange(OutViewStart, OutViewDir, TraceStart, MaxRange, OutViewEnd);
 
-	FHitResult HitResult;
-	LineTrace(HitResult, InSourceActor->GetWorld(), ViewStart, ViewEnd, TraceProfile.Name, Params);
+	return true;
+}
 
-	const bool bUseTraceResult = HitResult.bBlockingHit && (FVector::DistSquared(TraceStart, HitResult.Location) <= (MaxRange * MaxRange));
+FVector UAbilityTask_WaitForInteractableTargets::GetAimedTraceEnd(const FHitResult& AimHitResult, const FVector& TraceStart, float MaxRange, const FVector& ViewDir, const FVector& ViewEnd) const
+{
+	const bool bUseTraceResult = AimHitResult.bBlockingHit && (FVector::DistSquared(TraceStart, AimHitResult.Location) <= (MaxRange * MaxRange));
 
-	const FVector AdjustedEnd = (bUseTraceResult) ? HitResult.Location : ViewEnd;
+	const FVector AdjustedEnd = (bUseTraceResult) ? AimHitResult.Location : ViewEnd;
 
 	FVector AdjustedAimDir = (AdjustedEnd - TraceStart).GetSafeNormal();
 	if (AdjustedAimDir.IsZero())
@@ -82,7 +99,7 @@ void UAbilityTask_WaitForInteractableTargets::AimWithPlayerController(const AAct
 		}
 	}
 
-	OutTraceEnd = TraceStart + (AdjustedAimDir * MaxRange);
+	return TraceStart + (AdjustedAimDir * MaxRange);
 }
 
 bool UAbilityTask_WaitForInteractableTargets::ClipCameraRayToAbilityRange(FVector CameraLocation, FVector CameraDirection, FVector AbilityCenter, float AbilityRange, FVector& ClippedPosition)
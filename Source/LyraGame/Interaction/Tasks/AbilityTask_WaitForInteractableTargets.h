@@ -33,6 +33,10 @@ protected:
 
 	void AimWithPlayerController(const AActor* InSourceActor, FCollisionQueryParams Params, const FVector& TraceStart, float MaxRange, FVector& OutTraceEnd, bool bIgnorePitch = false) const;
 
+	// The two halves of AimWithPlayerController, for callers that run the camera trace themselves (e.g., asynchronously)
+	bool GetPlayerControllerAimRay(const FVector& TraceStart, float MaxRange, FVector& OutViewStart, FVector& OutViewDir, FVector& OutViewEnd) const;
+	FVector GetAimedTraceEnd(const FHitResult& AimHitResult, const FVector& TraceStart, float MaxRange, const FVector& ViewDir, const FVector& ViewEnd) const;
+
 	static bool ClipCameraRayToAbilityRange(FVector CameraLocation, FVector CameraDirection, FVector AbilityCenter, float AbilityRange, FVector& ClippedPosition);
 
 	void UpdateInteractableOptions(const FInteractionQuery& InteractQuery, const TArray<TScriptInterface<IInteractableTarget>>& InteractableTargets);
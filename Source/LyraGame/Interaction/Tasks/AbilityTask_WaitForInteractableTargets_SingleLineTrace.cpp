@@ -2,12 +2,24 @@
 
 #include "AbilityTask_WaitForInteractableTargets_SingleLineTrace.h"
 #include "Interaction/InteractionStatics.h"
+#include "Interaction/LyraInteractionScanSubsystem.h"
 #include "DrawDebugHelpers.h"
 #include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
 #include "TimerManager.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(AbilityTask_WaitForInteractableTargets_SingleLineTrace)
 
+namespace LyraInteractionTraceCVars
+{
+	static bool bAsyncInteractionTrace = true;
+	static FAutoConsoleVariableRef CVarAsyncInteractionTrace(
+		TEXT("Lyra.Interaction.AsyncLineTrace"),
+		bAsyncInteractionTrace,
+		TEXT("If true, the interaction camera and line traces are queued with the world's async traces and the result is applied two frames later."),
+		ECVF_Default);
+}
+
 UAbilityTask_WaitForInteractableTargets_SingleLineTrace::UAbilityTask_WaitForInteractableTargets_SingleLineTrace(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
@@ -54,6 +66,16 @@ void UAbilityTask_WaitForInteractableTargets_SingleLineTrace::PerformTrace()
 
 	UWorld* World = GetWorld();
 
+	FVector TraceStart = StartLocation.GetTargetingTransform().GetLocation();
+
+	// The trace can't reach anything further away than the scan range, so skip it when the registry has nothing that close
+	const ULyraInteractionScanSubsystem* ScanSubsystem = World->GetSubsystem<ULyraInteractionScanSubsystem>();
+	if (ScanSubsystem && ULyraInteractionScanSubsystem::IsEnabled() && !ScanSubsystem->HasInteractablesInRange(TraceStart, InteractionScanRange))
+	{
+		UpdateInteractableOptions(InteractionQuery, TArray<TScriptInterface<IInteractableTarget>>());
+		return;
+	}
+
 	TArray<AActor*> ActorsToIgnore;
 	ActorsToIgnore.Add(AvatarActor);
 
@@ -61,13 +83,67 @@ void UAbilityTask_WaitForInteractableTargets_SingleLineTrace::PerformTrace()
 	FCollisionQueryParams Params(SCENE_QUERY_STAT(UAbilityTask_WaitForInteractableTargets_SingleLineTrace), bTraceComplex);
 	Params.AddIgnoredActors(ActorsToIgnore);
 
-	FVector TraceStart = StartLocation.GetTargetingTransform().GetLocation();
+	if (LyraInteractionTraceCVars::bAsyncInteractionTrace)
+	{
+		// The camera trace runs alongside every other async trace queued this frame, the interaction trace is queued when it comes back
+		FVector ViewStart;
+		FVector ViewDir;
+		FVector ViewEnd;
+		if (GetPlayerControllerAimRay(TraceStart, InteractionScanRange, OUT ViewStart, OUT ViewDir, OUT ViewEnd))
+		{
+			FTraceDelegate AimTraceDelegate = FTraceDelegate::CreateUObject(this, &ThisClass::HandleAsyncAimTraceCompleted, TraceStart, ViewDir, ViewEnd);
+			World->AsyncLineTraceByProfile(EAsyncTraceType::Multi, ViewStart, ViewEnd, TraceProfile.Name, Params, &AimTraceDelegate);
+		}
+		return;
+	}
+
 	FVector TraceEnd;
 	AimWithPlayerController(AvatarActor, Params, TraceStart, InteractionScanRange, OUT TraceEnd);
 
 	FHitResult OutHitResult;
 	LineTrace(OutHitResult, World, TraceStart, TraceEnd, TraceProfile.Name, Params);
 
+	ApplyTraceResult(OutHitResult, TraceStart, TraceEnd);
+}
+
+void UAbilityTask_WaitForInteractableTargets_SingleLineTrace::HandleAsyncAimTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum, FVector TraceStart, FVector ViewDir, FVector ViewEnd)
+{
+	UWorld* World = GetWorld();
+	if (World == nullptr)
+	{
+		return;
+	}
+
+	// Matches LineTrace, the first hit is used whether it blocks or not
+	FHitResult AimHitResult;
+	if (TraceDatum.OutHits.Num() > 0)
+	{
+		AimHitResult = TraceDatum.OutHits[0];
+	}
+
+	const FVector TraceEnd = GetAimedTraceEnd(AimHitResult, TraceStart, InteractionScanRange, ViewDir, ViewEnd);
+
+	FTraceDelegate TraceDelegate = FTraceDelegate::CreateUObject(this, &ThisClass::HandleAsyncTraceCompleted);
+	World->AsyncLineTraceByProfile(EAsyncTraceType::Multi, TraceStart, TraceEnd, TraceProfile.Name, TraceDatum.CollisionParams.CollisionQueryParam, &TraceDelegate);
+}
+
+void UAbilityTask_WaitForInteractableTargets_SingleLineTrace::HandleAsyncTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	// Matches LineTrace, the first hit is used whether it blocks or not
+	FHitResult OutHitResult;
+	OutHitResult.TraceStart = TraceDatum.Start;
+	OutHitResult.TraceEnd = TraceDatum.End;
+
+	if (TraceDatum.OutHits.Num() > 0)
+	{
+		OutHitResult = TraceDatum.OutHits[0];
+	}
+
+	ApplyTraceResult(OutHitResult, TraceDatum.Start, TraceDatum.End);
+}
+
+void UAbilityTask_WaitForInteractableTargets_SingleLineTrace::ApplyTraceResult(const FHitResult& OutHitResult, const FVector& TraceStart, const FVector& TraceEnd)
+{
 	TArray<TScriptInterface<IInteractableTarget>> InteractableTargets;
 	UInteractionStatics::AppendInteractableTargetsFromHitResult(OutHitResult, InteractableTargets);
 
@@ -76,6 +152,7 @@ void UAbilityTask_WaitForInteractableTargets_SingleLineTrace::PerformTrace()
 #if ENABLE_DRAW_DEBUG
 	if (bShowDebug)
 	{
+		UWorld* World = GetWorld();
 		FColor DebugColor = OutHitResult.bBlockingHit ? FColor::Red : FColor::Green;
 		if (OutHitResult.bBlockingHit)
 		{
@@ -89,4 +166,3 @@ void UAbilityTask_WaitForInteractableTargets_SingleLineTrace::PerformTrace()
 	}
 #endif // ENABLE_DRAW_DEBUG
 }
-
@@ -11,6 +11,9 @@ struct FCollisionProfileName;
 class UGameplayAbility;
 class UObject;
 struct FFrame;
+struct FHitResult;
+struct FTraceDatum;
+struct FTraceHandle;
 
 UCLASS()
 class UAbilityTask_WaitForInteractableTargets_SingleLineTrace : public UAbilityTask_WaitForInteractableTargets
@@ -29,6 +32,12 @@ private:
 
 	void PerformTrace();
 
+	void HandleAsyncAimTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum, FVector TraceStart, FVector ViewDir, FVector ViewEnd);
+
+	void HandleAsyncTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	void ApplyTraceResult(const FHitResult& OutHitResult, const FVector& TraceStart, const FVector& TraceEnd);
+
 	UPROPERTY()
 	FInteractionQuery InteractionQuery;
 
@@ -8,10 +8,17 @@
 
 void UInventoryFragment_SetStats::OnInstanceCreated(ULyraInventoryItemInstance* Instance) const
 {
+	TArray<TPair<FGameplayTag, int32>, TInlineAllocator<8>> InitialStacks;
 	for (const auto& KVP : InitialItemStats)
 	{
-		Instance->AddStatTagStack(KVP.Key, KVP.Value);
+		// Matches AddStatTagStack, which ignores counts below 1
+		if (KVP.Value > 0)
+		{
+			InitialStacks.Emplace(KVP.Key, KVP.Value);
+		}
 	}
+
+	Instance->ApplyStatTagStackDeltas(InitialStacks);
 }
 
 int32 UInventoryFragment_SetStats::GetItemStatByTag(FGameplayTag Tag) const
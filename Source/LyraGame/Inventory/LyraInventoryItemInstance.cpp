@@ -46,6 +46,11 @@ void ULyraInventoryItemInstance::RemoveStatTagStack(FGameplayTag Tag, int32 Stac
 	StatTags.RemoveStack(Tag, StackCount);
 }
 
+void ULyraInventoryItemInstance::ApplyStatTagStackDeltas(TConstArrayView<TPair<FGameplayTag, int32>> TagDeltas)
+{
+	StatTags.ApplyStackDeltas(TagDeltas);
+}
+
 int32 ULyraInventoryItemInstance::GetStatTagStackCount(FGameplayTag Tag) const
 {
 	return StatTags.GetStackCount(Tag);
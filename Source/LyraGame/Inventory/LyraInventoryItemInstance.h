@@ -37,6 +37,9 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category= Inventory)
 	void RemoveStatTagStack(FGameplayTag Tag, int32 StackCount);
 
+	// Applies several stack count changes at once (positive adds stacks, negative removes them)
+	void ApplyStatTagStackDeltas(TConstArrayView<TPair<FGameplayTag, int32>> TagDeltas);
+
 	// Returns the stack count of the specified tag (or 0 if the tag is not present)
 	UFUNCTION(BlueprintCallable, Category=Inventory)
 	int32 GetStatTagStackCount(FGameplayTag Tag) const;
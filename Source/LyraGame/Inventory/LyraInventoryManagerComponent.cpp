@@ -5,10 +5,12 @@
 #include "Engine/ActorChannel.h"
 #include "Engine/World.h"
 #include "GameFramework/GameplayMessageSubsystem.h"
+#include "HAL/IConsoleManager.h"
 #include "LyraInventoryItemDefinition.h"
 #include "LyraInventoryItemInstance.h"
 #include "NativeGameplayTags.h"
 #include "Net/UnrealNetwork.h"
+#include "TimerManager.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraInventoryManagerComponent)
 
@@ -16,6 +18,17 @@ class FLifetimeProperty;
 struct FReplicationFlags;
 
 UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Lyra_Inventory_Message_StackChanged, "Lyra.Inventory.Message.StackChanged");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Lyra_Inventory_Message_Changed, "Lyra.Inventory.Message.Changed");
+
+namespace LyraInventoryCVars
+{
+	static bool bSendPerEntryMessages = false;
+	static FAutoConsoleVariableRef CVarSendPerEntryMessages(
+		TEXT("Lyra.Inventory.SendPerEntryMessages"),
+		bSendPerEntryMessages,
+		TEXT("If true, clients also send the legacy StackChanged message for every replicated entry change. Listeners should use the batched Changed message sent once per frame instead."),
+		ECVF_Default);
+}
 
 //////////////////////////////////////////////////////////////////////
 // FLyraInventoryEntry
@@ -42,6 +55,8 @@ void FLyraInventoryList::PreReplicatedRemove(const TArrayView<int32> RemovedIndi
 		BroadcastChangeMessage(Stack, /*OldCount=*/ Stack.StackCount, /*NewCount=*/ 0);
 		Stack.LastObservedCount = 0;
 	}
+
+	bItemIndexDirty = true;
 }
 
 void FLyraInventoryList::PostReplicatedAdd(const TArrayView<int32> AddedIndices, int32 FinalSize)
@@ -52,6 +67,8 @@ void FLyraInventoryList::PostReplicatedAdd(const TArrayView<int32> AddedIndices,
 		BroadcastChangeMessage(Stack, /*OldCount=*/ 0, /*NewCount=*/ Stack.StackCount);
 		Stack.LastObservedCount = Stack.StackCount;
 	}
+
+	bItemIndexDirty = true;
 }
 
 void FLyraInventoryList::PostReplicatedChange(const TArrayView<int32> ChangedIndices, int32 FinalSize)
@@ -63,10 +80,20 @@ void FLyraInventoryList::PostReplicatedChange(const TArrayView<int32> ChangedInd
 		BroadcastChangeMessage(Stack, /*OldCount=*/ Stack.LastObservedCount, /*NewCount=*/ Stack.StackCount);
 		Stack.LastObservedCount = Stack.StackCount;
 	}
+
+	// The instance pointer may have just been resolved
+	bItemIndexDirty = true;
 }
 
 void FLyraInventoryList::BroadcastChangeMessage(FLyraInventoryEntry& Entry, int32 OldCount, int32 NewCount)
 {
+	RecordChange(Entry.Instance, OldCount, NewCount);
+
+	if (!LyraInventoryCVars::bSendPerEntryMessages)
+	{
+		return;
+	}
+
 	FLyraInventoryChangeMessage Message;
 	Message.InventoryOwner = OwnerComponent;
 	Message.Instance = Entry.Instance;
@@ -77,6 +104,59 @@ void FLyraInventoryList::BroadcastChangeMessage(FLyraInventoryEntry& Entry, int3
 	MessageSystem.BroadcastMessage(TAG_Lyra_Inventory_Message_StackChanged, Message);
 }
 
+void FLyraInventoryList::RecordChange(ULyraInventoryItemInstance* Instance, int32 OldCount, int32 NewCount)
+{
+	// Nothing on a dedicated server presents inventory, so don't pay for batching there
+	if ((OwnerComponent == nullptr) || (OwnerComponent->GetNetMode() == NM_DedicatedServer))
+	{
+		return;
+	}
+
+	if (FLyraInventoryChangeDelta* ExistingChange = PendingChanges.FindByPredicate([Instance](const FLyraInventoryChangeDelta& Change) { return Change.Instance == Instance; }))
+	{
+		// Keep the count from the start of the frame so listeners see the net change
+		ExistingChange->NewCount = NewCount;
+		return;
+	}
+
+	FLyraInventoryChangeDelta& NewChange = PendingChanges.AddDefaulted_GetRef();
+	NewChange.Instance = Instance;
+	NewChange.OldCount = OldCount;
+	NewChange.NewCount = NewCount;
+
+	if (PendingChanges.Num() == 1)
+	{
+		ULyraInventoryManagerComponent* InventoryComponent = Cast<ULyraInventoryManagerComponent>(OwnerComponent);
+		UWorld* World = (OwnerComponent != nullptr) ? OwnerComponent->GetWorld() : nullptr;
+		if ((InventoryComponent != nullptr) && (World != nullptr))
+		{
+			World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateUObject(InventoryComponent, &ULyraInventoryManagerComponent::HandleFlushChangeMessages));
+		}
+	}
+}
+
+void FLyraInventoryList::FlushChangeMessages()
+{
+	if (PendingChanges.Num() == 0)
+	{
+		return;
+	}
+
+	FLyraInventoryChangeBatchMessage Message;
+	Message.InventoryOwner = OwnerComponent;
+	Message.Changes = MoveTemp(PendingChanges);
+	PendingChanges.Reset();
+
+	// Stacks that ended the frame where they started (e.g., added and removed again) aren't worth reporting
+	Message.Changes.RemoveAllSwap([](const FLyraInventoryChangeDelta& Change) { return Change.OldCount == Change.NewCount; });
+
+	if ((Message.Changes.Num() > 0) && (OwnerComponent != nullptr))
+	{
+		UGameplayMessageSubsystem& MessageSystem = UGameplayMessageSubsystem::Get(OwnerComponent->GetWorld());
+		MessageSystem.BroadcastMessage(TAG_Lyra_Inventory_Message_Changed, Message);
+	}
+}
+
 ULyraInventoryItemInstance* FLyraInventoryList::AddEntry(TSubclassOf<ULyraInventoryItemDefinition> ItemDef, int32 StackCount)
 {
 	ULyraInventoryItemInstance* Result = nullptr;
@@ -101,6 +181,9 @@ ULyraInventoryItemInstance* FLyraInventoryList::AddEntry(TSubclassOf<ULyraInvent
 	NewEntry.StackCount = StackCount;
 	Result = NewEntry.Instance;
 
+	AddToItemIndex(Result);
+	RecordChange(Result, /*OldCount=*/ 0, /*NewCount=*/ StackCount);
+
 	//const ULyraInventoryItemDefinition* ItemCDO = GetDefault<ULyraInventoryItemDefinition>(ItemDef);
 	MarkItemDirty(NewEntry);
 
@@ -119,24 +202,127 @@ void FLyraInventoryList::RemoveEntry(ULyraInventoryItemInstance* Instance)
 		FLyraInventoryEntry& Entry = *EntryIt;
 		if (Entry.Instance == Instance)
 		{
+			RecordChange(Entry.Instance, /*OldCount=*/ Entry.StackCount, /*NewCount=*/ 0);
 			EntryIt.RemoveCurrent();
 			MarkArrayDirty();
 		}
 	}
+
+	RemoveFromItemIndex(Instance);
+}
+
+void FLyraInventoryList::RemoveEntries(TConstArrayView<ULyraInventoryItemInstance*> Instances)
+{
+	if (Instances.Num() == 0)
+	{
+		return;
+	}
+
+	const int32 NumRemoved = Entries.RemoveAll([this, Instances](const FLyraInventoryEntry& Entry)
+	{
+		if (Instances.Contains(Entry.Instance.Get()))
+		{
+			RecordChange(Entry.Instance, /*OldCount=*/ Entry.StackCount, /*NewCount=*/ 0);
+			return true;
+		}
+		return false;
+	});
+
+	if (NumRemoved > 0)
+	{
+		MarkArrayDirty();
+	}
+
+	for (ULyraInventoryItemInstance* Instance : Instances)
+	{
+		RemoveFromItemIndex(Instance);
+	}
 }
 
 TArray<ULyraInventoryItemInstance*> FLyraInventoryList::GetAllItems() const
 {
 	TArray<ULyraInventoryItemInstance*> Results;
-	Results.Reserve(Entries.Num());
+	GetAllItems(/*out*/ Results);
+	return Results;
+}
+
+void FLyraInventoryList::GetAllItems(TArray<ULyraInventoryItemInstance*>& OutItems) const
+{
+	OutItems.Reset(Entries.Num());
 	for (const FLyraInventoryEntry& Entry : Entries)
 	{
 		if (Entry.Instance != nullptr) //@TODO: Would prefer to not deal with this here and hide it further?
 		{
-			Results.Add(Entry.Instance);
+			OutItems.Add(Entry.Instance);
+		}
+	}
+}
+
+TConstArrayView<ULyraInventoryItemInstance*> FLyraInventoryList::FindItemsByDefinition(TSubclassOf<ULyraInventoryItemDefinition> ItemDef) const
+{
+	ConditionalRebuildItemIndex();
+
+	if (const TArray<ULyraInventoryItemInstance*>* Instances = ItemsByDefinition.Find(ItemDef.Get()))
+	{
+		return *Instances;
+	}
+
+	return TConstArrayView<ULyraInventoryItemInstance*>();
+}
+
+void FLyraInventoryList::AddToItemIndex(ULyraInventoryItemInstance* Instance)
+{
+	// A dirty index will pick the instance up when it is rebuilt
+	if (!bItemIndexDirty && (Instance != nullptr))
+	{
+		ItemsByDefinition.FindOrAdd(Instance->GetItemDef().Get()).Add(Instance);
+	}
+}
+
+void FLyraInventoryList::RemoveFromItemIndex(ULyraInventoryItemInstance* Instance)
+{
+	if (!bItemIndexDirty && (Instance != nullptr))
+	{
+		const UClass* ItemDef = Instance->GetItemDef().Get();
+		if (TArray<ULyraInventoryItemInstance*>* Instances = ItemsByDefinition.Find(ItemDef))
+		{
+			// Keep the remaining instances in the order they were added, so the 'first' stack matches the entry order
+			Instances->RemoveSingle(Instance);
+			if (Instances->Num() == 0)
+			{
+				ItemsByDefinition.Remove(ItemDef);
+			}
 		}
 	}
-	return Results;
+}
+
+void FLyraInventoryList::ConditionalRebuildItemIndex() const
+{
+	if (!bItemIndexDirty)
+	{
+		return;
+	}
+
+	ItemsByDefinition.Reset();
+	bItemIndexDirty = false;
+
+	for (const FLyraInventoryEntry& Entry : Entries)
+	{
+		if (Entry.Instance == nullptr)
+		{
+			continue;
+		}
+
+		const UClass* ItemDef = Entry.Instance->GetItemDef().Get();
+		if (ItemDef == nullptr)
+		{
+			// The item definition hasn't replicated yet, try again on the next query
+			bItemIndexDirty = true;
+			continue;
+		}
+
+		ItemsByDefinition.FindOrAdd(ItemDef).Add(Entry.Instance);
+	}
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -201,18 +387,33 @@ TArray<ULyraInventoryItemInstance*> ULyraInventoryManagerComponent::GetAllItems(
 	return InventoryList.GetAllItems();
 }
 
+void ULyraInventoryManagerComponent::HandleFlushChangeMessages()
+{
+	InventoryList.FlushChangeMessages();
+}
+
+int32 ULyraInventoryManagerComponent::GetNumItemEntries() const
+{
+	return InventoryList.GetNumEntries();
+}
+
+ULyraInventoryItemInstance* ULyraInventoryManagerComponent::GetItemAtIndex(int32 Index) const
+{
+	return InventoryList.Entries.IsValidIndex(Index) ? InventoryList.Entries[Index].Instance.Get() : nullptr;
+}
+
+TConstArrayView<ULyraInventoryItemInstance*> ULyraInventoryManagerComponent::FindItemsByDefinition(TSubclassOf<ULyraInventoryItemDefinition> ItemDef) const
+{
+	return InventoryList.FindItemsByDefinition(ItemDef);
+}
+
 ULyraInventoryItemInstance* ULyraInventoryManagerComponent::FindFirstItemStackByDefinition(TSubclassOf<ULyraInventoryItemDefinition> ItemDef) const
 {
-	for (const FLyraInventoryEntry& Entry : InventoryList.Entries)
+	for (ULyraInventoryItemInstance* Instance : InventoryList.FindItemsByDefinition(ItemDef))
 	{
-		ULyraInventoryItemInstance* Instance = Entry.Instance;
-
 		if (IsValid(Instance))
 		{
-			if (Instance->GetItemDef() == ItemDef)
-			{
-				return Instance;
-			}
+			return Instance;
 		}
 	}
 
@@ -222,16 +423,11 @@ ULyraInventoryItemInstance* ULyraInventoryManagerComponent::FindFirstItemStackBy
 int32 ULyraInventoryManagerComponent::GetTotalItemCountByDefinition(TSubclassOf<ULyraInventoryItemDefinition> ItemDef) const
 {
 	int32 TotalCount = 0;
-	for (const FLyraInventoryEntry& Entry : InventoryList.Entries)
+	for (ULyraInventoryItemInstance* Instance : InventoryList.FindItemsByDefinition(ItemDef))
 	{
-		ULyraInventoryItemInstance* Instance = Entry.Instance;
-
 		if (IsValid(Instance))
 		{
-			if (Instance->GetItemDef() == ItemDef)
-			{
-				++TotalCount;
-			}
+			++TotalCount;
 		}
 	}
 
@@ -246,22 +442,25 @@ bool ULyraInventoryManagerComponent::ConsumeItemsByDefinition(TSubclassOf<ULyraI
 		return false;
 	}
 
-	//@TODO: N squared right now as there's no acceleration structure
-	int32 TotalConsumed = 0;
-	while (TotalConsumed < NumToConsume)
+	// Gather everything first so the entry list is only walked once, even for large inventories
+	TArray<ULyraInventoryItemInstance*, TInlineAllocator<8>> InstancesToConsume;
+	for (ULyraInventoryItemInstance* Instance : InventoryList.FindItemsByDefinition(ItemDef))
 	{
-		if (ULyraInventoryItemInstance* Instance = ULyraInventoryManagerComponent::FindFirstItemStackByDefinition(ItemDef))
+		if (InstancesToConsume.Num() >= NumToConsume)
 		{
-			InventoryList.RemoveEntry(Instance);
-			++TotalConsumed;
+			break;
 		}
-		else
+
+		if (IsValid(Instance))
 		{
-			return false;
+			InstancesToConsume.Add(Instance);
 		}
 	}
 
-	return TotalConsumed == NumToConsume;
+	// Like before, whatever is available gets consumed even if there wasn't enough
+	InventoryList.RemoveEntries(InstancesToConsume);
+
+	return InstancesToConsume.Num() == NumToConsume;
 }
 
 void ULyraInventoryManagerComponent::ReadyForReplication()
@@ -16,7 +16,7 @@ struct FLyraInventoryList;
 struct FNetDeltaSerializeInfo;
 struct FReplicationFlags;
 
-/** A message when an item is added to the inventory */
+/** A message when an item is added to the inventory (legacy per-entry message, see Lyra.Inventory.SendPerEntryMessages) */
 USTRUCT(BlueprintType)
 struct FLyraInventoryChangeMessage
 {
@@ -36,6 +36,36 @@ struct FLyraInventoryChangeMessage
 	int32 Delta = 0;
 };
 
+/** The net change to a single item stack over a frame */
+USTRUCT(BlueprintType)
+struct FLyraInventoryChangeDelta
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category=Inventory)
+	TObjectPtr<ULyraInventoryItemInstance> Instance = nullptr;
+
+	UPROPERTY(BlueprintReadOnly, Category=Inventory)
+	int32 OldCount = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category=Inventory)
+	int32 NewCount = 0;
+};
+
+/** A message sent at most once per frame with every item stack that changed in an inventory */
+USTRUCT(BlueprintType)
+struct FLyraInventoryChangeBatchMessage
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category=Inventory)
+	TObjectPtr<UActorComponent> InventoryOwner = nullptr;
+
+	// One entry per changed stack, intermediate counts within the frame are folded away
+	UPROPERTY(BlueprintReadOnly, Category=Inventory)
+	TArray<FLyraInventoryChangeDelta> Changes;
+};
+
 /** A single entry in an inventory */
 USTRUCT(BlueprintType)
 struct FLyraInventoryEntry : public FFastArraySerializerItem
@@ -79,6 +109,27 @@ struct FLyraInventoryList : public FFastArraySerializer
 
 	TArray<ULyraInventoryItemInstance*> GetAllItems() const;
 
+	// Fills OutItems with the instances in the list, reusing its allocation
+	void GetAllItems(TArray<ULyraInventoryItemInstance*>& OutItems) const;
+
+	// Returns the instances of the specified item definition, in the order they were added (the view is invalidated by any change to the list)
+	TConstArrayView<ULyraInventoryItemInstance*> FindItemsByDefinition(TSubclassOf<ULyraInventoryItemDefinition> ItemDef) const;
+
+	// Calls Func for every valid instance in the list without copying it
+	template <typename FuncType>
+	void ForEachItem(FuncType&& Func) const
+	{
+		for (const FLyraInventoryEntry& Entry : Entries)
+		{
+			if (Entry.Instance != nullptr)
+			{
+				Func(Entry.Instance.Get());
+			}
+		}
+	}
+
+	int32 GetNumEntries() const { return Entries.Num(); }
+
 public:
 	//~FFastArraySerializer contract
 	void PreReplicatedRemove(const TArrayView<int32> RemovedIndices, int32 FinalSize);
@@ -96,9 +147,24 @@ public:
 
 	void RemoveEntry(ULyraInventoryItemInstance* Instance);
 
+	// Removes all of the specified instances in a single pass over the list
+	void RemoveEntries(TConstArrayView<ULyraInventoryItemInstance*> Instances);
+
+	// Sends the batched change message for everything recorded since the last flush
+	void FlushChangeMessages();
+
 private:
 	void BroadcastChangeMessage(FLyraInventoryEntry& Entry, int32 OldCount, int32 NewCount);
 
+	// Adds a stack change to the batch, scheduling a flush if this is the first one this frame
+	void RecordChange(ULyraInventoryItemInstance* Instance, int32 OldCount, int32 NewCount);
+
+	void AddToItemIndex(ULyraInventoryItemInstance* Instance);
+	void RemoveFromItemIndex(ULyraInventoryItemInstance* Instance);
+
+	// Rebuilds ItemsByDefinition from the entries if replication has changed them since it was last built
+	void ConditionalRebuildItemIndex() const;
+
 private:
 	friend ULyraInventoryManagerComponent;
 
@@ -109,6 +175,16 @@ private:
 
 	UPROPERTY(NotReplicated)
 	TObjectPtr<UActorComponent> OwnerComponent;
+
+	// Changes waiting to be sent in the next batched change message
+	UPROPERTY(NotReplicated)
+	TArray<FLyraInventoryChangeDelta> PendingChanges;
+
+	// Accelerated lookup from item definition to its instances (the entries keep the instances alive)
+	mutable TMap<const UClass*, TArray<ULyraInventoryItemInstance*>> ItemsByDefinition;
+
+	// Set by the replication callbacks, or while a replicated instance is still waiting on its item definition
+	mutable bool bItemIndexDirty = false;
 };
 
 template<>
@@ -152,6 +228,24 @@ public:
 	UFUNCTION(BlueprintCallable, Category=Inventory, BlueprintPure=false)
 	TArray<ULyraInventoryItemInstance*> GetAllItems() const;
 
+	// Returns the number of entries in the inventory, use with GetItemAtIndex to iterate without copying the item list
+	UFUNCTION(BlueprintCallable, Category=Inventory, BlueprintPure)
+	int32 GetNumItemEntries() const;
+
+	// Returns the item at the specified entry index (or nullptr if the index is out of range)
+	UFUNCTION(BlueprintCallable, Category=Inventory, BlueprintPure)
+	ULyraInventoryItemInstance* GetItemAtIndex(int32 Index) const;
+
+	// Returns the instances of the specified item definition, invalidated by any change to the inventory
+	TConstArrayView<ULyraInventoryItemInstance*> FindItemsByDefinition(TSubclassOf<ULyraInventoryItemDefinition> ItemDef) const;
+
+	// Calls Func for every item in the inventory without copying the item list
+	template <typename FuncType>
+	void ForEachItem(FuncType&& Func) const
+	{
+		InventoryList.ForEachItem(Forward<FuncType>(Func));
+	}
+
 	UFUNCTION(BlueprintCallable, Category=Inventory, BlueprintPure)
 	ULyraInventoryItemInstance* FindFirstItemStackByDefinition(TSubclassOf<ULyraInventoryItemDefinition> ItemDef) const;
 
@@ -164,6 +258,11 @@ public:
 	//~End of UObject interface
 
 private:
+	void HandleFlushChangeMessages();
+
+private:
+	friend FLyraInventoryList;
+
 	UPROPERTY(Replicated)
 	FLyraInventoryList InventoryList;
 };
@@ -4,12 +4,60 @@
 #include "GameFramework/PlayerState.h"
 #include "EngineUtils.h"
 #include "Engine/PlayerStartPIE.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
 #include "LyraPlayerStart.h"
+#include "Teams/LyraTeamSubsystem.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraPlayerSpawningManagerComponent)
 
 DEFINE_LOG_CATEGORY_STATIC(LogPlayerSpawning, Log, All);
 
+namespace LyraSpawningCVars
+{
+	static bool bUseSpawnIndex = true;
+	static FAutoConsoleVariableRef CVarUseSpawnIndex(
+		TEXT("Lyra.Spawning.UseSpawnIndex"),
+		bUseSpawnIndex,
+		TEXT("If true, the default spawn selection uses the scored spawn index instead of checking the occupancy of every player start."),
+		ECVF_Default);
+
+	static float ScoreRadius = 2500.0f;
+	static FAutoConsoleVariableRef CVarScoreRadius(
+		TEXT("Lyra.Spawning.ScoreRadius"),
+		ScoreRadius,
+		TEXT("Radius around a player start in which pawns count against it, also the size of the spawn index grid cells."),
+		ECVF_Default);
+
+	static int32 MaxScoreQueriesPerTick = 32;
+	static FAutoConsoleVariableRef CVarMaxScoreQueriesPerTick(
+		TEXT("Lyra.Spawning.MaxScoreQueriesPerTick"),
+		MaxScoreQueriesPerTick,
+		TEXT("Maximum number of player starts to issue async overlap queries for each spawning manager tick (0 disables scoring)."),
+		ECVF_Default);
+
+	static int32 MaxVisibilityTracesPerStart = 4;
+	static FAutoConsoleVariableRef CVarMaxVisibilityTracesPerStart(
+		TEXT("Lyra.Spawning.MaxVisibilityTracesPerStart"),
+		MaxVisibilityTracesPerStart,
+		TEXT("Maximum number of async line of sight traces from nearby pawns to a player start when scoring it."),
+		ECVF_Default);
+
+	static int32 MaxOccupancyChecks = 8;
+	static FAutoConsoleVariableRef CVarMaxOccupancyChecks(
+		TEXT("Lyra.Spawning.MaxOccupancyChecks"),
+		MaxOccupancyChecks,
+		TEXT("Number of the best scored player starts to run the occupancy check on when choosing a spawn. More are checked if none of them can be used."),
+		ECVF_Default);
+
+	static float VisibleEnemyWeight = 4.0f;
+	static FAutoConsoleVariableRef CVarVisibleEnemyWeight(
+		TEXT("Lyra.Spawning.VisibleEnemyWeight"),
+		VisibleEnemyWeight,
+		TEXT("How much worse an enemy with line of sight to a player start is compared to one that is only nearby."),
+		ECVF_Default);
+}
+
 ULyraPlayerSpawningManagerComponent::ULyraPlayerSpawningManagerComponent(const FObjectInitializer& ObjectInitializer)
 : Super(ObjectInitializer)
 {
@@ -21,6 +69,7 @@ ULyraPlayerSpawningManagerComponent::ULyraPlayerSpawningManagerComponent(const F
 	PrimaryComponentTick.bCanEverTick = true;
 	PrimaryComponentTick.bAllowTickOnDedicatedServer = true;
 	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickInterval = 0.1f;
 }
 
 void ULyraPlayerSpawningManagerComponent::InitializeComponent()
@@ -39,6 +88,15 @@ void ULyraPlayerSpawningManagerComponent::InitializeComponent()
 			CachedPlayerStarts.Add(PlayerStart);
 		}
 	}
+	bPlayerStartIndexDirty = true;
+
+	// Spawns are only chosen on the server, so that's the only place that needs to keep scores up to date
+	if (GetOwner()->HasAuthority())
+	{
+		ScoreOverlapDelegate.BindUObject(this, &ThisClass::HandleScoreOverlap);
+		VisibilityTraceDelegate.BindUObject(this, &ThisClass::HandleVisibilityTrace);
+		UpdateScoringTickEnabled();
+	}
 }
 
 void ULyraPlayerSpawningManagerComponent::OnLevelAdded(ULevel* InLevel, UWorld* InWorld)
@@ -51,6 +109,7 @@ void ULyraPlayerSpawningManagerComponent::OnLevelAdded(ULevel* InLevel, UWorld*
 			{
 				ensure(!CachedPlayerStarts.Contains(PlayerStart));
 				CachedPlayerStarts.Add(PlayerStart);
+				bPlayerStartIndexDirty = true;
 			}
 		}
 	}
@@ -61,6 +120,7 @@ void ULyraPlayerSpawningManagerComponent::HandleOnActorSpawned(AActor* SpawnedAc
 	if (ALyraPlayerStart* PlayerStart = Cast<ALyraPlayerStart>(SpawnedActor))
 	{
 		CachedPlayerStarts.Add(PlayerStart);
+		bPlayerStartIndexDirty = true;
 	}
 }
 
@@ -89,6 +149,7 @@ AActor* ULyraPlayerSpawningManagerComponent::ChoosePlayerStart(AController* Play
 			else
 			{
 				StartIt.RemoveCurrent();
+				bPlayerStartIndexDirty = true;
 			}
 		}
 
@@ -106,11 +167,20 @@ AActor* ULyraPlayerSpawningManagerComponent::ChoosePlayerStart(AController* Play
 			}
 		}
 
+		UpdateScoringTickEnabled();
+
 		AActor* PlayerStart = OnChoosePlayerStart(Player, StarterPoints);
 
 		if (!PlayerStart)
 		{
-			PlayerStart = GetFirstRandomUnoccupiedPlayerStart(Player, StarterPoints);
+			if (LyraSpawningCVars::bUseSpawnIndex)
+			{
+				PlayerStart = ChooseBestPlayerStart(Player, StarterPoints);
+			}
+			else
+			{
+				PlayerStart = GetFirstRandomUnoccupiedPlayerStart(Player, StarterPoints);
+			}
 		}
 
 		if (ALyraPlayerStart* LyraStart = Cast<ALyraPlayerStart>(PlayerStart))
@@ -170,6 +240,355 @@ void ULyraPlayerSpawningManagerComponent::FinishRestartPlayer(AController* NewPl
 void ULyraPlayerSpawningManagerComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (LyraSpawningCVars::bUseSpawnIndex)
+	{
+		ScoreNextPlayerStarts();
+	}
+	else
+	{
+		// Turned back on by the next ChoosePlayerStart if the index gets enabled again
+		SetComponentTickEnabled(false);
+	}
+}
+
+bool ULyraPlayerSpawningManagerComponent::IsSpawnIndexEnabled()
+{
+	return LyraSpawningCVars::bUseSpawnIndex;
+}
+
+void ULyraPlayerSpawningManagerComponent::UpdateScoringTickEnabled()
+{
+	const bool bWantsTick = LyraSpawningCVars::bUseSpawnIndex && GetOwner()->HasAuthority();
+	if (IsComponentTickEnabled() != bWantsTick)
+	{
+		SetComponentTickEnabled(bWantsTick);
+	}
+}
+
+//================================================================
+// Spawn index
+
+FIntPoint ULyraPlayerSpawningManagerComponent::GetGridCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt32(Location.X / GridCellSize), FMath::FloorToInt32(Location.Y / GridCellSize));
+}
+
+void ULyraPlayerSpawningManagerComponent::ConditionalRebuildPlayerStartIndex()
+{
+	const float DesiredCellSize = FMath::Max(LyraSpawningCVars::ScoreRadius, 100.0f);
+	if (!bPlayerStartIndexDirty && (GridCellSize == DesiredCellSize))
+	{
+		return;
+	}
+
+	// Keep the last scores for starts that are still around, they'll be refreshed by the next scoring pass anyways
+	TArray<FLyraIndexedPlayerStart> OldStarts = MoveTemp(IndexedStarts);
+	TMap<TObjectKey<ALyraPlayerStart>, int32> OldLookup = MoveTemp(IndexedStartLookup);
+
+	IndexedStarts.Reset(CachedPlayerStarts.Num());
+	IndexedStartLookup.Reset();
+	IndexedStartsByTag.Reset();
+	IndexedStartsByCell.Reset();
+	GridCellSize = DesiredCellSize;
+
+	for (const TWeakObjectPtr<ALyraPlayerStart>& WeakStart : CachedPlayerStarts)
+	{
+		ALyraPlayerStart* PlayerStart = WeakStart.Get();
+		if ((PlayerStart == nullptr) || IndexedStartLookup.Contains(PlayerStart))
+		{
+			continue;
+		}
+
+		const int32 NewIndex = IndexedStarts.Num();
+		FLyraIndexedPlayerStart& Entry = IndexedStarts.AddDefaulted_GetRef();
+		if (const int32* OldIndex = OldLookup.Find(PlayerStart))
+		{
+			Entry = MoveTemp(OldStarts[*OldIndex]);
+		}
+		Entry.PlayerStart = PlayerStart;
+		Entry.Location = PlayerStart->GetActorLocation();
+
+		IndexedStartLookup.Add(PlayerStart, NewIndex);
+		IndexedStartsByCell.FindOrAdd(GetGridCell(Entry.Location)).Add(NewIndex);
+
+		// Index under the parents too so lookups match the same starts as HasTag
+		for (const FGameplayTag& Tag : PlayerStart->GetGameplayTags())
+		{
+			for (const FGameplayTag& ParentTag : Tag.GetGameplayTagParents())
+			{
+				TArray<int32>& StartsWithTag = IndexedStartsByTag.FindOrAdd(ParentTag);
+				if ((StartsWithTag.Num() == 0) || (StartsWithTag.Last() != NewIndex))
+				{
+					StartsWithTag.Add(NewIndex);
+				}
+			}
+		}
+	}
+
+	NextStartToScore = 0;
+	bPlayerStartIndexDirty = false;
+	++PlayerStartIndexGeneration;
+
+	UE_LOG(LogPlayerSpawning, Verbose, TEXT("Rebuilt spawn index: %d starts, %d cells, %d tags"), IndexedStarts.Num(), IndexedStartsByCell.Num(), IndexedStartsByTag.Num());
+}
+
+void ULyraPlayerSpawningManagerComponent::FindPlayerStartsWithTag(FGameplayTag Tag, TArray<ALyraPlayerStart*>& OutStarts)
+{
+	OutStarts.Reset();
+	ConditionalRebuildPlayerStartIndex();
+
+	if (const TArray<int32>* StartIndices = IndexedStartsByTag.Find(Tag))
+	{
+		OutStarts.Reserve(StartIndices->Num());
+		for (int32 StartIndex : *StartIndices)
+		{
+			if (ALyraPlayerStart* PlayerStart = IndexedStarts[StartIndex].PlayerStart.Get())
+			{
+				OutStarts.Add(PlayerStart);
+			}
+		}
+	}
+}
+
+void ULyraPlayerSpawningManagerComponent::FindPlayerStartsInRadius(const FVector& Location, float Radius, TArray<ALyraPlayerStart*>& OutStarts)
+{
+	OutStarts.Reset();
+	ConditionalRebuildPlayerStartIndex();
+
+	const FIntPoint MinCell = GetGridCell(Location - FVector(Radius));
+	const FIntPoint MaxCell = GetGridCell(Location + FVector(Radius));
+	const float RadiusSquared = FMath::Square(Radius);
+
+	for (int32 CellX = MinCell.X; CellX <= MaxCell.X; ++CellX)
+	{
+		for (int32 CellY = MinCell.Y; CellY <= MaxCell.Y; ++CellY)
+		{
+			if (const TArray<int32>* StartIndices = IndexedStartsByCell.Find(FIntPoint(CellX, CellY)))
+			{
+				for (int32 StartIndex : *StartIndices)
+				{
+					const FLyraIndexedPlayerStart& Entry = IndexedStarts[StartIndex];
+					if (FVector::DistSquared(Entry.Location, Location) <= RadiusSquared)
+					{
+						if (ALyraPlayerStart* PlayerStart = Entry.PlayerStart.Get())
+						{
+							OutStarts.Add(PlayerStart);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+void ULyraPlayerSpawningManagerComponent::ScoreNextPlayerStarts()
+{
+	UWorld* World = GetWorld();
+	if ((World == nullptr) || (LyraSpawningCVars::MaxScoreQueriesPerTick <= 0))
+	{
+		return;
+	}
+
+	ConditionalRebuildPlayerStartIndex();
+	if (IndexedStarts.Num() == 0)
+	{
+		return;
+	}
+
+	// Starts that can't have a pawn within the radius don't need a query at all
+	TSet<FIntPoint> CellsWithPawns;
+	for (TActorIterator<APawn> It(World); It; ++It)
+	{
+		if (It->GetController() != nullptr)
+		{
+			CellsWithPawns.Add(GetGridCell(It->GetActorLocation()));
+		}
+	}
+
+	const FCollisionShape ScoreShape = FCollisionShape::MakeSphere(LyraSpawningCVars::ScoreRadius);
+	const FCollisionObjectQueryParams ObjectParams(ECC_Pawn);
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(LyraSpawnScore), /*bTraceComplex=*/ false);
+
+	const int32 NumToVisit = FMath::Min(IndexedStarts.Num(), LyraSpawningCVars::MaxScoreQueriesPerTick);
+	for (int32 VisitCount = 0; VisitCount < NumToVisit; ++VisitCount)
+	{
+		const int32 StartIndex = NextStartToScore;
+		NextStartToScore = (NextStartToScore + 1) % IndexedStarts.Num();
+
+		FLyraIndexedPlayerStart& Entry = IndexedStarts[StartIndex];
+
+		const FIntPoint Cell = GetGridCell(Entry.Location);
+		bool bPawnsNearby = false;
+		for (int32 OffsetX = -1; (OffsetX <= 1) && !bPawnsNearby; ++OffsetX)
+		{
+			for (int32 OffsetY = -1; (OffsetY <= 1) && !bPawnsNearby; ++OffsetY)
+			{
+				bPawnsNearby = CellsWithPawns.Contains(Cell + FIntPoint(OffsetX, OffsetY));
+			}
+		}
+
+		if (!bPawnsNearby)
+		{
+			Entry.NearbyTeamIds.Reset();
+			Entry.VisibleTeamIds.Reset();
+			continue;
+		}
+
+		// The index generation and the start index share the user data
+		const uint32 UserData = ((uint32)StartIndex & 0x00FFFFFF) | ((uint32)PlayerStartIndexGeneration << 24);
+		World->AsyncOverlapByObjectType(Entry.Location, FQuat::Identity, ObjectParams, ScoreShape, QueryParams, &ScoreOverlapDelegate, UserData);
+	}
+}
+
+void ULyraPlayerSpawningManagerComponent::HandleScoreOverlap(const FTraceHandle& TraceHandle, FOverlapDatum& OverlapDatum)
+{
+	const int32 StartIndex = (int32)(OverlapDatum.UserData & 0x00FFFFFF);
+	const uint8 Generation = (uint8)(OverlapDatum.UserData >> 24);
+	if (bPlayerStartIndexDirty || (Generation != PlayerStartIndexGeneration) || !IndexedStarts.IsValidIndex(StartIndex))
+	{
+		// The index was rebuilt while the query was in flight, so the index may belong to another start now. It will be scored again soon.
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	const ULyraTeamSubsystem* TeamSubsystem = (World != nullptr) ? World->GetSubsystem<ULyraTeamSubsystem>() : nullptr;
+
+	FLyraIndexedPlayerStart& Entry = IndexedStarts[StartIndex];
+	Entry.NearbyTeamIds.Reset();
+	Entry.VisibleTeamIds.Reset();
+
+	int32 NumVisibilityTraces = 0;
+	for (const FOverlapResult& Overlap : OverlapDatum.OutOverlaps)
+	{
+		const APawn* Pawn = Cast<APawn>(Overlap.GetActor());
+		if ((Pawn == nullptr) || (Pawn->GetController() == nullptr))
+		{
+			continue;
+		}
+
+		const int32 TeamId = (TeamSubsystem != nullptr) ? TeamSubsystem->FindTeamFromObject(Pawn) : INDEX_NONE;
+		Entry.NearbyTeamIds.Add(TeamId);
+
+		if ((NumVisibilityTraces < LyraSpawningCVars::MaxVisibilityTracesPerStart) && (TeamId < 255) && (StartIndex <= 0xFFFF))
+		{
+			++NumVisibilityTraces;
+
+			FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(LyraSpawnVisibility), /*bTraceComplex=*/ false, Pawn);
+
+			// The start index, the team (offset so INDEX_NONE fits) and the index generation share the user data
+			const uint32 UserData = ((uint32)StartIndex & 0x0000FFFF) | (((uint32)(TeamId + 1) & 0xFF) << 16) | ((uint32)PlayerStartIndexGeneration << 24);
+			World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Pawn->GetPawnViewLocation(), Entry.Location, ECC_Visibility, TraceParams, FCollisionResponseParams::DefaultResponseParam, &VisibilityTraceDelegate, UserData);
+		}
+	}
+}
+
+void ULyraPlayerSpawningManagerComponent::HandleVisibilityTrace(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	const int32 StartIndex = (int32)(TraceDatum.UserData & 0x0000FFFF);
+	const int32 TeamId = (int32)((TraceDatum.UserData >> 16) & 0xFF) - 1;
+	const uint8 Generation = (uint8)(TraceDatum.UserData >> 24);
+	if (bPlayerStartIndexDirty || (Generation != PlayerStartIndexGeneration) || !IndexedStarts.IsValidIndex(StartIndex))
+	{
+		return;
+	}
+
+	const bool bBlocked = TraceDatum.OutHits.ContainsByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; });
+	if (!bBlocked)
+	{
+		IndexedStarts[StartIndex].VisibleTeamIds.Add(TeamId);
+	}
+}
+
+ALyraPlayerStart* ULyraPlayerSpawningManagerComponent::ChooseBestPlayerStart(AController* Player, TConstArrayView<ALyraPlayerStart*> Candidates)
+{
+	if ((Player == nullptr) || (Candidates.Num() == 0))
+	{
+		return nullptr;
+	}
+
+	ConditionalRebuildPlayerStartIndex();
+
+	const ULyraTeamSubsystem* TeamSubsystem = GetWorld()->GetSubsystem<ULyraTeamSubsystem>();
+	const int32 PlayerTeamId = (TeamSubsystem != nullptr) ? TeamSubsystem->FindTeamFromObject(Player) : INDEX_NONE;
+
+	// Anyone not known to be on our team is a threat
+	auto CountEnemies = [PlayerTeamId](TConstArrayView<int32> TeamIds)
+	{
+		int32 NumEnemies = 0;
+		for (int32 TeamId : TeamIds)
+		{
+			if ((PlayerTeamId == INDEX_NONE) || (TeamId != PlayerTeamId))
+			{
+				++NumEnemies;
+			}
+		}
+		return NumEnemies;
+	};
+
+	struct FScoredStart
+	{
+		ALyraPlayerStart* PlayerStart;
+		float Danger;
+	};
+
+	TArray<FScoredStart, TInlineAllocator<64>> ScoredStarts;
+	ScoredStarts.Reserve(Candidates.Num());
+	for (ALyraPlayerStart* PlayerStart : Candidates)
+	{
+		if (PlayerStart == nullptr)
+		{
+			continue;
+		}
+
+		// Claimed starts are a last resort, e.g., when more players respawn at once than there are starts
+		float Danger = PlayerStart->IsClaimed() ? 10000.0f : 0.0f;
+		if (const int32* StartIndex = IndexedStartLookup.Find(PlayerStart))
+		{
+			const FLyraIndexedPlayerStart& Entry = IndexedStarts[*StartIndex];
+			Danger += CountEnemies(Entry.NearbyTeamIds) + (LyraSpawningCVars::VisibleEnemyWeight * CountEnemies(Entry.VisibleTeamIds));
+		}
+
+		// Jitter so equally safe starts are picked at random
+		ScoredStarts.Add({ PlayerStart, Danger + FMath::FRand() * 0.5f });
+	}
+
+	if (ScoredStarts.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	ScoredStarts.Sort([](const FScoredStart& A, const FScoredStart& B) { return A.Danger < B.Danger; });
+
+	const int32 NumToCheck = FMath::Clamp(LyraSpawningCVars::MaxOccupancyChecks, 1, ScoredStarts.Num());
+
+	// The budget only bounds the search while there's a usable start to fall back on. Starts next to teammates
+	// score as safe, so the best ranked starts can all be Full and we have to keep looking past them.
+	ALyraPlayerStart* FirstPartialStart = nullptr;
+	for (int32 Index = 0; Index < ScoredStarts.Num(); ++Index)
+	{
+		if ((Index >= NumToCheck) && (FirstPartialStart != nullptr))
+		{
+			break;
+		}
+
+		ALyraPlayerStart* PlayerStart = ScoredStarts[Index].PlayerStart;
+		switch (PlayerStart->GetLocationOccupancy(Player))
+		{
+		case ELyraPlayerStartLocationOccupancy::Empty:
+			return PlayerStart;
+		case ELyraPlayerStartLocationOccupancy::Partial:
+			if (FirstPartialStart == nullptr)
+			{
+				FirstPartialStart = PlayerStart;
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	return FirstPartialStart;
 }
 
 APlayerStart* ULyraPlayerSpawningManagerComponent::GetFirstRandomUnoccupiedPlayerStart(AController* Controller, const TArray<ALyraPlayerStart*>& StartPoints) const
@@ -3,6 +3,8 @@
 #pragma once
 
 #include "Components/GameStateComponent.h"
+#include "GameplayTagContainer.h"
+#include "WorldCollision.h"
 
 #include "LyraPlayerSpawningManagerComponent.generated.h"
 
@@ -13,6 +15,19 @@ class APlayerStart;
 class ALyraPlayerStart;
 class AActor;
 
+// A player start in the spawn index, along with the last known threat around it
+struct FLyraIndexedPlayerStart
+{
+	TWeakObjectPtr<ALyraPlayerStart> PlayerStart;
+	FVector Location = FVector::ZeroVector;
+
+	// Teams of the pawns that were within the scoring radius the last time this start was scored
+	TArray<int32, TInlineAllocator<4>> NearbyTeamIds;
+
+	// Teams of the nearby pawns that had line of sight to the start
+	TArray<int32, TInlineAllocator<4>> VisibleTeamIds;
+};
+
 /**
  * @class ULyraPlayerSpawningManagerComponent
  */
@@ -29,9 +44,22 @@ public:
 	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 	/** ~UActorComponent */
 
+	// Returns the player starts with the specified tag (or a child of it), from the spawn index
+	void FindPlayerStartsWithTag(FGameplayTag Tag, TArray<ALyraPlayerStart*>& OutStarts);
+
+	// Returns the player starts within Radius of Location, from the spawn index
+	void FindPlayerStartsInRadius(const FVector& Location, float Radius, TArray<ALyraPlayerStart*>& OutStarts);
+
 protected:
 	// Utility
 	APlayerStart* GetFirstRandomUnoccupiedPlayerStart(AController* Controller, const TArray<ALyraPlayerStart*>& FoundStartPoints) const;
+
+	// Picks the start (preferring unclaimed ones) with the fewest enemies near it or looking at it, using the scores from the last async queries.
+	// Usually only the best few candidates get the (synchronous) occupancy check, lower ranked ones are only checked if all of those are Full.
+	ALyraPlayerStart* ChooseBestPlayerStart(AController* Player, TConstArrayView<ALyraPlayerStart*> Candidates);
+
+	// Returns true if spawns should be chosen with the scored spawn index (Lyra.Spawning.UseSpawnIndex)
+	static bool IsSpawnIndexEnabled();
 	
 	virtual AActor* OnChoosePlayerStart(AController* Player, TArray<ALyraPlayerStart*>& PlayerStarts) { return nullptr; }
 	virtual void OnFinishRestartPlayer(AController* Player, const FRotator& StartRotation) { }
@@ -55,6 +83,34 @@ private:
 	void OnLevelAdded(ULevel* InLevel, UWorld* InWorld);
 	void HandleOnActorSpawned(AActor* SpawnedActor);
 
+	void ConditionalRebuildPlayerStartIndex();
+	FIntPoint GetGridCell(const FVector& Location) const;
+
+	// Issues async overlaps for the next batch of starts that have pawns close enough to matter
+	void ScoreNextPlayerStarts();
+	void HandleScoreOverlap(const FTraceHandle& TraceHandle, FOverlapDatum& OverlapDatum);
+	void HandleVisibilityTrace(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	// Turns the scoring tick on or off to match Lyra.Spawning.UseSpawnIndex
+	void UpdateScoringTickEnabled();
+
+	// Spawn index, rebuilt when starts are added or removed
+	TArray<FLyraIndexedPlayerStart> IndexedStarts;
+	TMap<TObjectKey<ALyraPlayerStart>, int32> IndexedStartLookup;
+	TMap<FGameplayTag, TArray<int32>> IndexedStartsByTag;
+	TMap<FIntPoint, TArray<int32>> IndexedStartsByCell;
+	float GridCellSize = 0.0f;
+	bool bPlayerStartIndexDirty = true;
+
+	// Bumped every rebuild and packed in the async query user data, results from an older index are dropped
+	uint8 PlayerStartIndexGeneration = 0;
+
+	// Round robin position for scoring
+	int32 NextStartToScore = 0;
+
+	FOverlapDelegate ScoreOverlapDelegate;
+	FTraceDelegate VisibilityTraceDelegate;
+
 #if WITH_EDITOR
 	APlayerStart* FindPlayFromHereStart(AController* Player);
 #endif
@@ -27,21 +27,9 @@ void FGameplayTagStackContainer::AddStack(FGameplayTag Tag, int32 StackCount)
 
 	if (StackCount > 0)
 	{
-		for (FGameplayTagStack& Stack : Stacks)
-		{
-			if (Stack.Tag == Tag)
-			{
-				const int32 NewCount = Stack.StackCount + StackCount;
-				Stack.StackCount = NewCount;
-				TagToCountMap[Tag] = NewCount;
-				MarkItemDirty(Stack);
-				return;
-			}
-		}
-
-		FGameplayTagStack& NewStack = Stacks.Emplace_GetRef(Tag, StackCount);
-		MarkItemDirty(NewStack);
-		TagToCountMap.Add(Tag, StackCount);
+		bool bRemoved = false;
+		const int32 StackIndex = ModifyStackInternal(Tag, StackCount, /*out*/ bRemoved);
+		MarkItemDirty(Stacks[StackIndex]);
 	}
 }
 
@@ -56,37 +44,133 @@ void FGameplayTagStackContainer::RemoveStack(FGameplayTag Tag, int32 StackCount)
 	//@TODO: Should we error if you try to remove a stack that doesn't exist or has a smaller count?
 	if (StackCount > 0)
 	{
-		for (auto It = Stacks.CreateIterator(); It; ++It)
+		bool bRemoved = false;
+		const int32 StackIndex = ModifyStackInternal(Tag, -StackCount, /*out*/ bRemoved);
+		if (bRemoved)
+		{
+			MarkArrayDirty();
+		}
+		else if (StackIndex != INDEX_NONE)
+		{
+			MarkItemDirty(Stacks[StackIndex]);
+		}
+	}
+}
+
+void FGameplayTagStackContainer::ApplyStackDeltas(TConstArrayView<TPair<FGameplayTag, int32>> TagDeltas)
+{
+	// Combine the changes per tag first so a stack touched several times is only modified (and dirtied) once
+	TArray<TPair<FGameplayTag, int32>, TInlineAllocator<8>> CombinedDeltas;
+	for (const TPair<FGameplayTag, int32>& TagDelta : TagDeltas)
+	{
+		if (!TagDelta.Key.IsValid())
+		{
+			FFrame::KismetExecutionMessage(TEXT("An invalid tag was passed to ApplyStackDeltas"), ELogVerbosity::Warning);
+			continue;
+		}
+
+		if (TPair<FGameplayTag, int32>* Existing = CombinedDeltas.FindByPredicate([&TagDelta](const TPair<FGameplayTag, int32>& Entry) { return Entry.Key == TagDelta.Key; }))
+		{
+			Existing->Value += TagDelta.Value;
+		}
+		else
+		{
+			CombinedDeltas.Add(TagDelta);
+		}
+	}
+
+	bool bAnyRemoved = false;
+	bool bAnyModified = false;
+
+	for (const TPair<FGameplayTag, int32>& TagDelta : CombinedDeltas)
+	{
+		if (TagDelta.Value != 0)
+		{
+			bool bRemoved = false;
+			bAnyModified |= (ModifyStackInternal(TagDelta.Key, TagDelta.Value, /*out*/ bRemoved) != INDEX_NONE);
+			bAnyRemoved |= bRemoved;
+		}
+	}
+
+	if (bAnyRemoved)
+	{
+		MarkArrayDirty();
+	}
+
+	// Removals may have swapped modified stacks into different slots, so look them up again by tag
+	if (bAnyModified)
+	{
+		for (const TPair<FGameplayTag, int32>& TagDelta : CombinedDeltas)
 		{
-			FGameplayTagStack& Stack = *It;
-			if (Stack.Tag == Tag)
+			if (const int32* StackIndex = (TagDelta.Value != 0) ? TagToIndexMap.Find(TagDelta.Key) : nullptr)
 			{
-				if (Stack.StackCount <= StackCount)
-				{
-					It.RemoveCurrent();
-					TagToCountMap.Remove(Tag);
-					MarkArrayDirty();
-				}
-				else
-				{
-					const int32 NewCount = Stack.StackCount - StackCount;
-					Stack.StackCount = NewCount;
-					TagToCountMap[Tag] = NewCount;
-					MarkItemDirty(Stack);
-				}
-				return;
+				MarkItemDirty(Stacks[*StackIndex]);
 			}
 		}
 	}
 }
 
+int32 FGameplayTagStackContainer::ModifyStackInternal(FGameplayTag Tag, int32 Delta, bool& bOutRemoved)
+{
+	bOutRemoved = false;
+
+	if (const int32* ExistingIndex = TagToIndexMap.Find(Tag))
+	{
+		const int32 StackIndex = *ExistingIndex;
+		FGameplayTagStack& Stack = Stacks[StackIndex];
+
+		if (Stack.StackCount + Delta <= 0)
+		{
+			RemoveStackAtSwap(StackIndex);
+			bOutRemoved = true;
+			return INDEX_NONE;
+		}
+
+		Stack.StackCount += Delta;
+		return StackIndex;
+	}
+	else if (Delta > 0)
+	{
+		const int32 StackIndex = Stacks.Emplace(Tag, Delta);
+		TagToIndexMap.Add(Tag, StackIndex);
+		return StackIndex;
+	}
+
+	return INDEX_NONE;
+}
+
+void FGameplayTagStackContainer::RemoveStackAtSwap(int32 StackIndex)
+{
+	TagToIndexMap.Remove(Stacks[StackIndex].Tag);
+
+	// Fast arrays identify items by replication ID rather than position, so the order is free to change
+	Stacks.RemoveAtSwap(StackIndex);
+
+	if (Stacks.IsValidIndex(StackIndex))
+	{
+		TagToIndexMap.Add(Stacks[StackIndex].Tag, StackIndex);
+	}
+}
+
+void FGameplayTagStackContainer::RebuildTagToIndexMap()
+{
+	TagToIndexMap.Reset();
+	for (int32 StackIndex = 0; StackIndex < Stacks.Num(); ++StackIndex)
+	{
+		TagToIndexMap.Add(Stacks[StackIndex].Tag, StackIndex);
+	}
+}
+
 void FGameplayTagStackContainer::PreReplicatedRemove(const TArrayView<int32> RemovedIndices, int32 FinalSize)
 {
 	for (int32 Index : RemovedIndices)
 	{
 		const FGameplayTag Tag = Stacks[Index].Tag;
-		TagToCountMap.Remove(Tag);
+		TagToIndexMap.Remove(Tag);
 	}
+
+	// The removed items are swapped out after the add and change callbacks, fix up the indices once that's done
+	bNeedsIndexRebuild = true;
 }
 
 void FGameplayTagStackContainer::PostReplicatedAdd(const TArrayView<int32> AddedIndices, int32 FinalSize)
@@ -94,16 +178,20 @@ void FGameplayTagStackContainer::PostReplicatedAdd(const TArrayView<int32> Added
 	for (int32 Index : AddedIndices)
 	{
 		const FGameplayTagStack& Stack = Stacks[Index];
-		TagToCountMap.Add(Stack.Tag, Stack.StackCount);
+		TagToIndexMap.Add(Stack.Tag, Index);
 	}
 }
 
 void FGameplayTagStackContainer::PostReplicatedChange(const TArrayView<int32> ChangedIndices, int32 FinalSize)
 {
-	for (int32 Index : ChangedIndices)
+	// The map only stores indices, the counts are read straight from the stacks
+}
+
+void FGameplayTagStackContainer::PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters)
+{
+	if (bNeedsIndexRebuild)
 	{
-		const FGameplayTagStack& Stack = Stacks[Index];
-		TagToCountMap[Stack.Tag] = Stack.StackCount;
+		bNeedsIndexRebuild = false;
+		RebuildTagToIndexMap();
 	}
 }
-
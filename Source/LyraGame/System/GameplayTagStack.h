@@ -57,22 +57,28 @@ public:
 	// Removes a specified number of stacks from the tag (does nothing if StackCount is below 1)
 	void RemoveStack(FGameplayTag Tag, int32 StackCount);
 
+	// Applies a batch of stack count changes (positive adds stacks, negative removes them)
+	// Changes to the same tag are combined, so each stack is only marked dirty once
+	void ApplyStackDeltas(TConstArrayView<TPair<FGameplayTag, int32>> TagDeltas);
+
 	// Returns the stack count of the specified tag (or 0 if the tag is not present)
 	int32 GetStackCount(FGameplayTag Tag) const
 	{
-		return TagToCountMap.FindRef(Tag);
+		const int32* StackIndex = TagToIndexMap.Find(Tag);
+		return (StackIndex != nullptr) ? Stacks[*StackIndex].StackCount : 0;
 	}
 
 	// Returns true if there is at least one stack of the specified tag
 	bool ContainsTag(FGameplayTag Tag) const
 	{
-		return TagToCountMap.Contains(Tag);
+		return TagToIndexMap.Contains(Tag);
 	}
 
 	//~FFastArraySerializer contract
 	void PreReplicatedRemove(const TArrayView<int32> RemovedIndices, int32 FinalSize);
 	void PostReplicatedAdd(const TArrayView<int32> AddedIndices, int32 FinalSize);
 	void PostReplicatedChange(const TArrayView<int32> ChangedIndices, int32 FinalSize);
+	void PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters);
 	//~End of FFastArraySerializer contract
 
 	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
@@ -80,13 +86,25 @@ public:
 		return FFastArraySerializer::FastArrayDeltaSerialize<FGameplayTagStack, FGameplayTagStackContainer>(Stacks, DeltaParms, *this);
 	}
 
+private:
+	// Adds or removes stacks without marking anything dirty, returns the index of the stack if it still exists (or INDEX_NONE)
+	int32 ModifyStackInternal(FGameplayTag Tag, int32 Delta, bool& bOutRemoved);
+
+	// Removes the stack at the specified index by swapping the last stack into its place
+	void RemoveStackAtSwap(int32 StackIndex);
+
+	void RebuildTagToIndexMap();
+
 private:
 	// Replicated list of gameplay tag stacks
 	UPROPERTY()
 	TArray<FGameplayTagStack> Stacks;
 	
-	// Accelerated list of tag stacks for queries
-	TMap<FGameplayTag, int32> TagToCountMap;
+	// Accelerated lookup from tag to its index in Stacks
+	TMap<FGameplayTag, int32> TagToIndexMap;
+
+	// Set when replicated removals will reorder Stacks, the map is rebuilt once the update has been received
+	bool bNeedsIndexRebuild = false;
 };
 
 template<>
@@ -12,6 +12,8 @@
 #include "AbilitySystem/LyraGameplayCueManager.h"
 #include "Misc/ScopedSlowTask.h"
 #include "System/LyraAssetManagerStartupJob.h"
+#include "Tasks/Task.h"
+#include "HAL/PlatformStackWalk.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraAssetManager)
 
@@ -25,10 +27,45 @@ static FAutoConsoleCommand CVarDumpLoadedAssets(
 	FConsoleCommandDelegate::CreateStatic(ULyraAssetManager::DumpLoadedAssets)
 );
 
+static FAutoConsoleCommand CVarDumpSyncLoadAudit(
+	TEXT("Lyra.DumpSyncLoadAudit"),
+	TEXT("Shows the synchronous loads recorded during gameplay, worst offenders first."),
+	FConsoleCommandDelegate::CreateStatic(ULyraAssetManager::DumpSyncLoadAudit)
+);
+
+namespace LyraAssetManagerCVars
+{
+	// Recording a callstack adds to the hitch being audited, so shipping and test builds only audit when asked to
+#if UE_BUILD_SHIPPING || UE_BUILD_TEST
+	static int32 SyncLoadAuditPolicy = (int32)ELyraSyncLoadAuditPolicy::Disabled;
+#else
+	static int32 SyncLoadAuditPolicy = (int32)ELyraSyncLoadAuditPolicy::Log;
+#endif
+	static FAutoConsoleVariableRef CVarSyncLoadAuditPolicy(
+		TEXT("Lyra.AssetManager.SyncLoadAuditPolicy"),
+		SyncLoadAuditPolicy,
+		TEXT("What to do with synchronous loads done by ULyraAssetManager after an experience has loaded.\n")
+		TEXT("0: Disabled (default in shipping and test builds), 1: Record and log (default otherwise), 2: Record and ensure, 3: Record and refuse the load"),
+		ECVF_Default);
+
+	static int32 SyncLoadAuditReportSize = 20;
+	static FAutoConsoleVariableRef CVarSyncLoadAuditReportSize(
+		TEXT("Lyra.AssetManager.SyncLoadAuditReportSize"),
+		SyncLoadAuditReportSize,
+		TEXT("Number of assets listed in the synchronous load audit report."),
+		ECVF_Default);
+
+	static ELyraSyncLoadAuditPolicy GetSyncLoadAuditPolicy()
+	{
+		return (ELyraSyncLoadAuditPolicy)FMath::Clamp(SyncLoadAuditPolicy, (int32)ELyraSyncLoadAuditPolicy::Disabled, (int32)ELyraSyncLoadAuditPolicy::Fail);
+	}
+}
+
 //////////////////////////////////////////////////////////////////////
 
 #define STARTUP_JOB_WEIGHTED(JobFunc, JobWeight) StartupJobs.Add(FLyraAssetManagerStartupJob(#JobFunc, [this](const FLyraAssetManagerStartupJob& StartupJob, TSharedPtr<FStreamableHandle>& LoadHandle){JobFunc;}, JobWeight))
 #define STARTUP_JOB(JobFunc) STARTUP_JOB_WEIGHTED(JobFunc, 1.f)
+#define STARTUP_JOB_DEPENDS_ON(JobFunc) StartupJobs.Last().Dependencies.Add(TEXT(#JobFunc))
 
 //////////////////////////////////////////////////////////////////////
 
@@ -65,6 +102,20 @@ UObject* ULyraAssetManager::SynchronousLoadAsset(const FSoftObjectPath& AssetPat
 
 		if (UAssetManager::IsInitialized())
 		{
+			ULyraAssetManager& AssetManager = Get();
+			if (AssetManager.bSyncLoadAuditActive)
+			{
+				if (!AssetManager.BeginAuditedSynchronousLoad(AssetPath))
+				{
+					return nullptr;
+				}
+
+				const double LoadStartTime = FPlatformTime::Seconds();
+				UObject* LoadedObject = UAssetManager::GetStreamableManager().LoadSynchronous(AssetPath, false);
+				AssetManager.EndAuditedSynchronousLoad(AssetPath, FPlatformTime::Seconds() - LoadStartTime);
+				return LoadedObject;
+			}
+
 			return UAssetManager::GetStreamableManager().LoadSynchronous(AssetPath, false);
 		}
 
@@ -75,6 +126,161 @@ UObject* ULyraAssetManager::SynchronousLoadAsset(const FSoftObjectPath& AssetPat
 	return nullptr;
 }
 
+TSharedPtr<FStreamableHandle> ULyraAssetManager::AsynchronousLoadAsset(const FSoftObjectPath& AssetPath, TFunction<void(UObject*)>&& Callback, bool bKeepInMemory)
+{
+	if (!AssetPath.IsValid())
+	{
+		Callback(nullptr);
+		return nullptr;
+	}
+
+	if (UObject* LoadedObject = AssetPath.ResolveObject())
+	{
+		if (bKeepInMemory)
+		{
+			Get().AddLoadedAsset(LoadedObject);
+		}
+
+		Callback(LoadedObject);
+		return nullptr;
+	}
+
+	return UAssetManager::GetStreamableManager().RequestAsyncLoad(AssetPath, FStreamableDelegate::CreateLambda([AssetPath, Callback = MoveTemp(Callback), bKeepInMemory]()
+		{
+			UObject* LoadedObject = AssetPath.ResolveObject();
+			ensureAlwaysMsgf(LoadedObject, TEXT("Failed to load asset [%s]"), *AssetPath.ToString());
+
+			if (LoadedObject && bKeepInMemory)
+			{
+				Get().AddLoadedAsset(LoadedObject);
+			}
+
+			Callback(LoadedObject);
+		}), FStreamableManager::DefaultAsyncLoadPriority, false, false, TEXT("ULyraAssetManager::AsynchronousLoadAsset"));
+}
+
+bool ULyraAssetManager::BeginAuditedSynchronousLoad(const FSoftObjectPath& AssetPath)
+{
+	const ELyraSyncLoadAuditPolicy Policy = LyraAssetManagerCVars::GetSyncLoadAuditPolicy();
+	if (Policy == ELyraSyncLoadAuditPolicy::Disabled)
+	{
+		return true;
+	}
+
+	const FString Message = FString::Printf(TEXT("Synchronous load of [%s] during gameplay, use GetAssetAsync or preload it with the experience"), *AssetPath.ToString());
+
+	switch (Policy)
+	{
+	case ELyraSyncLoadAuditPolicy::Log:
+		UE_LOG(LogLyra, Warning, TEXT("%s"), *Message);
+		break;
+	case ELyraSyncLoadAuditPolicy::Ensure:
+		ensureAlwaysMsgf(false, TEXT("%s"), *Message);
+		break;
+	case ELyraSyncLoadAuditPolicy::Fail:
+		UE_LOG(LogLyra, Error, TEXT("%s (refused by Lyra.AssetManager.SyncLoadAuditPolicy)"), *Message);
+		break;
+	default:
+		break;
+	}
+
+	FScopeLock SyncLoadAuditLock(&SyncLoadAuditCritical);
+
+	FLyraSyncLoadAuditRecord& Record = SyncLoadAuditRecords.FindOrAdd(AssetPath);
+	if (Record.LoadCount == 0)
+	{
+		Record.AssetPath = AssetPath;
+
+		// Only capture the raw frames here, they're symbolicated when the report is written
+		Record.CallstackFrames.SetNumZeroed(FLyraSyncLoadAuditRecord::MaxCallstackDepth);
+		const uint32 Depth = FPlatformStackWalk::CaptureStackBackTrace(Record.CallstackFrames.GetData(), FLyraSyncLoadAuditRecord::MaxCallstackDepth);
+		Record.CallstackFrames.SetNum(Depth);
+	}
+
+	Record.LoadCount++;
+
+	return (Policy != ELyraSyncLoadAuditPolicy::Fail);
+}
+
+void ULyraAssetManager::EndAuditedSynchronousLoad(const FSoftObjectPath& AssetPath, double Seconds)
+{
+	FScopeLock SyncLoadAuditLock(&SyncLoadAuditCritical);
+
+	if (FLyraSyncLoadAuditRecord* Record = SyncLoadAuditRecords.Find(AssetPath))
+	{
+		Record->TotalSeconds += Seconds;
+		Record->MaxSeconds = FMath::Max(Record->MaxSeconds, Seconds);
+	}
+}
+
+void ULyraAssetManager::SetSyncLoadAuditActive(bool bActive)
+{
+	// Several worlds can be playing an experience at once in PIE, so the audit runs while any of them is
+	SyncLoadAuditRefCount = FMath::Max(0, SyncLoadAuditRefCount + (bActive ? 1 : -1));
+
+	const bool bShouldBeActive = (SyncLoadAuditRefCount > 0);
+	if (bSyncLoadAuditActive == bShouldBeActive)
+	{
+		return;
+	}
+
+	if (!bShouldBeActive)
+	{
+		// Report at the end of every match so the worst offenders can be migrated to async loads
+		DumpSyncLoadAudit();
+	}
+
+	FScopeLock SyncLoadAuditLock(&SyncLoadAuditCritical);
+	bSyncLoadAuditActive = bShouldBeActive;
+	SyncLoadAuditRecords.Reset();
+}
+
+void ULyraAssetManager::DumpSyncLoadAudit()
+{
+	ULyraAssetManager& AssetManager = Get();
+
+	TArray<FLyraSyncLoadAuditRecord> Records;
+	{
+		FScopeLock SyncLoadAuditLock(&AssetManager.SyncLoadAuditCritical);
+		AssetManager.SyncLoadAuditRecords.GenerateValueArray(Records);
+	}
+
+	if (Records.Num() == 0)
+	{
+		return;
+	}
+
+	Records.Sort([](const FLyraSyncLoadAuditRecord& A, const FLyraSyncLoadAuditRecord& B) { return A.TotalSeconds > B.TotalSeconds; });
+
+	double TotalSeconds = 0.0;
+	for (const FLyraSyncLoadAuditRecord& Record : Records)
+	{
+		TotalSeconds += Record.TotalSeconds;
+	}
+
+	UE_LOG(LogLyra, Log, TEXT("========== Start Synchronous Load Audit =========="));
+
+	const int32 NumToReport = FMath::Min(Records.Num(), FMath::Max(1, LyraAssetManagerCVars::SyncLoadAuditReportSize));
+	for (int32 Index = 0; Index < NumToReport; ++Index)
+	{
+		const FLyraSyncLoadAuditRecord& Record = Records[Index];
+		UE_LOG(LogLyra, Log, TEXT("  %s: %d loads, %.2f ms total, %.2f ms max"), *Record.AssetPath.ToString(), Record.LoadCount, Record.TotalSeconds * 1000.0, Record.MaxSeconds * 1000.0);
+
+		// Skip the frames inside the asset manager
+		const int32 FirstFrame = 2;
+		for (int32 FrameIndex = FirstFrame; FrameIndex < Record.CallstackFrames.Num(); ++FrameIndex)
+		{
+			ANSICHAR FrameString[1024];
+			FrameString[0] = 0;
+			FPlatformStackWalk::ProgramCounterToHumanReadableString(FrameIndex - FirstFrame, Record.CallstackFrames[FrameIndex], FrameString, UE_ARRAY_COUNT(FrameString));
+			UE_LOG(LogLyra, Log, TEXT("    %s"), ANSI_TO_TCHAR(FrameString));
+		}
+	}
+
+	UE_LOG(LogLyra, Log, TEXT("... %d assets synchronously loaded during gameplay, %.2f ms in total"), Records.Num(), TotalSeconds * 1000.0);
+	UE_LOG(LogLyra, Log, TEXT("========== Finish Synchronous Load Audit =========="));
+}
+
 bool ULyraAssetManager::ShouldLogAssetLoads()
 {
 	static bool bLogAssetLoads = FParse::Param(FCommandLine::Get(), TEXT("LogAssetLoads"));
@@ -110,11 +316,15 @@ void ULyraAssetManager::StartInitialLoading()
 	// This does all of the scanning, need to do this now even if loads are deferred
 	Super::StartInitialLoading();
 
+	// Start streaming the game data in so it loads while the other startup jobs run
+	STARTUP_JOB_WEIGHTED(LoadHandle = StartGameDataLoad(), 25.f);
+
 	STARTUP_JOB(InitializeGameplayCueManager());
 
 	{
 		// Load base game data asset
-		STARTUP_JOB_WEIGHTED(GetGameData(), 25.f);
+		STARTUP_JOB(GetGameData());
+		STARTUP_JOB_DEPENDS_ON(LoadHandle = StartGameDataLoad());
 	}
 //@TODO: bringfiregames added this next line to fix error with TargetData!
 	UAbilitySystemGlobals::Get().InitGlobalData();
@@ -133,6 +343,17 @@ void ULyraAssetManager::InitializeGameplayCueManager()
 }
 
 
+TSharedPtr<FStreamableHandle> ULyraAssetManager::StartGameDataLoad()
+{
+	// In the editor the game data is loaded on demand from PostLoad, see LoadGameDataOfClass
+	if (GIsEditor || LyraGameDataPath.IsNull())
+	{
+		return nullptr;
+	}
+
+	return LoadPrimaryAssetsWithType(ULyraGameData::StaticClass()->GetFName());
+}
+
 const ULyraGameData& ULyraAssetManager::GetGameData()
 {
 	return GetOrLoadTypedGameData<ULyraGameData>(LyraGameDataPath);
@@ -197,51 +418,210 @@ void ULyraAssetManager::DoAllStartupJobs()
 	SCOPED_BOOT_TIMING("ULyraAssetManager::DoAllStartupJobs");
 	const double AllStartupJobsStartTime = FPlatformTime::Seconds();
 
-	if (IsRunningDedicatedServer())
+	// No need for periodic progress updates on a dedicated server
+	const bool bReportProgress = !IsRunningDedicatedServer();
+
+	enum class EJobState : uint8
+	{
+		Pending,
+		Running,
+		Complete
+	};
+
+	struct FJobRunState
 	{
-		// No need for periodic progress updates, just run the jobs
-		for (const FLyraAssetManagerStartupJob& StartupJob : StartupJobs)
+		EJobState State = EJobState::Pending;
+		TSharedPtr<FStreamableHandle> Handle;
+		UE::Tasks::FTask Task;
+		TArray<int32> DependencyIndices;
+		float SubstepProgress = 0.0f;
+	};
+
+	const int32 NumJobs = StartupJobs.Num();
+	TArray<FJobRunState> RunStates;
+	RunStates.SetNum(NumJobs);
+
+	float TotalJobValue = 0.0f;
+	for (int32 JobIndex = 0; JobIndex < NumJobs; ++JobIndex)
+	{
+		const FLyraAssetManagerStartupJob& StartupJob = StartupJobs[JobIndex];
+		TotalJobValue += StartupJob.JobWeight;
+
+		for (const FString& DependencyName : StartupJob.Dependencies)
 		{
-			StartupJob.DoJob();
+			const int32 DependencyIndex = StartupJobs.IndexOfByPredicate([&DependencyName](const FLyraAssetManagerStartupJob& Job) { return Job.JobName == DependencyName; });
+			if ((DependencyIndex != INDEX_NONE) && (DependencyIndex != JobIndex))
+			{
+				RunStates[JobIndex].DependencyIndices.Add(DependencyIndex);
+			}
+			else
+			{
+				UE_LOG(LogLyra, Error, TEXT("Startup job \"%s\" depends on unknown job \"%s\", ignoring the dependency"), *StartupJob.JobName, *DependencyName);
+			}
 		}
 	}
-	else
+
+	auto UpdateProgress = [&]()
 	{
-		if (StartupJobs.Num() > 0)
+		if (bReportProgress && (TotalJobValue > 0.0f))
 		{
-			float TotalJobValue = 0.0f;
-			for (const FLyraAssetManagerStartupJob& StartupJob : StartupJobs)
+			float AccumulatedJobValue = 0.0f;
+			for (int32 JobIndex = 0; JobIndex < NumJobs; ++JobIndex)
 			{
-				TotalJobValue += StartupJob.JobWeight;
+				const FJobRunState& RunState = RunStates[JobIndex];
+				const float JobProgress = (RunState.State == EJobState::Complete) ? 1.0f : FMath::Clamp(RunState.SubstepProgress, 0.0f, 1.0f);
+				AccumulatedJobValue += JobProgress * StartupJobs[JobIndex].JobWeight;
 			}
 
-			float AccumulatedJobValue = 0.0f;
-			for (FLyraAssetManagerStartupJob& StartupJob : StartupJobs)
+			UpdateInitialGameContentLoadPercent(AccumulatedJobValue / TotalJobValue);
+		}
+	};
+
+	auto AreDependenciesComplete = [&RunStates](int32 JobIndex)
+	{
+		for (int32 DependencyIndex : RunStates[JobIndex].DependencyIndices)
+		{
+			if (RunStates[DependencyIndex].State != EJobState::Complete)
 			{
-				const float JobValue = StartupJob.JobWeight;
-				StartupJob.SubstepProgressDelegate.BindLambda([This = this, AccumulatedJobValue, JobValue, TotalJobValue](float NewProgress)
-					{
-						const float SubstepAdjustment = FMath::Clamp(NewProgress, 0.0f, 1.0f) * JobValue;
-						const float OverallPercentWithSubstep = (AccumulatedJobValue + SubstepAdjustment) / TotalJobValue;
+				return false;
+			}
+		}
+		return true;
+	};
+
+	int32 NumCompleteJobs = 0;
+	while (NumCompleteJobs < NumJobs)
+	{
+		bool bMadeProgress = false;
+
+		// Start every job that is no longer waiting on a dependency.  Loads started by game thread jobs stream in while later jobs run.
+		for (int32 JobIndex = 0; JobIndex < NumJobs; ++JobIndex)
+		{
+			FJobRunState& RunState = RunStates[JobIndex];
+			if ((RunState.State != EJobState::Pending) || !AreDependenciesComplete(JobIndex))
+			{
+				continue;
+			}
 
-						This->UpdateInitialGameContentLoadPercent(OverallPercentWithSubstep);
+			FLyraAssetManagerStartupJob& StartupJob = StartupJobs[JobIndex];
+			StartupJob.StartTime = FPlatformTime::Seconds() - AllStartupJobsStartTime;
+
+			if (StartupJob.Thread == ELyraStartupJobThread::AnyThread)
+			{
+				RunState.Task = UE::Tasks::Launch(UE_SOURCE_LOCATION, [&StartupJob]()
+					{
+						TSharedPtr<FStreamableHandle> Handle = StartupJob.StartJob();
+						ensureMsgf(!Handle.IsValid(), TEXT("Startup job \"%s\" runs on any thread and can't create a streamable handle"), *StartupJob.JobName);
+						StartupJob.FunctionEndTime = FPlatformTime::Seconds();
 					});
+			}
+			else
+			{
+				if (bReportProgress)
+				{
+					StartupJob.SubstepProgressDelegate.BindLambda([&RunState, &UpdateProgress](float NewProgress)
+						{
+							RunState.SubstepProgress = NewProgress;
+							UpdateProgress();
+						});
+				}
+
+				RunState.Handle = StartupJob.StartJob();
+				StartupJob.FunctionEndTime = FPlatformTime::Seconds() - AllStartupJobsStartTime;
+			}
+
+			RunState.State = EJobState::Running;
+			bMadeProgress = true;
+		}
+
+		// Retire every job that has finished, including any load it started
+		for (int32 JobIndex = 0; JobIndex < NumJobs; ++JobIndex)
+		{
+			FJobRunState& RunState = RunStates[JobIndex];
+			if (RunState.State != EJobState::Running)
+			{
+				continue;
+			}
+
+			FLyraAssetManagerStartupJob& StartupJob = StartupJobs[JobIndex];
 
-				StartupJob.DoJob();
+			bool bJobComplete = false;
+			if (StartupJob.Thread == ELyraStartupJobThread::AnyThread)
+			{
+				bJobComplete = RunState.Task.IsCompleted();
+				if (bJobComplete)
+				{
+					StartupJob.FunctionEndTime -= AllStartupJobsStartTime;
+				}
+			}
+			else
+			{
+				bJobComplete = !RunState.Handle.IsValid() || RunState.Handle->HasLoadCompleted() || RunState.Handle->WasCanceled();
+			}
 
+			if (bJobComplete)
+			{
+				StartupJob.FinishJob(RunState.Handle);
 				StartupJob.SubstepProgressDelegate.Unbind();
+				StartupJob.EndTime = FPlatformTime::Seconds() - AllStartupJobsStartTime;
 
-				AccumulatedJobValue += JobValue;
+				RunState.Handle.Reset();
+				RunState.State = EJobState::Complete;
+				++NumCompleteJobs;
+				bMadeProgress = true;
 
-				UpdateInitialGameContentLoadPercent(AccumulatedJobValue / TotalJobValue);
+				UpdateProgress();
 			}
 		}
-		else
+
+		if (!bMadeProgress)
 		{
-			UpdateInitialGameContentLoadPercent(1.0f);
+			// Nothing could start or finish, so block on the oldest outstanding work for a moment
+			const int32 RunningJobIndex = RunStates.IndexOfByPredicate([](const FJobRunState& RunState) { return RunState.State == EJobState::Running; });
+			if (RunningJobIndex != INDEX_NONE)
+			{
+				FJobRunState& RunState = RunStates[RunningJobIndex];
+				if (RunState.Handle.IsValid())
+				{
+					RunState.Handle->WaitUntilComplete(0.01f, false);
+				}
+				else
+				{
+					RunState.Task.Wait(FTimespan::FromMilliseconds(1.0));
+				}
+			}
+			else
+			{
+				// Only pending jobs are left and none of them can start, so there is a dependency cycle
+				for (int32 JobIndex = 0; JobIndex < NumJobs; ++JobIndex)
+				{
+					if (RunStates[JobIndex].State == EJobState::Pending)
+					{
+						UE_LOG(LogLyra, Error, TEXT("Startup job \"%s\" is part of a dependency cycle, running it without its dependencies"), *StartupJobs[JobIndex].JobName);
+						RunStates[JobIndex].DependencyIndices.Reset();
+					}
+				}
+			}
 		}
 	}
 
+	if (NumJobs == 0)
+	{
+		UpdateProgress();
+	}
+
+	UE_LOG(LogLyra, Display, TEXT("Startup job timings (seconds from the start of the startup jobs):"));
+	for (const FLyraAssetManagerStartupJob& StartupJob : StartupJobs)
+	{
+		UE_LOG(LogLyra, Display, TEXT("  %-48s start %6.2f  function %6.2f  load %6.2f  end %6.2f  [%s]"),
+			*StartupJob.JobName,
+			StartupJob.StartTime,
+			StartupJob.FunctionEndTime - StartupJob.StartTime,
+			StartupJob.EndTime - StartupJob.FunctionEndTime,
+			StartupJob.EndTime,
+			(StartupJob.Thread == ELyraStartupJobThread::AnyThread) ? TEXT("AnyThread") : TEXT("GameThread"));
+	}
+
 	StartupJobs.Empty();
 
 	UE_LOG(LogLyra, Display, TEXT("All startup jobs took %.2f seconds to complete"), FPlatformTime::Seconds() - AllStartupJobsStartTime);
@@ -17,6 +17,35 @@ struct FLyraBundles
 	static const FName Equipped;
 };
 
+/** What happens when a synchronous load is audited, see Lyra.AssetManager.SyncLoadAuditPolicy */
+enum class ELyraSyncLoadAuditPolicy : uint8
+{
+	// Synchronous loads are not audited
+	Disabled,
+
+	// Record the load and log a warning
+	Log,
+
+	// Record the load and ensure
+	Ensure,
+
+	// Record the load and refuse it, returning null to the caller
+	Fail
+};
+
+/** Everything recorded about synchronous loads of a single asset during gameplay */
+struct FLyraSyncLoadAuditRecord
+{
+	FSoftObjectPath AssetPath;
+	int32 LoadCount = 0;
+	double TotalSeconds = 0.0;
+	double MaxSeconds = 0.0;
+
+	// Unsymbolicated callstack of the first load
+	static constexpr uint32 MaxCallstackDepth = 32;
+	TArray<uint64> CallstackFrames;
+};
+
 
 /**
  * ULyraAssetManager
@@ -45,6 +74,22 @@ public:
 	template<typename AssetType>
 	static TSubclassOf<AssetType> GetSubclass(const TSoftClassPtr<AssetType>& AssetPointer, bool bKeepInMemory = true);
 
+	// Calls the callback with the asset referenced by a TSoftObjectPtr, immediately if it's already loaded or after it has been async loaded.
+	// Returns the handle of the async load if one was started.
+	template<typename AssetType>
+	static TSharedPtr<FStreamableHandle> GetAssetAsync(const TSoftObjectPtr<AssetType>& AssetPointer, TFunction<void(AssetType*)>&& Callback, bool bKeepInMemory = true);
+
+	// Calls the callback with the subclass referenced by a TSoftClassPtr, immediately if it's already loaded or after it has been async loaded.
+	// Returns the handle of the async load if one was started.
+	template<typename AssetType>
+	static TSharedPtr<FStreamableHandle> GetSubclassAsync(const TSoftClassPtr<AssetType>& AssetPointer, TFunction<void(TSubclassOf<AssetType>)>&& Callback, bool bKeepInMemory = true);
+
+	// Starts or stops recording synchronous loads, this is enabled while an experience is being played.  Calls must be balanced.
+	void SetSyncLoadAuditActive(bool bActive);
+
+	// Logs the synchronous loads recorded since the audit started, worst offenders first
+	static void DumpSyncLoadAudit();
+
 	// Logs all assets currently loaded and tracked by the asset manager.
 	static void DumpLoadedAssets();
 
@@ -66,8 +111,13 @@ protected:
 
 
 	static UObject* SynchronousLoadAsset(const FSoftObjectPath& AssetPath);
+	static TSharedPtr<FStreamableHandle> AsynchronousLoadAsset(const FSoftObjectPath& AssetPath, TFunction<void(UObject*)>&& Callback, bool bKeepInMemory);
 	static bool ShouldLogAssetLoads();
 
+	// Records a synchronous load made while the audit is active, returns false if the audit policy refuses the load
+	bool BeginAuditedSynchronousLoad(const FSoftObjectPath& AssetPath);
+	void EndAuditedSynchronousLoad(const FSoftObjectPath& AssetPath, double Seconds);
+
 	// Thread safe way of adding a loaded asset to keep in memory.
 	void AddLoadedAsset(const UObject* Asset);
 
@@ -95,12 +145,15 @@ protected:
 	TSoftObjectPtr<ULyraPawnData> DefaultPawnData;
 
 private:
-	// Flushes the StartupJobs array. Processes all startup work.
+	// Flushes the StartupJobs array. Processes all startup work, starting each job as soon as the jobs it depends on are complete.
 	void DoAllStartupJobs();
 
 	// Sets up the ability system
 	void InitializeGameplayCueManager();
 
+	// Starts the async load of the game data, GetGameData finishes it
+	TSharedPtr<FStreamableHandle> StartGameDataLoad();
+
 	// Called periodically during loads, could be used to feed the status to a loading screen
 	void UpdateInitialGameContentLoadPercent(float GameContentPercent);
 
@@ -115,6 +168,12 @@ private:
 
 	// Used for a scope lock when modifying the list of load assets.
 	FCriticalSection LoadedAssetsCritical;
+
+	// Synchronous loads recorded while the audit is active.
+	TMap<FSoftObjectPath, FLyraSyncLoadAuditRecord> SyncLoadAuditRecords;
+	FCriticalSection SyncLoadAuditCritical;
+	int32 SyncLoadAuditRefCount = 0;
+	bool bSyncLoadAuditActive = false;
 };
 
 
@@ -144,6 +203,24 @@ AssetType* ULyraAssetManager::GetAsset(const TSoftObjectPtr<AssetType>& AssetPoi
 	return LoadedAsset;
 }
 
+template<typename AssetType>
+TSharedPtr<FStreamableHandle> ULyraAssetManager::GetAssetAsync(const TSoftObjectPtr<AssetType>& AssetPointer, TFunction<void(AssetType*)>&& Callback, bool bKeepInMemory)
+{
+	return AsynchronousLoadAsset(AssetPointer.ToSoftObjectPath(), [Callback = MoveTemp(Callback)](UObject* LoadedObject)
+		{
+			Callback(Cast<AssetType>(LoadedObject));
+		}, bKeepInMemory);
+}
+
+template<typename AssetType>
+TSharedPtr<FStreamableHandle> ULyraAssetManager::GetSubclassAsync(const TSoftClassPtr<AssetType>& AssetPointer, TFunction<void(TSubclassOf<AssetType>)>&& Callback, bool bKeepInMemory)
+{
+	return AsynchronousLoadAsset(AssetPointer.ToSoftObjectPath(), [Callback = MoveTemp(Callback)](UObject* LoadedObject)
+		{
+			Callback(TSubclassOf<AssetType>(Cast<UClass>(LoadedObject)));
+		}, bKeepInMemory);
+}
+
 template<typename AssetType>
 TSubclassOf<AssetType> ULyraAssetManager::GetSubclass(const TSoftClassPtr<AssetType>& AssetPointer, bool bKeepInMemory)
 {
@@ -5,6 +5,14 @@
 #include "LyraLogChannels.h"
 
 TSharedPtr<FStreamableHandle> FLyraAssetManagerStartupJob::DoJob() const
+{
+	TSharedPtr<FStreamableHandle> Handle = StartJob();
+	FinishJob(Handle);
+
+	return Handle;
+}
+
+TSharedPtr<FStreamableHandle> FLyraAssetManagerStartupJob::StartJob() const
 {
 	const double JobStartTime = FPlatformTime::Seconds();
 
@@ -15,11 +23,22 @@ TSharedPtr<FStreamableHandle> FLyraAssetManagerStartupJob::DoJob() const
 	if (Handle.IsValid())
 	{
 		Handle->BindUpdateDelegate(FStreamableUpdateDelegate::CreateRaw(this, &FLyraAssetManagerStartupJob::UpdateSubstepProgressFromStreamable));
-		Handle->WaitUntilComplete(0.0f, false);
-		Handle->BindUpdateDelegate(FStreamableUpdateDelegate());
 	}
 
-	UE_LOG(LogLyra, Display, TEXT("Startup job \"%s\" took %.2f seconds to complete"), *JobName, FPlatformTime::Seconds() - JobStartTime);
+	UE_LOG(LogLyra, Display, TEXT("Startup job \"%s\" function took %.2f seconds to complete"), *JobName, FPlatformTime::Seconds() - JobStartTime);
 
 	return Handle;
 }
+
+void FLyraAssetManagerStartupJob::FinishJob(const TSharedPtr<FStreamableHandle>& Handle) const
+{
+	if (Handle.IsValid())
+	{
+		const double WaitStartTime = FPlatformTime::Seconds();
+
+		Handle->WaitUntilComplete(0.0f, false);
+		Handle->BindUpdateDelegate(FStreamableUpdateDelegate());
+
+		UE_LOG(LogLyra, Display, TEXT("Startup job \"%s\" waited %.2f seconds for its load to complete"), *JobName, FPlatformTime::Seconds() - WaitStartTime);
+	}
+}
@@ -6,6 +6,16 @@
 
 DECLARE_DELEGATE_OneParam(FLyraAssetManagerStartupJobSubstepProgress, float /*NewProgress*/);
 
+/** Where a startup job is allowed to run */
+enum class ELyraStartupJobThread : uint8
+{
+	// Runs on the game thread, required for anything that touches UObjects or creates streamable handles
+	GameThread,
+
+	// Runs on a worker task, must not touch UObjects or create streamable handles
+	AnyThread
+};
+
 /** Handles reporting progress from streamable handles */
 struct FLyraAssetManagerStartupJob
 {
@@ -15,6 +25,17 @@ struct FLyraAssetManagerStartupJob
 	float JobWeight;
 	mutable double LastUpdate = 0;
 
+	/** Names of the jobs that must be complete (including their loads) before this one starts */
+	TArray<FString> Dependencies;
+
+	/** Where the job function is run */
+	ELyraStartupJobThread Thread = ELyraStartupJobThread::GameThread;
+
+	/** Timings recorded by the scheduler, in seconds since the startup jobs began */
+	mutable double StartTime = 0.0;
+	mutable double FunctionEndTime = 0.0;
+	mutable double EndTime = 0.0;
+
 	/** Simple job that is all synchronous */
 	FLyraAssetManagerStartupJob(const FString& InJobName, const TFunction<void(const FLyraAssetManagerStartupJob&, TSharedPtr<FStreamableHandle>&)>& InJobFunc, float InJobWeight)
 		: JobFunc(InJobFunc)
@@ -25,6 +46,12 @@ struct FLyraAssetManagerStartupJob
 	/** Perform actual loading, will return a handle if it created one */
 	TSharedPtr<FStreamableHandle> DoJob() const;
 
+	/** Runs the job function without waiting for any load it starts, will return a handle if it created one */
+	TSharedPtr<FStreamableHandle> StartJob() const;
+
+	/** Waits for the load started by StartJob to complete */
+	void FinishJob(const TSharedPtr<FStreamableHandle>& Handle) const;
+
 	void UpdateSubstepProgress(float NewProgress) const
 	{
 		SubstepProgressDelegate.ExecuteIfBound(NewProgress);
@@ -3,7 +3,10 @@
 #include "LyraTeamCheats.h"
 
 #include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/Pawn.h"
 #include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
 #include "HAL/IConsoleManager.h"
 #include "Teams/LyraTeamSubsystem.h"
 
@@ -63,3 +66,82 @@ void ULyraTeamCheats::ListTeams()
 	}
 }
 
+
+void ULyraTeamCheats::BenchmarkCompareTeams(int32 CallsPerPlayer)
+{
+	UWorld* World = GetWorld();
+	ULyraTeamSubsystem* TeamSubsystem = UWorld::GetSubsystem<ULyraTeamSubsystem>(World);
+	AGameStateBase* GameState = (World != nullptr) ? World->GetGameState() : nullptr;
+	if ((TeamSubsystem == nullptr) || (GameState == nullptr))
+	{
+		return;
+	}
+
+	// Damage and targeting mostly ask about pawns, so prefer those over the player states
+	TArray<const AActor*> TeamActors;
+	for (const APlayerState* PS : GameState->PlayerArray)
+	{
+		if (PS != nullptr)
+		{
+			const APawn* Pawn = PS->GetPawn();
+			TeamActors.Add((Pawn != nullptr) ? static_cast<const AActor*>(Pawn) : static_cast<const AActor*>(PS));
+		}
+	}
+
+	if (TeamActors.Num() == 0)
+	{
+		UE_LOG(LogConsoleResponse, Warning, TEXT("BenchmarkCompareTeams: There are no players to compare"));
+		return;
+	}
+
+	const int32 NumPlayerSlots = 64;
+	CallsPerPlayer = FMath::Max(CallsPerPlayer, 1);
+
+	IConsoleVariable* CacheCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("Lyra.Teams.EnableTeamCache"));
+	const bool bWasCacheEnabled = (CacheCVar != nullptr) && CacheCVar->GetBool();
+
+	auto RunPass = [&](bool bUseCache, int32& OutNumSameTeam)
+	{
+		if (CacheCVar != nullptr)
+		{
+			CacheCVar->Set(bUseCache, ECVF_SetByConsole);
+		}
+		TeamSubsystem->InvalidateTeamCache();
+
+		OutNumSameTeam = 0;
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 SlotIndex = 0; SlotIndex < NumPlayerSlots; ++SlotIndex)
+		{
+			const AActor* A = TeamActors[SlotIndex % TeamActors.Num()];
+			for (int32 CallIndex = 0; CallIndex < CallsPerPlayer; ++CallIndex)
+			{
+				const AActor* B = TeamActors[(SlotIndex + CallIndex + 1) % TeamActors.Num()];
+				if (TeamSubsystem->CompareTeams(A, B) == ELyraTeamComparison::OnSameTeam)
+				{
+					++OutNumSameTeam;
+				}
+			}
+		}
+		return FPlatformTime::Seconds() - StartTime;
+	};
+
+	int32 NumSameTeamUncached = 0;
+	int32 NumSameTeamCached = 0;
+	const double UncachedSeconds = RunPass(false, /*out*/ NumSameTeamUncached);
+	const double CachedSeconds = RunPass(true, /*out*/ NumSameTeamCached);
+
+	if (CacheCVar != nullptr)
+	{
+		CacheCVar->Set(bWasCacheEnabled, ECVF_SetByConsole);
+	}
+
+	const int32 TotalCalls = NumPlayerSlots * CallsPerPlayer;
+	UE_LOG(LogConsoleResponse, Log, TEXT("BenchmarkCompareTeams: %d calls (%d slots x %d) over %d distinct players"), TotalCalls, NumPlayerSlots, CallsPerPlayer, TeamActors.Num());
+	UE_LOG(LogConsoleResponse, Log, TEXT("  Uncached: %.3f ms (%.1f ns/call)"), UncachedSeconds * 1000.0, UncachedSeconds * 1.0e9 / TotalCalls);
+	UE_LOG(LogConsoleResponse, Log, TEXT("  Cached:   %.3f ms (%.1f ns/call), %d cache entries"), CachedSeconds * 1000.0, CachedSeconds * 1.0e9 / TotalCalls, TeamSubsystem->GetNumCachedTeams());
+
+	if (NumSameTeamUncached != NumSameTeamCached)
+	{
+		UE_LOG(LogConsoleResponse, Error, TEXT("BenchmarkCompareTeams: Cached and uncached results differ (%d vs %d same team results)"), NumSameTeamCached, NumSameTeamUncached);
+	}
+}
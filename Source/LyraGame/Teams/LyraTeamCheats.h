@@ -28,4 +28,9 @@ public:
 	// Prints a list of all of the teams
 	UFUNCTION(Exec)
 	virtual void ListTeams();
+
+	// Times CompareTeams for 64 player slots (filled from the current players and their pawns)
+	// against the other slots, with and without the team cache
+	UFUNCTION(Exec)
+	virtual void BenchmarkCompareTeams(int32 CallsPerPlayer = 1000);
 };
@@ -5,6 +5,7 @@
 #include "AbilitySystemGlobals.h"
 #include "GameFramework/Controller.h"
 #include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
 #include "LyraLogChannels.h"
 #include "LyraTeamAgentInterface.h"
 #include "LyraTeamCheats.h"
@@ -17,6 +18,23 @@
 
 class FSubsystemCollectionBase;
 
+namespace LyraTeamSubsystemCVars
+{
+	static bool bEnableTeamCache = true;
+	static FAutoConsoleVariableRef CVarEnableTeamCache(
+		TEXT("Lyra.Teams.EnableTeamCache"),
+		bEnableTeamCache,
+		TEXT("If true, FindTeamFromObject caches the team of each object until one of the team agents it depends on changes team."),
+		ECVF_Default);
+
+	static int32 MaxCachedTeams = 4096;
+	static FAutoConsoleVariableRef CVarMaxCachedTeams(
+		TEXT("Lyra.Teams.MaxCachedTeams"),
+		MaxCachedTeams,
+		TEXT("The team cache is flushed (dropping entries for destroyed objects) when it grows past this many entries."),
+		ECVF_Default);
+}
+
 //////////////////////////////////////////////////////////////////////
 // FLyraTeamTrackingInfo
 
@@ -85,6 +103,19 @@ void ULyraTeamSubsystem::Deinitialize()
 {
 	UCheatManager::UnregisterFromOnCheatManagerCreated(CheatManagerRegistrationHandle);
 
+	for (const TWeakObjectPtr<UObject>& AgentPtr : ObservedTeamAgents)
+	{
+		if (ILyraTeamAgentInterface* TeamAgent = Cast<ILyraTeamAgentInterface>(AgentPtr.Get()))
+		{
+			if (FOnLyraTeamIndexChangedDelegate* TeamChangedDelegate = TeamAgent->GetOnTeamIndexChangedDelegate())
+			{
+				TeamChangedDelegate->RemoveDynamic(this, &ThisClass::HandleObservedAgentTeamChanged);
+			}
+		}
+	}
+	ObservedTeamAgents.Reset();
+	TeamCache.Reset();
+
 	Super::Deinitialize();
 }
 
@@ -101,6 +132,8 @@ bool ULyraTeamSubsystem::RegisterTeamInfo(ALyraTeamInfoBase* TeamInfo)
 		FLyraTeamTrackingInfo& Entry = TeamMap.FindOrAdd(TeamId);
 		Entry.SetTeamInfo(TeamInfo);
 
+		InvalidateTeamCache();
+
 		return true;
 	}
 
@@ -124,6 +157,8 @@ bool ULyraTeamSubsystem::UnregisterTeamInfo(ALyraTeamInfoBase* TeamInfo)
 		{
 			Entry->RemoveTeamInfo(TeamInfo);
 
+			InvalidateTeamCache();
+
 			return true;
 		}
 	}
@@ -152,9 +187,61 @@ bool ULyraTeamSubsystem::ChangeTeamForActor(AActor* ActorToChange, int32 NewTeam
 
 int32 ULyraTeamSubsystem::FindTeamFromObject(const UObject* TestObject) const
 {
+	if (TestObject == nullptr)
+	{
+		return INDEX_NONE;
+	}
+
+	const bool bUseCache = LyraTeamSubsystemCVars::bEnableTeamCache && IsInGameThread();
+
+	if (bUseCache)
+	{
+		if (const FLyraCachedTeamEntry* CachedEntry = TeamCache.Find(FObjectKey(TestObject)))
+		{
+			// Instigator based entries are only good while the instigator is the same (it isn't covered by the team changed delegates)
+			if (!CachedEntry->bFromInstigator || (CachedEntry->TeamSource.IsValid() && (CachedEntry->TeamSource.Get() == CastChecked<const AActor>(TestObject)->GetInstigator())))
+			{
+				return CachedEntry->TeamId;
+			}
+		}
+	}
+
+	const UObject* TeamSource = nullptr;
+	bool bFromInstigator = false;
+	bool bCacheable = false;
+	const int32 TeamId = ResolveTeamFromObject(TestObject, /*out*/ TeamSource, /*out*/ bFromInstigator, /*out*/ bCacheable);
+
+	// Results with no team are not cached, the object is probably still waiting on a controller or player state
+	if (bUseCache && bCacheable && (TeamId != INDEX_NONE))
+	{
+		if ((TeamSource == nullptr) || ObserveTeamAgent(TeamSource))
+		{
+			if (TeamCache.Num() >= LyraTeamSubsystemCVars::MaxCachedTeams)
+			{
+				const_cast<ULyraTeamSubsystem*>(this)->InvalidateTeamCache();
+			}
+
+			FLyraCachedTeamEntry& NewEntry = TeamCache.Add(FObjectKey(TestObject));
+			NewEntry.TeamSource = TeamSource;
+			NewEntry.TeamId = TeamId;
+			NewEntry.bFromInstigator = bFromInstigator;
+		}
+	}
+
+	return TeamId;
+}
+
+int32 ULyraTeamSubsystem::ResolveTeamFromObject(const UObject* TestObject, const UObject*& OutTeamSource, bool& bOutFromInstigator, bool& bOutCacheable) const
+{
+	OutTeamSource = nullptr;
+	bOutFromInstigator = false;
+	bOutCacheable = false;
+
 	// See if it's directly a team agent
 	if (const ILyraTeamAgentInterface* ObjectWithTeamInterface = Cast<ILyraTeamAgentInterface>(TestObject))
 	{
+		OutTeamSource = TestObject;
+		bOutCacheable = true;
 		return GenericTeamIdToInteger(ObjectWithTeamInterface->GetGenericTeamId());
 	}
 
@@ -163,16 +250,22 @@ int32 ULyraTeamSubsystem::FindTeamFromObject(const UObject* TestObject) const
 		// See if the instigator is a team actor
 		if (const ILyraTeamAgentInterface* InstigatorWithTeamInterface = Cast<ILyraTeamAgentInterface>(TestActor->GetInstigator()))
 		{
+			OutTeamSource = TestActor->GetInstigator();
+			bOutFromInstigator = true;
+			bOutCacheable = true;
 			return GenericTeamIdToInteger(InstigatorWithTeamInterface->GetGenericTeamId());
 		}
 
 		// TeamInfo actors don't actually have the team interface, so they need a special case
 		if (const ALyraTeamInfoBase* TeamInfo = Cast<ALyraTeamInfoBase>(TestActor))
 		{
+			// The team ID of a team info never changes
+			bOutCacheable = true;
 			return TeamInfo->GetTeamId();
 		}
 
 		// Fall back to finding the associated player state
+		// (not cached, possession changes aren't reported through the team changed delegates)
 		if (const ALyraPlayerState* LyraPS = FindPlayerStateFromActor(TestActor))
 		{
 			return LyraPS->GetTeamId();
@@ -182,6 +275,49 @@ int32 ULyraTeamSubsystem::FindTeamFromObject(const UObject* TestObject) const
 	return INDEX_NONE;
 }
 
+bool ULyraTeamSubsystem::ObserveTeamAgent(const UObject* TeamAgent) const
+{
+	UObject* MutableTeamAgent = const_cast<UObject*>(TeamAgent);
+
+	const TWeakObjectPtr<UObject> AgentPtr(MutableTeamAgent);
+	if (ObservedTeamAgents.Contains(AgentPtr))
+	{
+		return true;
+	}
+
+	if (ILyraTeamAgentInterface* TeamAgentInterface = Cast<ILyraTeamAgentInterface>(MutableTeamAgent))
+	{
+		if (FOnLyraTeamIndexChangedDelegate* TeamChangedDelegate = TeamAgentInterface->GetOnTeamIndexChangedDelegate())
+		{
+			TeamChangedDelegate->AddUniqueDynamic(const_cast<ULyraTeamSubsystem*>(this), &ThisClass::HandleObservedAgentTeamChanged);
+			ObservedTeamAgents.Add(AgentPtr);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void ULyraTeamSubsystem::HandleObservedAgentTeamChanged(UObject* ObjectChangingTeam, int32 OldTeamID, int32 NewTeamID)
+{
+	// Team changes are rare enough that it's not worth tracking which entries depend on which agent
+	TeamCache.Reset();
+}
+
+void ULyraTeamSubsystem::InvalidateTeamCache()
+{
+	TeamCache.Reset();
+
+	// Drop agents that have been destroyed since they were observed
+	for (auto It = ObservedTeamAgents.CreateIterator(); It; ++It)
+	{
+		if (!It->IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
 const ALyraPlayerState* ULyraTeamSubsystem::FindPlayerStateFromActor(const AActor* PossibleTeamActor) const
 {
 	if (PossibleTeamActor != nullptr)
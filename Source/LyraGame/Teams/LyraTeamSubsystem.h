@@ -3,6 +3,7 @@
 #pragma once
 
 #include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
 
 #include "LyraTeamSubsystem.generated.h"
 
@@ -41,6 +42,18 @@ public:
 	void RemoveTeamInfo(ALyraTeamInfoBase* Info);
 };
 
+// A cached result of resolving the team for an object, see ULyraTeamSubsystem::FindTeamFromObject
+struct FLyraCachedTeamEntry
+{
+	// The team agent whose team was used (the object itself or its instigator), null for team info actors
+	TWeakObjectPtr<const UObject> TeamSource;
+
+	int32 TeamId = INDEX_NONE;
+
+	// True if the team came from the instigator, in which case the entry is only valid while the instigator is unchanged
+	bool bFromInstigator = false;
+};
+
 // Result of comparing the team affiliation for two actors
 UENUM(BlueprintType)
 enum class ELyraTeamComparison : uint8
@@ -140,9 +153,31 @@ public:
 	// Register for a team display asset notification for the specified team ID
 	FOnLyraTeamDisplayAssetChangedDelegate& GetTeamDisplayAssetChangedDelegate(int32 TeamId);
 
+	// Throws away all cached team resolutions (they will be rebuilt on demand)
+	void InvalidateTeamCache();
+
+	// Returns the number of objects that currently have a cached team
+	int32 GetNumCachedTeams() const { return TeamCache.Num(); }
+
+private:
+	// Does the uncached work for FindTeamFromObject, reporting which team agent the result came from (if any)
+	int32 ResolveTeamFromObject(const UObject* TestObject, const UObject*& OutTeamSource, bool& bOutFromInstigator, bool& bOutCacheable) const;
+
+	// Makes sure we hear about team changes on the specified agent, returns false if it has no team changed delegate
+	bool ObserveTeamAgent(const UObject* TeamAgent) const;
+
+	UFUNCTION()
+	void HandleObservedAgentTeamChanged(UObject* ObjectChangingTeam, int32 OldTeamID, int32 NewTeamID);
+
 private:
 	UPROPERTY()
 	TMap<int32, FLyraTeamTrackingInfo> TeamMap;
 
+	// Object to team lookups, invalidated whenever one of the observed team agents changes team
+	mutable TMap<FObjectKey, FLyraCachedTeamEntry> TeamCache;
+
+	// Team agents we have bound HandleObservedAgentTeamChanged to
+	mutable TSet<TWeakObjectPtr<UObject>> ObservedTeamAgents;
+
 	FDelegateHandle CheatManagerRegistrationHandle;
 };
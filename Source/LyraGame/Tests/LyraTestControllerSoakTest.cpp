@@ -0,0 +1,354 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+
+#include "Tests/LyraTestControllerSoakTest.h"
+
+#include "AIController.h"
+#include "Character/LyraHealthComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameModes/LyraBotCreationComponent.h"
+#include "HAL/PlatformMemory.h"
+#include "LyraLogChannels.h"
+#include "Messages/LyraVerbMessage.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "NativeGameplayTags.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(LyraTestControllerSoakTest)
+
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Lyra_Elimination_Message, "Lyra.Elimination.Message");
+
+namespace LyraSoakTest
+{
+	static float GetPercentile(const TArray<float>& SortedValues, float Percentile)
+	{
+		if (SortedValues.Num() == 0)
+		{
+			return 0.0f;
+		}
+
+		const int32 Index = FMath::Clamp(FMath::CeilToInt32(Percentile * SortedValues.Num()) - 1, 0, SortedValues.Num() - 1);
+		return SortedValues[Index];
+	}
+
+	static void AppendPercentiles(FString& Report, const TCHAR* Label, TArray<float> Values)
+	{
+		Values.Sort();
+
+		double Total = 0.0;
+		for (float Value : Values)
+		{
+			Total += Value;
+		}
+
+		Report += FString::Printf(TEXT("%s: Avg=%.2f P50=%.2f P90=%.2f P95=%.2f P99=%.2f Max=%.2f\n"),
+			Label,
+			(Values.Num() > 0) ? (Total / Values.Num()) : 0.0,
+			GetPercentile(Values, 0.50f),
+			GetPercentile(Values, 0.90f),
+			GetPercentile(Values, 0.95f),
+			GetPercentile(Values, 0.99f),
+			(Values.Num() > 0) ? Values.Last() : 0.0f);
+	}
+
+	static double BytesToMB(uint64 Bytes)
+	{
+		return (double)Bytes / (1024.0 * 1024.0);
+	}
+}
+
+void ULyraTestControllerSoakTest::OnInit()
+{
+	Super::OnInit();
+
+	const TCHAR* CommandLine = FCommandLine::Get();
+	FParse::Value(CommandLine, TEXT("SoakDuration="), SoakDuration);
+	FParse::Value(CommandLine, TEXT("SoakWarmup="), WarmupDuration);
+	FParse::Value(CommandLine, TEXT("SoakKillInterval="), KillInterval);
+	FParse::Value(CommandLine, TEXT("SoakMaxGameThreadMsP95="), MaxGameThreadMsP95);
+	FParse::Value(CommandLine, TEXT("SoakMaxMemoryMB="), MaxMemoryMB);
+	FParse::Value(CommandLine, TEXT("SoakReport="), ReportFilename);
+
+	Phase = ESoakPhase::WaitingForBots;
+	PhaseStartTime = FPlatformTime::Seconds();
+
+	UE_LOG(LogLyra, Display, TEXT("SoakTest: measuring for %.0fs after a %.0fs warmup once the bots are ready"), SoakDuration, WarmupDuration);
+}
+
+void ULyraTestControllerSoakTest::OnTick(float TimeDelta)
+{
+	Super::OnTick(TimeDelta);
+
+	UWorld* World = GetWorld();
+	const double Now = FPlatformTime::Seconds();
+
+	switch (Phase)
+	{
+	case ESoakPhase::WaitingForBots:
+		{
+			const AGameStateBase* GameState = (World != nullptr) ? World->GetGameState() : nullptr;
+			const ULyraBotCreationComponent* BotComponent = (GameState != nullptr) ? GameState->FindComponentByClass<ULyraBotCreationComponent>() : nullptr;
+
+			if ((BotComponent != nullptr) && (BotComponent->GetTimeToAllBotsReady() >= 0.0))
+			{
+				TimeToAllBotsReady = BotComponent->GetTimeToAllBotsReady();
+				Phase = ESoakPhase::WarmingUp;
+				PhaseStartTime = Now;
+				UE_LOG(LogLyra, Display, TEXT("SoakTest: bots ready after %.2fs, warming up"), TimeToAllBotsReady);
+			}
+			else if ((Now - PhaseStartTime) > MaxWaitForBots)
+			{
+				UE_LOG(LogLyra, Error, TEXT("SoakTest: no bots were created within %.0fs, make sure the experience has a bot creation component and NumBots is set"), MaxWaitForBots);
+				Phase = ESoakPhase::Finished;
+				EndTest(1);
+			}
+		}
+		break;
+
+	case ESoakPhase::WarmingUp:
+		if ((Now - PhaseStartTime) >= WarmupDuration)
+		{
+			StartMeasuring();
+		}
+		break;
+
+	case ESoakPhase::Measuring:
+		// GGameThreadTime is the time the game thread spent working last frame, excluding the wait for the server tick rate
+		GameThreadMs.Add(FPlatformTime::ToMilliseconds(GGameThreadTime));
+		FrameMs.Add(TimeDelta * 1000.0f);
+
+		SampleMemory();
+		SampleConnections(TimeDelta);
+
+		if (KillInterval > 0.0)
+		{
+			TimeUntilNextKill -= TimeDelta;
+			if (TimeUntilNextKill <= 0.0)
+			{
+				KillRandomBot();
+				TimeUntilNextKill = KillInterval;
+			}
+		}
+
+		if ((Now - PhaseStartTime) >= SoakDuration)
+		{
+			FinishMeasuring();
+		}
+		break;
+
+	case ESoakPhase::Finished:
+		break;
+	}
+}
+
+void ULyraTestControllerSoakTest::StartMeasuring()
+{
+	UWorld* World = GetWorld();
+	check(World);
+
+	Phase = ESoakPhase::Measuring;
+	PhaseStartTime = FPlatformTime::Seconds();
+	TimeUntilNextKill = KillInterval;
+
+	if (ReportFilename.IsEmpty())
+	{
+		ReportFilename = FPaths::ProjectSavedDir() / TEXT("SoakTest") / FString::Printf(TEXT("Soak_%s_%s.txt"), *World->GetMapName(), *FDateTime::Now().ToString());
+	}
+
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+	StartUsedPhysical = MemoryStats.UsedPhysical;
+
+	// Count the bots once, the kill interval only causes respawns
+	for (TActorIterator<AAIController> It(World); It; ++It)
+	{
+		++NumBots;
+	}
+
+	UGameplayMessageSubsystem& MessageSubsystem = UGameplayMessageSubsystem::Get(World);
+	EliminationListenerHandle = MessageSubsystem.RegisterListener(TAG_Lyra_Elimination_Message, this, &ThisClass::OnEliminationMessage);
+
+	// Per-subsystem timings
+#if CSV_PROFILER
+	if (FCsvProfiler* CsvProfiler = FCsvProfiler::Get())
+	{
+		if (!CsvProfiler->IsCapturing())
+		{
+			CsvProfiler->BeginCapture(-1, FPaths::GetPath(ReportFilename), FPaths::GetBaseFilename(ReportFilename) + TEXT(".csv"));
+			bStartedCsvCapture = true;
+		}
+	}
+#endif
+#if STATS
+	GEngine->Exec(World, TEXT("stat startfile"));
+#endif
+
+	UE_LOG(LogLyra, Display, TEXT("SoakTest: measuring %d bots for %.0fs"), NumBots, SoakDuration);
+}
+
+void ULyraTestControllerSoakTest::FinishMeasuring()
+{
+	Phase = ESoakPhase::Finished;
+	MeasuredDuration = FPlatformTime::Seconds() - PhaseStartTime;
+
+	EliminationListenerHandle.Unregister();
+
+#if STATS
+	GEngine->Exec(GetWorld(), TEXT("stat stopfile"));
+#endif
+#if CSV_PROFILER
+	if (bStartedCsvCapture)
+	{
+		FCsvProfiler::Get()->EndCapture();
+		bStartedCsvCapture = false;
+	}
+#endif
+
+	const bool bPassed = WriteReport();
+	EndTest(bPassed ? 0 : 1);
+}
+
+void ULyraTestControllerSoakTest::SampleMemory()
+{
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+	PeakUsedPhysical = FMath::Max3<uint64>(PeakUsedPhysical, MemoryStats.UsedPhysical, MemoryStats.PeakUsedPhysical);
+	PeakUsedVirtual = FMath::Max3<uint64>(PeakUsedVirtual, MemoryStats.UsedVirtual, MemoryStats.PeakUsedVirtual);
+}
+
+void ULyraTestControllerSoakTest::SampleConnections(float TimeDelta)
+{
+	UWorld* World = GetWorld();
+	UNetDriver* NetDriver = (World != nullptr) ? World->GetNetDriver() : nullptr;
+	if (NetDriver == nullptr)
+	{
+		return;
+	}
+
+	// Connections that leave keep their last totals in the map
+	for (UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		if (Connection == nullptr)
+		{
+			continue;
+		}
+
+		FConnectionTraffic* Traffic = ConnectionTraffic.Find(Connection);
+		if (Traffic == nullptr)
+		{
+			Traffic = &ConnectionTraffic.Add(Connection);
+			Traffic->Name = Connection->LowLevelGetRemoteAddress(/*bAppendPort=*/ true);
+			Traffic->StartInBytes = Connection->InTotalBytes;
+			Traffic->StartOutBytes = Connection->OutTotalBytes;
+		}
+
+		Traffic->InBytes = (int64)Connection->InTotalBytes - Traffic->StartInBytes;
+		Traffic->OutBytes = (int64)Connection->OutTotalBytes - Traffic->StartOutBytes;
+		Traffic->ConnectedSeconds += TimeDelta;
+	}
+}
+
+void ULyraTestControllerSoakTest::KillRandomBot()
+{
+	TArray<APawn*> BotPawns;
+	for (TActorIterator<AAIController> It(GetWorld()); It; ++It)
+	{
+		if (APawn* Pawn = It->GetPawn())
+		{
+			BotPawns.Add(Pawn);
+		}
+	}
+
+	if (BotPawns.Num() > 0)
+	{
+		if (ULyraHealthComponent* HealthComponent = ULyraHealthComponent::FindHealthComponent(BotPawns[FMath::RandRange(0, BotPawns.Num() - 1)]))
+		{
+			HealthComponent->DamageSelfDestruct();
+			++NumForcedKills;
+		}
+	}
+}
+
+void ULyraTestControllerSoakTest::OnEliminationMessage(FGameplayTag Channel, const FLyraVerbMessage& Payload)
+{
+	++NumEliminations;
+}
+
+bool ULyraTestControllerSoakTest::WriteReport() const
+{
+	using namespace LyraSoakTest;
+
+	UWorld* World = GetWorld();
+
+	FString Report;
+	Report += TEXT("[Soak]\n");
+	Report += FString::Printf(TEXT("Map: %s\n"), (World != nullptr) ? *World->GetMapName() : TEXT("None"));
+	Report += FString::Printf(TEXT("Bots: %d\n"), NumBots);
+	Report += FString::Printf(TEXT("TimeToAllBotsReadySeconds: %.3f\n"), TimeToAllBotsReady);
+	Report += FString::Printf(TEXT("DurationSeconds: %.1f\n"), MeasuredDuration);
+	Report += FString::Printf(TEXT("Frames: %d\n"), FrameMs.Num());
+	Report += FString::Printf(TEXT("Eliminations: %d\n"), NumEliminations);
+	Report += FString::Printf(TEXT("ForcedKills: %d\n"), NumForcedKills);
+
+	Report += TEXT("\n[FrameTime]\n");
+	AppendPercentiles(Report, TEXT("GameThreadMs"), GameThreadMs);
+	AppendPercentiles(Report, TEXT("FrameMs"), FrameMs);
+
+	Report += TEXT("\n[Memory]\n");
+	Report += FString::Printf(TEXT("StartUsedPhysicalMB: %.1f\n"), BytesToMB(StartUsedPhysical));
+	Report += FString::Printf(TEXT("PeakUsedPhysicalMB: %.1f\n"), BytesToMB(PeakUsedPhysical));
+	Report += FString::Printf(TEXT("PeakUsedVirtualMB: %.1f\n"), BytesToMB(PeakUsedVirtual));
+
+	Report += TEXT("\n[Network]\n");
+	Report += FString::Printf(TEXT("Connections: %d\n"), ConnectionTraffic.Num());
+	for (const TPair<TWeakObjectPtr<UNetConnection>, FConnectionTraffic>& Pair : ConnectionTraffic)
+	{
+		const FConnectionTraffic& Traffic = Pair.Value;
+		const double Seconds = FMath::Max(Traffic.ConnectedSeconds, 1.0);
+		Report += FString::Printf(TEXT("%s: InBytes=%lld OutBytes=%lld InBytesPerSec=%.0f OutBytesPerSec=%.0f\n"),
+			*Traffic.Name, Traffic.InBytes, Traffic.OutBytes, Traffic.InBytes / Seconds, Traffic.OutBytes / Seconds);
+	}
+
+	Report += TEXT("\n[Budgets]\n");
+	bool bPassed = true;
+
+	TArray<float> SortedGameThreadMs = GameThreadMs;
+	SortedGameThreadMs.Sort();
+	const float GameThreadMsP95 = GetPercentile(SortedGameThreadMs, 0.95f);
+	if (MaxGameThreadMsP95 > 0.0)
+	{
+		const bool bWithinBudget = (GameThreadMsP95 <= MaxGameThreadMsP95);
+		Report += FString::Printf(TEXT("GameThreadMsP95: %.2f / %.2f %s\n"), GameThreadMsP95, MaxGameThreadMsP95, bWithinBudget ? TEXT("PASS") : TEXT("FAIL"));
+		bPassed &= bWithinBudget;
+	}
+	if (MaxMemoryMB > 0.0)
+	{
+		const bool bWithinBudget = (BytesToMB(PeakUsedPhysical) <= MaxMemoryMB);
+		Report += FString::Printf(TEXT("PeakUsedPhysicalMB: %.1f / %.1f %s\n"), BytesToMB(PeakUsedPhysical), MaxMemoryMB, bWithinBudget ? TEXT("PASS") : TEXT("FAIL"));
+		bPassed &= bWithinBudget;
+	}
+	if (FrameMs.Num() == 0)
+	{
+		Report += TEXT("NoFramesMeasured: FAIL\n");
+		bPassed = false;
+	}
+	Report += FString::Printf(TEXT("Result: %s\n"), bPassed ? TEXT("PASS") : TEXT("FAIL"));
+
+	if (FFileHelper::SaveStringToFile(Report, *ReportFilename))
+	{
+		UE_LOG(LogLyra, Display, TEXT("SoakTest: wrote report to %s"), *ReportFilename);
+	}
+	else
+	{
+		UE_LOG(LogLyra, Error, TEXT("SoakTest: failed to write report to %s"), *ReportFilename);
+		bPassed = false;
+	}
+
+	UE_LOG(LogLyra, Display, TEXT("SoakTest: %s (game thread P95 %.2f ms, peak memory %.1f MB)"), bPassed ? TEXT("PASS") : TEXT("FAIL"), GameThreadMsP95, BytesToMB(PeakUsedPhysical));
+
+	return bPassed;
+}
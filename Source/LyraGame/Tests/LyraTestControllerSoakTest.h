@@ -0,0 +1,104 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+
+#pragma once
+
+#include "GameFramework/GameplayMessageSubsystem.h"
+#include "GauntletTestController.h"
+
+#include "LyraTestControllerSoakTest.generated.h"
+
+class UNetConnection;
+class UObject;
+struct FLyraVerbMessage;
+
+/**
+ * Server soak test: waits for the experience's bots to spawn, lets them fight for a fixed duration
+ * and writes frame time percentiles, memory high-water marks and per connection network traffic to a report
+ *
+ * Run a dedicated server with:
+ *   <Map>?Experience=<ExperienceWithBots>?NumBots=<N> -gauntlet=LyraTestControllerSoakTest -nullrhi -unattended
+ *
+ * Options:
+ *   -SoakDuration=<seconds>       How long to measure for (default 600)
+ *   -SoakWarmup=<seconds>         How long to wait after the bots are ready before measuring (default 30)
+ *   -SoakKillInterval=<seconds>   Self-destructs a random bot this often so respawns are part of the load (default 0, off)
+ *   -SoakReport=<file>            Where to write the report (default Saved/SoakTest/Soak_<Map>_<DateTime>.txt)
+ *   -SoakMaxGameThreadMsP95=<ms>  Fails the test if the 95th percentile game thread time is higher (default 0, off).
+ *                                 This is the work done per server frame, the frame time itself is pinned to the tick rate
+ *   -SoakMaxMemoryMB=<MB>         Fails the test if the peak used physical memory is higher (default 0, off)
+ *
+ * Per-subsystem timings are captured with the CSV profiler (and a stats file when stats are enabled) next to the report.
+ */
+UCLASS()
+class ULyraTestControllerSoakTest : public UGauntletTestController
+{
+	GENERATED_BODY()
+
+protected:
+	//~UGauntletTestController interface
+	virtual void OnInit() override;
+	virtual void OnTick(float TimeDelta) override;
+	//~End of UGauntletTestController interface
+
+private:
+	enum class ESoakPhase : uint8
+	{
+		WaitingForBots,
+		WarmingUp,
+		Measuring,
+		Finished
+	};
+
+	struct FConnectionTraffic
+	{
+		FString Name;
+		int64 StartInBytes = 0;
+		int64 StartOutBytes = 0;
+		int64 InBytes = 0;
+		int64 OutBytes = 0;
+		double ConnectedSeconds = 0.0;
+	};
+
+	void StartMeasuring();
+	void FinishMeasuring();
+
+	void SampleMemory();
+	void SampleConnections(float TimeDelta);
+	void KillRandomBot();
+
+	void OnEliminationMessage(FGameplayTag Channel, const FLyraVerbMessage& Payload);
+
+	// Writes the report and returns true if all budgets were met
+	bool WriteReport() const;
+
+private:
+	ESoakPhase Phase = ESoakPhase::WaitingForBots;
+	double PhaseStartTime = 0.0;
+	double TimeUntilNextKill = 0.0;
+
+	// Options
+	double SoakDuration = 600.0;
+	double WarmupDuration = 30.0;
+	double MaxWaitForBots = 300.0;
+	double KillInterval = 0.0;
+	double MaxGameThreadMsP95 = 0.0;
+	double MaxMemoryMB = 0.0;
+	FString ReportFilename;
+
+	// Results
+	TArray<float> GameThreadMs;
+	TArray<float> FrameMs;
+	uint64 PeakUsedPhysical = 0;
+	uint64 PeakUsedVirtual = 0;
+	uint64 StartUsedPhysical = 0;
+	int32 NumBots = 0;
+	int32 NumEliminations = 0;
+	int32 NumForcedKills = 0;
+	double TimeToAllBotsReady = -1.0;
+	double MeasuredDuration = 0.0;
+
+	TMap<TWeakObjectPtr<UNetConnection>, FConnectionTraffic> ConnectionTraffic;
+
+	FGameplayMessageListenerHandle EliminationListenerHandle;
+	bool bStartedCsvCapture = false;
+};
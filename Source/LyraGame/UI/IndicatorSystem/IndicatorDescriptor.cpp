@@ -10,9 +10,26 @@
 
 bool FIndicatorProjection::Project(const UIndicatorDescriptor& IndicatorDescriptor, const FSceneViewProjectionData& InProjectionData, const FVector2f& ScreenSize, FVector& OutScreenPositionWithDepth)
 {
-	if (USceneComponent* Component = IndicatorDescriptor.GetSceneComponent())
+	USceneComponent* Component = IndicatorDescriptor.GetSceneComponent();
+	if (Component == nullptr)
 	{
-		TOptional<FVector> WorldLocation;
+		return false;
+	}
+
+	FVector ProjectWorldPoint;
+	if (GetProjectionPoint(IndicatorDescriptor, ProjectWorldPoint))
+	{
+		FVector2D OutScreenSpacePosition;
+		const bool bInFrontOfCamera = ULocalPlayer::GetPixelPoint(InProjectionData, ProjectWorldPoint, OutScreenSpacePosition, &ScreenSize);
+
+		OutScreenPositionWithDepth = FinishPointProjection(IndicatorDescriptor, InProjectionData, ScreenSize, ProjectWorldPoint, OutScreenSpacePosition, bInFrontOfCamera);
+		return true;
+	}
+
+	const EActorCanvasProjectionMode ProjectionMode = IndicatorDescriptor.GetProjectionMode();
+	if ((ProjectionMode == EActorCanvasProjectionMode::ComponentScreenBoundingBox) || (ProjectionMode == EActorCanvasProjectionMode::ActorScreenBoundingBox))
+	{
+		FVector WorldLocation;
 		if (IndicatorDescriptor.GetComponentSocketName() != NAME_None)
 		{
 			WorldLocation = Component->GetSocketTransform(IndicatorDescriptor.GetComponentSocketName()).GetLocation();
@@ -21,105 +38,132 @@ bool FIndicatorProjection::Project(const UIndicatorDescriptor& IndicatorDescript
 		{
 			WorldLocation = Component->GetComponentLocation();
 		}
+		const FVector ProjectWorldLocation = WorldLocation + IndicatorDescriptor.GetWorldPositionOffset();
 
-		const FVector ProjectWorldLocation = WorldLocation.GetValue() + IndicatorDescriptor.GetWorldPositionOffset();
-		const EActorCanvasProjectionMode ProjectionMode = IndicatorDescriptor.GetProjectionMode();
-		
-		switch (ProjectionMode)
+		FBox IndicatorBox;
+		if (ProjectionMode == EActorCanvasProjectionMode::ActorScreenBoundingBox)
 		{
-			case EActorCanvasProjectionMode::ComponentPoint:
-			{
-				if (WorldLocation.IsSet())
-				{
-					FVector2D OutScreenSpacePosition;
-					const bool bInFrontOfCamera = ULocalPlayer::GetPixelPoint(InProjectionData, ProjectWorldLocation, OutScreenSpacePosition, &ScreenSize);
+			IndicatorBox = Component->GetOwner()->GetComponentsBoundingBox();
+		}
+		else
+		{
+			IndicatorBox = Component->Bounds.GetBox();
+		}
 
-					OutScreenSpacePosition.X += IndicatorDescriptor.GetScreenSpaceOffset().X * (bInFrontOfCamera ? 1 : -1);
-					OutScreenSpacePosition.Y += IndicatorDescriptor.GetScreenSpaceOffset().Y;
+		FVector2D LL, UR;
+		const bool bInFrontOfCamera = ULocalPlayer::GetPixelBoundingBox(InProjectionData, IndicatorBox, LL, UR, &ScreenSize);
+	
+		const FVector& BoundingBoxAnchor = IndicatorDescriptor.GetBoundingBoxAnchor();
+		const FVector2D& ScreenSpaceOffset = IndicatorDescriptor.GetScreenSpaceOffset();
 
-					if (!bInFrontOfCamera && FBox2f(FVector2f::Zero(), ScreenSize).IsInside((FVector2f)OutScreenSpacePosition))
-					{
-						const FVector2f CenterToPosition = (FVector2f(OutScreenSpacePosition) - (ScreenSize / 2)).GetSafeNormal();
-						OutScreenSpacePosition = FVector2D((ScreenSize / 2) + CenterToPosition * ScreenSize);
-					}
+		FVector ScreenPositionWithDepth;
+		ScreenPositionWithDepth.X = FMath::Lerp(LL.X, UR.X, BoundingBoxAnchor.X) + ScreenSpaceOffset.X * (bInFrontOfCamera ? 1 : -1);
+		ScreenPositionWithDepth.Y = FMath::Lerp(LL.Y, UR.Y, BoundingBoxAnchor.Y) + ScreenSpaceOffset.Y;
+		ScreenPositionWithDepth.Z = FVector::Dist(InProjectionData.ViewOrigin, ProjectWorldLocation);
 
-					OutScreenPositionWithDepth = FVector(OutScreenSpacePosition.X, OutScreenSpacePosition.Y, FVector::Dist(InProjectionData.ViewOrigin, ProjectWorldLocation));
+		const FVector2f ScreenSpacePosition = FVector2f(FVector2D(ScreenPositionWithDepth));
+		if (!bInFrontOfCamera && FBox2f(FVector2f::Zero(), ScreenSize).IsInside(ScreenSpacePosition))
+		{
+			const FVector2f CenterToPosition = (ScreenSpacePosition - (ScreenSize / 2)).GetSafeNormal();
+			const FVector2f ScreenPositionFromBehind = (ScreenSize / 2) + CenterToPosition * ScreenSize;
+			ScreenPositionWithDepth.X = ScreenPositionFromBehind.X;
+			ScreenPositionWithDepth.Y = ScreenPositionFromBehind.Y;
+		}
+		
+		OutScreenPositionWithDepth = ScreenPositionWithDepth;
+		return true;
+	}
+
+	return false;
+}
 
-					return true;
-				}
+bool FIndicatorProjection::GetProjectionPoint(const UIndicatorDescriptor& IndicatorDescriptor, FVector& OutWorldPoint)
+{
+	USceneComponent* Component = IndicatorDescriptor.GetSceneComponent();
+	if (Component == nullptr)
+	{
+		return false;
+	}
 
-				return false;
+	switch (IndicatorDescriptor.GetProjectionMode())
+	{
+		case EActorCanvasProjectionMode::ComponentPoint:
+		{
+			FVector WorldLocation;
+			if (IndicatorDescriptor.GetComponentSocketName() != NAME_None)
+			{
+				WorldLocation = Component->GetSocketTransform(IndicatorDescriptor.GetComponentSocketName()).GetLocation();
 			}
-			case EActorCanvasProjectionMode::ComponentScreenBoundingBox:
-			case EActorCanvasProjectionMode::ActorScreenBoundingBox:
+			else
 			{
-				FBox IndicatorBox;
-				if (ProjectionMode == EActorCanvasProjectionMode::ActorScreenBoundingBox)
-				{
-					IndicatorBox = Component->GetOwner()->GetComponentsBoundingBox();
-				}
-				else
-				{
-					IndicatorBox = Component->Bounds.GetBox();
-				}
-
-				FVector2D LL, UR;
-				const bool bInFrontOfCamera = ULocalPlayer::GetPixelBoundingBox(InProjectionData, IndicatorBox, LL, UR, &ScreenSize);
-			
-				const FVector& BoundingBoxAnchor = IndicatorDescriptor.GetBoundingBoxAnchor();
-				const FVector2D& ScreenSpaceOffset = IndicatorDescriptor.GetScreenSpaceOffset();
-
-				FVector ScreenPositionWithDepth;
-				ScreenPositionWithDepth.X = FMath::Lerp(LL.X, UR.X, BoundingBoxAnchor.X) + ScreenSpaceOffset.X * (bInFrontOfCamera ? 1 : -1);
-				ScreenPositionWithDepth.Y = FMath::Lerp(LL.Y, UR.Y, BoundingBoxAnchor.Y) + ScreenSpaceOffset.Y;
-				ScreenPositionWithDepth.Z = FVector::Dist(InProjectionData.ViewOrigin, ProjectWorldLocation);
-
-				const FVector2f ScreenSpacePosition = FVector2f(FVector2D(ScreenPositionWithDepth));
-				if (!bInFrontOfCamera && FBox2f(FVector2f::Zero(), ScreenSize).IsInside(ScreenSpacePosition))
-				{
-					const FVector2f CenterToPosition = (ScreenSpacePosition - (ScreenSize / 2)).GetSafeNormal();
-					const FVector2f ScreenPositionFromBehind = (ScreenSize / 2) + CenterToPosition * ScreenSize;
-					ScreenPositionWithDepth.X = ScreenPositionFromBehind.X;
-					ScreenPositionWithDepth.Y = ScreenPositionFromBehind.Y;
-				}
-				
-				OutScreenPositionWithDepth = ScreenPositionWithDepth;
-				return true;
+				WorldLocation = Component->GetComponentLocation();
 			}
-			case EActorCanvasProjectionMode::ActorBoundingBox:
-			case EActorCanvasProjectionMode::ComponentBoundingBox:
+
+			OutWorldPoint = WorldLocation + IndicatorDescriptor.GetWorldPositionOffset();
+			return true;
+		}
+		case EActorCanvasProjectionMode::ActorBoundingBox:
+		case EActorCanvasProjectionMode::ComponentBoundingBox:
+		{
+			FBox IndicatorBox;
+			if (IndicatorDescriptor.GetProjectionMode() == EActorCanvasProjectionMode::ActorBoundingBox)
 			{
-				FBox IndicatorBox;
-				if (ProjectionMode == EActorCanvasProjectionMode::ActorBoundingBox)
-				{
-					IndicatorBox = Component->GetOwner()->GetComponentsBoundingBox();
-				}
-				else
-				{
-					IndicatorBox = Component->Bounds.GetBox();
-				}
-
-				const FVector ProjectBoxPoint = IndicatorBox.GetCenter() + (IndicatorBox.GetSize() * (IndicatorDescriptor.GetBoundingBoxAnchor() - FVector(0.5)));
-
-				FVector2D OutScreenSpacePosition;
-				const bool bInFrontOfCamera = ULocalPlayer::GetPixelPoint(InProjectionData, ProjectBoxPoint, OutScreenSpacePosition, &ScreenSize);
-				OutScreenSpacePosition.X += IndicatorDescriptor.GetScreenSpaceOffset().X * (bInFrontOfCamera ? 1 : -1);
-				OutScreenSpacePosition.Y += IndicatorDescriptor.GetScreenSpaceOffset().Y;
-
-				if (!bInFrontOfCamera && FBox2f(FVector2f::Zero(), ScreenSize).IsInside((FVector2f)OutScreenSpacePosition))
-				{
-					const FVector2f CenterToPosition = (FVector2f(OutScreenSpacePosition) - (ScreenSize / 2)).GetSafeNormal();
-					OutScreenSpacePosition = FVector2D((ScreenSize / 2) + CenterToPosition * ScreenSize);
-				}
-
-				OutScreenPositionWithDepth = FVector(OutScreenSpacePosition.X, OutScreenSpacePosition.Y, FVector::Dist(InProjectionData.ViewOrigin, ProjectBoxPoint));
-					
-				return true;
+				IndicatorBox = Component->GetOwner()->GetComponentsBoundingBox();
 			}
+			else
+			{
+				IndicatorBox = Component->Bounds.GetBox();
+			}
+
+			OutWorldPoint = IndicatorBox.GetCenter() + (IndicatorBox.GetSize() * (IndicatorDescriptor.GetBoundingBoxAnchor() - FVector(0.5)));
+			return true;
 		}
+		default:
+			return false;
 	}
+}
 
-	return false;
+void FIndicatorProjection::ProjectPoints(const FMatrix& ViewProjectionMatrix, const FSceneViewProjectionData& InProjectionData, const FVector2f& ScreenSize, TConstArrayView<FVector> WorldPoints, TArrayView<FVector2D> OutScreenPositions, TBitArray<>& OutInFrontOfCamera)
+{
+	check(WorldPoints.Num() == OutScreenPositions.Num());
+
+	const FIntRect& ViewRect = InProjectionData.GetConstrainedViewRect();
+	const double ViewWidth = ViewRect.Width();
+	const double ViewHeight = ViewRect.Height();
+	const double RatioX = (ViewWidth > 0.0) ? (ScreenSize.X / ViewWidth) : 1.0;
+	const double RatioY = (ViewHeight > 0.0) ? (ScreenSize.Y / ViewHeight) : 1.0;
+
+	OutInFrontOfCamera.Init(false, WorldPoints.Num());
+
+	for (int32 PointIndex = 0; PointIndex < WorldPoints.Num(); ++PointIndex)
+	{
+		// TransformFVector4 is a SIMD transform, this is the only per point matrix work
+		const FVector4 ScreenPoint = ViewProjectionMatrix.TransformFVector4(FVector4(WorldPoints[PointIndex], 1.0));
+
+		const bool bInFrontOfCamera = (ScreenPoint.W > 0.0);
+		const double AbsW = FMath::Abs(ScreenPoint.W);
+		const double InvW = (AbsW > UE_SMALL_NUMBER) ? (1.0 / AbsW) : 1.0;
+
+		OutScreenPositions[PointIndex] = FVector2D(
+			(ViewRect.Min.X + (0.5 + ScreenPoint.X * 0.5 * InvW) * ViewWidth) * RatioX,
+			(ViewRect.Min.Y + (0.5 - ScreenPoint.Y * 0.5 * InvW) * ViewHeight) * RatioY);
+
+		OutInFrontOfCamera[PointIndex] = bInFrontOfCamera;
+	}
+}
+
+FVector FIndicatorProjection::FinishPointProjection(const UIndicatorDescriptor& IndicatorDescriptor, const FSceneViewProjectionData& InProjectionData, const FVector2f& ScreenSize, const FVector& WorldPoint, FVector2D ScreenPosition, bool bInFrontOfCamera)
+{
+	ScreenPosition.X += IndicatorDescriptor.GetScreenSpaceOffset().X * (bInFrontOfCamera ? 1 : -1);
+	ScreenPosition.Y += IndicatorDescriptor.GetScreenSpaceOffset().Y;
+
+	if (!bInFrontOfCamera && FBox2f(FVector2f::Zero(), ScreenSize).IsInside((FVector2f)ScreenPosition))
+	{
+		const FVector2f CenterToPosition = (FVector2f(ScreenPosition) - (ScreenSize / 2)).GetSafeNormal();
+		ScreenPosition = FVector2D((ScreenSize / 2) + CenterToPosition * ScreenSize);
+	}
+
+	return FVector(ScreenPosition.X, ScreenPosition.Y, FVector::Dist(InProjectionData.ViewOrigin, WorldPoint));
 }
 
 void UIndicatorDescriptor::SetIndicatorManagerComponent(ULyraIndicatorManagerComponent* InManager)
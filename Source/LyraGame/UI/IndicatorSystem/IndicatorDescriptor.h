@@ -17,6 +17,16 @@ struct FSceneViewProjectionData;
 struct FIndicatorProjection
 {
 	bool Project(const UIndicatorDescriptor& IndicatorDescriptor, const FSceneViewProjectionData& InProjectionData, const FVector2f& ScreenSize, FVector& ScreenPositionWithDepth);
+
+	// Gets the world point the indicator is projected from, returns false if the indicator has no component or
+	// uses a screen bounding box projection mode (which can't be done as a single point)
+	static bool GetProjectionPoint(const UIndicatorDescriptor& IndicatorDescriptor, FVector& OutWorldPoint);
+
+	// Projects a batch of world points with a single view projection matrix, matching ULocalPlayer::GetPixelPoint
+	static void ProjectPoints(const FMatrix& ViewProjectionMatrix, const FSceneViewProjectionData& InProjectionData, const FVector2f& ScreenSize, TConstArrayView<FVector> WorldPoints, TArrayView<FVector2D> OutScreenPositions, TBitArray<>& OutInFrontOfCamera);
+
+	// Applies the indicator's screen space offset and pushes points behind the camera to the edge of the screen
+	static FVector FinishPointProjection(const UIndicatorDescriptor& IndicatorDescriptor, const FSceneViewProjectionData& InProjectionData, const FVector2f& ScreenSize, const FVector& WorldPoint, FVector2D ScreenPosition, bool bInFrontOfCamera);
 };
 
 UENUM(BlueprintType)
@@ -158,6 +168,15 @@ public:
 		ScreenSpaceOffset = Offset;
 	}
 
+	// Hides the indicator when it is further than this from the camera (0 means no limit)
+	UFUNCTION(BlueprintCallable)
+	float GetMaxVisibleDistance() const { return MaxVisibleDistance; }
+	UFUNCTION(BlueprintCallable)
+	void SetMaxVisibleDistance(float InMaxVisibleDistance)
+	{
+		MaxVisibleDistance = InMaxVisibleDistance;
+	}
+
 	UFUNCTION(BlueprintCallable)
 	FVector GetBoundingBoxAnchor() const { return BoundingBoxAnchor; }
 	UFUNCTION(BlueprintCallable)
@@ -209,6 +228,9 @@ private:
 	UPROPERTY()
 	int32 Priority = 0;
 
+	UPROPERTY()
+	float MaxVisibleDistance = 0.0f;
+
 	UPROPERTY()
 	FVector BoundingBoxAnchor = FVector(0.5, 0.5, 0.5);
 	UPROPERTY()
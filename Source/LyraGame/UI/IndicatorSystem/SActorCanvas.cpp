@@ -2,7 +2,9 @@
 
 #include "SActorCanvas.h"
 
+#include "ConvexVolume.h"
 #include "Engine/GameViewportClient.h"
+#include "HAL/IConsoleManager.h"
 #include "IActorIndicatorWidget.h"
 #include "Layout/ArrangedChildren.h"
 #include "LyraIndicatorManagerComponent.h"
@@ -13,6 +15,51 @@
 
 class FSlateRect;
 
+namespace LyraIndicatorCVars
+{
+	static bool bBatchProjection = true;
+	static FAutoConsoleVariableRef CVarBatchProjection(
+		TEXT("Lyra.Indicators.BatchProjection"),
+		bBatchProjection,
+		TEXT("Should point and bounding box indicators be culled and projected together with one view projection matrix?"),
+		ECVF_Default);
+
+	static float FrustumCullRadius = 50.0f;
+	static FAutoConsoleVariableRef CVarFrustumCullRadius(
+		TEXT("Lyra.Indicators.FrustumCullRadius"),
+		FrustumCullRadius,
+		TEXT("Radius (cm) around an indicator's world point that must be in the view frustum for it to be shown (indicators clamped to the screen are never frustum culled)"),
+		ECVF_Default);
+
+	static int32 MaxLiveWidgets = 32;
+	static FAutoConsoleVariableRef CVarMaxLiveWidgets(
+		TEXT("Lyra.Indicators.MaxLiveWidgets"),
+		MaxLiveWidgets,
+		TEXT("Maximum number of indicators that get a widget, the best ranked ones by priority, distance and screen position (0 or less means no limit)"),
+		ECVF_Default);
+
+	static float RankInterval = 0.1f;
+	static FAutoConsoleVariableRef CVarRankInterval(
+		TEXT("Lyra.Indicators.RankInterval"),
+		RankInterval,
+		TEXT("Seconds between re-ranking indicators to decide which ones get widgets"),
+		ECVF_Default);
+
+	static float ScreenCenterWeight = 1.0f;
+	static FAutoConsoleVariableRef CVarScreenCenterWeight(
+		TEXT("Lyra.Indicators.ScreenCenterWeight"),
+		ScreenCenterWeight,
+		TEXT("How much being away from the center of the screen counts against an indicator's rank, relative to its distance"),
+		ECVF_Default);
+
+	static float LiveWidgetHysteresis = 0.25f;
+	static FAutoConsoleVariableRef CVarLiveWidgetHysteresis(
+		TEXT("Lyra.Indicators.LiveWidgetHysteresis"),
+		LiveWidgetHysteresis,
+		TEXT("Fraction an indicator's rank score is reduced by while it has a widget, so indicators near the cut off don't keep swapping"),
+		ECVF_Default);
+}
+
 namespace EArrowDirection
 {
 	enum Type
@@ -202,22 +249,66 @@ EActiveTimerReturnType SActorCanvas::UpdateCanvas(double InCurrentTime, float In
 
 			bool IndicatorsChanged = false;
 
-			for (int32 ChildIndex = 0; ChildIndex < CanvasChildren.Num(); ++ChildIndex)
+			const FMatrix ViewProjectionMatrix = ProjectionData.ComputeViewProjectionMatrix();
+			FConvexVolume ViewFrustum;
+			GetViewFrustumBounds(ViewFrustum, ViewProjectionMatrix, /*bUseNearPlane=*/ false);
+
+			// Virtualized indicators have no slot, so this covers them as well as the ones with widgets
+			IndicatorsChanged |= RemoveAutomaticallyRemovableIndicators();
+
+			if ((LastRankTime < 0.0) || (InCurrentTime - LastRankTime >= LyraIndicatorCVars::RankInterval))
 			{
-				SActorCanvas::FSlot& CurChild = CanvasChildren[ChildIndex];
-				UIndicatorDescriptor* Indicator = CurChild.Indicator;
+				LastRankTime = InCurrentTime;
+				UpdateLiveIndicators(ProjectionData, ViewProjectionMatrix, ViewFrustum);
+			}
+
+			auto ApplyProjectionResult = [this, &IndicatorsChanged](SActorCanvas::FSlot& CurChild, bool Success, const FVector& ScreenPositionWithDepth)
+			{
+				const UIndicatorDescriptor* Indicator = CurChild.Indicator;
 
-				// If the slot content is invalid and we have permission to remove it
-				if (Indicator->CanAutomaticallyRemove())
+				const float MaxVisibleDistance = Indicator->GetMaxVisibleDistance();
+				if (Success && MaxVisibleDistance > 0.0f && ScreenPositionWithDepth.Z > MaxVisibleDistance)
 				{
-					IndicatorsChanged = true;
+					Success = false;
+				}
 
-					RemoveIndicatorForEntry(Indicator);
-					// Decrement the current index to account for the removal 
-					--ChildIndex;
-					continue;
+				if (!Success)
+				{
+					CurChild.SetHasValidScreenPosition(false);
+					CurChild.SetInFrontOfCamera(false);
+
+					IndicatorsChanged |= CurChild.bIsDirty();
+					CurChild.ClearDirtyFlag();
+					return;
 				}
 
+				CurChild.SetInFrontOfCamera(Success);
+				CurChild.SetHasValidScreenPosition(CurChild.GetInFrontOfCamera() || Indicator->GetClampToScreen());
+
+				if (CurChild.HasValidScreenPosition())
+				{
+					// Only dirty the screen position if we can actually show this indicator.
+					CurChild.SetScreenPosition(FVector2D(ScreenPositionWithDepth));
+
+					bSortOrderDirty |= (CurChild.GetDepth() != ScreenPositionWithDepth.Z);
+					CurChild.SetDepth(ScreenPositionWithDepth.Z);
+				}
+
+				bSortOrderDirty |= (CurChild.GetPriority() != Indicator->GetPriority());
+				CurChild.SetPriority(Indicator->GetPriority());
+
+				IndicatorsChanged |= CurChild.bIsDirty();
+				CurChild.ClearDirtyFlag();
+			};
+
+			BatchSlots.Reset();
+			BatchWorldPoints.Reset();
+
+			for (int32 ChildIndex = 0; ChildIndex < CanvasChildren.Num(); ++ChildIndex)
+			{
+				SActorCanvas::FSlot& CurChild = CanvasChildren[ChildIndex];
+				UIndicatorDescriptor* Indicator = CurChild.Indicator;
+
 				CurChild.SetIsIndicatorVisible(Indicator->GetIsVisible());
 
 				if (!CurChild.GetIsIndicatorVisible())
@@ -235,35 +326,48 @@ EActiveTimerReturnType SActorCanvas::UpdateCanvas(double InCurrentTime, float In
 					IndicatorsChanged = true;
 				}
 
+				FVector WorldPoint;
+				if (LyraIndicatorCVars::bBatchProjection && FIndicatorProjection::GetProjectionPoint(*Indicator, /*out*/ WorldPoint))
+				{
+					// Cull before projecting, indicators clamped to the screen still need a position when they're off screen
+					const float MaxVisibleDistance = Indicator->GetMaxVisibleDistance();
+					const bool bTooFar = (MaxVisibleDistance > 0.0f) && (FVector::DistSquared(ProjectionData.ViewOrigin, WorldPoint) > FMath::Square(MaxVisibleDistance));
+					const bool bOutsideFrustum = !Indicator->GetClampToScreen() && !ViewFrustum.IntersectSphere(WorldPoint, LyraIndicatorCVars::FrustumCullRadius);
+
+					if (bTooFar || bOutsideFrustum)
+					{
+						ApplyProjectionResult(CurChild, false, FVector::ZeroVector);
+					}
+					else
+					{
+						BatchSlots.Add(&CurChild);
+						BatchWorldPoints.Add(WorldPoint);
+					}
+					continue;
+				}
+
 				FVector ScreenPositionWithDepth;
 
 				FIndicatorProjection Projector;
 				const bool Success = Projector.Project(*Indicator, ProjectionData, PaintGeometry.Size, OUT ScreenPositionWithDepth);
 
-				if (!Success)
-				{
-					CurChild.SetHasValidScreenPosition(false);
-					CurChild.SetInFrontOfCamera(false);
-
-					IndicatorsChanged |= CurChild.bIsDirty();
-					CurChild.ClearDirtyFlag();
-					continue;
-				}
+				ApplyProjectionResult(CurChild, Success, ScreenPositionWithDepth);
+			}
 
-				CurChild.SetInFrontOfCamera(Success);
-				CurChild.SetHasValidScreenPosition(CurChild.GetInFrontOfCamera() || Indicator->GetClampToScreen());
+			// Project everything that survived culling in one pass (slots are heap allocated so the pointers survive removals above)
+			if (BatchSlots.Num() > 0)
+			{
+				BatchScreenPositions.SetNumUninitialized(BatchWorldPoints.Num());
+				FIndicatorProjection::ProjectPoints(ViewProjectionMatrix, ProjectionData, PaintGeometry.Size, BatchWorldPoints, BatchScreenPositions, /*out*/ BatchInFrontOfCamera);
 
-				if (CurChild.HasValidScreenPosition())
+				for (int32 BatchIndex = 0; BatchIndex < BatchSlots.Num(); ++BatchIndex)
 				{
-					// Only dirty the screen position if we can actually show this indicator.
-					CurChild.SetScreenPosition(FVector2D(ScreenPositionWithDepth));
-					CurChild.SetDepth(ScreenPositionWithDepth.X);
-				}
+					SActorCanvas::FSlot& CurChild = *BatchSlots[BatchIndex];
+					const FVector ScreenPositionWithDepth = FIndicatorProjection::FinishPointProjection(*CurChild.Indicator, ProjectionData, PaintGeometry.Size,
+						BatchWorldPoints[BatchIndex], BatchScreenPositions[BatchIndex], BatchInFrontOfCamera[BatchIndex]);
 
-				CurChild.SetPriority(Indicator->GetPriority());
-
-				IndicatorsChanged |= CurChild.bIsDirty();
-				CurChild.ClearDirtyFlag();
+					ApplyProjectionResult(CurChild, true, ScreenPositionWithDepth);
+				}
 			}
 
 			if (IndicatorsChanged)
@@ -292,6 +396,137 @@ EActiveTimerReturnType SActorCanvas::UpdateCanvas(double InCurrentTime, float In
 	}
 }
 
+void SActorCanvas::UpdateLiveIndicators(const FSceneViewProjectionData& ProjectionData, const FMatrix& ViewProjectionMatrix, const FConvexVolume& ViewFrustum)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_SActorCanvas_UpdateLiveIndicators);
+
+	auto MakeLive = [this](UIndicatorDescriptor* Indicator)
+	{
+		bool bAlreadyLive = false;
+		LiveIndicators.Add(Indicator, &bAlreadyLive);
+		if (!bAlreadyLive)
+		{
+			AddIndicatorForEntry(Indicator);
+		}
+	};
+
+	const int32 MaxLiveWidgets = LyraIndicatorCVars::MaxLiveWidgets;
+	if (MaxLiveWidgets <= 0)
+	{
+		// No budget, every indicator gets a widget
+		for (UIndicatorDescriptor* Indicator : AllIndicators)
+		{
+			if (!Indicator->CanAutomaticallyRemove())
+			{
+				MakeLive(Indicator);
+			}
+		}
+		return;
+	}
+
+	// Rank every indicator that could be shown, this only touches descriptors and components so it stays cheap
+	RankedIndicators.Reset();
+	for (UIndicatorDescriptor* Indicator : AllIndicators)
+	{
+		// Indicators without a component can't be placed, the auto removable ones are dropped by RemoveAutomaticallyRemovableIndicators
+		USceneComponent* SceneComponent = Indicator->GetSceneComponent();
+		if (!IsValid(SceneComponent) || !Indicator->GetIsVisible())
+		{
+			continue;
+		}
+
+		FVector WorldPoint;
+		if (!FIndicatorProjection::GetProjectionPoint(*Indicator, /*out*/ WorldPoint))
+		{
+			WorldPoint = SceneComponent->GetComponentLocation() + Indicator->GetWorldPositionOffset();
+		}
+
+		const double Distance = FVector::Dist(ProjectionData.ViewOrigin, WorldPoint);
+		const float MaxVisibleDistance = Indicator->GetMaxVisibleDistance();
+		if ((MaxVisibleDistance > 0.0f) && (Distance > MaxVisibleDistance))
+		{
+			continue;
+		}
+
+		if (!Indicator->GetClampToScreen() && !ViewFrustum.IntersectSphere(WorldPoint, LyraIndicatorCVars::FrustumCullRadius))
+		{
+			continue;
+		}
+
+		// Distance from the center of the screen in normalized device coordinates, points behind the camera count as the edge
+		const FVector4 ScreenPoint = ViewProjectionMatrix.TransformFVector4(FVector4(WorldPoint, 1.0));
+		const double ScreenCenterOffset = (ScreenPoint.W > 0.0) ? FMath::Min(FVector2D(ScreenPoint.X, ScreenPoint.Y).Size() / ScreenPoint.W, 2.0) : 2.0;
+
+		FRankedIndicator& Ranked = RankedIndicators.AddDefaulted_GetRef();
+		Ranked.Indicator = Indicator;
+		Ranked.Priority = Indicator->GetPriority();
+		Ranked.Score = Distance * (1.0 + LyraIndicatorCVars::ScreenCenterWeight * ScreenCenterOffset);
+
+		if (LiveIndicators.Contains(Indicator))
+		{
+			Ranked.Score *= (1.0 - FMath::Clamp(LyraIndicatorCVars::LiveWidgetHysteresis, 0.0f, 1.0f));
+		}
+	}
+
+	// Highest priority first, then the lowest score
+	RankedIndicators.Sort([](const FRankedIndicator& A, const FRankedIndicator& B)
+	{
+		return A.Priority == B.Priority ? A.Score < B.Score : A.Priority > B.Priority;
+	});
+
+	const int32 NumLive = FMath::Min(RankedIndicators.Num(), MaxLiveWidgets);
+
+	TSet<UIndicatorDescriptor*> WantedLiveIndicators;
+	WantedLiveIndicators.Reserve(NumLive);
+	for (int32 RankIndex = 0; RankIndex < NumLive; ++RankIndex)
+	{
+		WantedLiveIndicators.Add(RankedIndicators[RankIndex].Indicator);
+	}
+
+	// Release the widgets of indicators that fell out of the budget first, so the new ones can reuse them from the pool
+	for (auto It = LiveIndicators.CreateIterator(); It; ++It)
+	{
+		UIndicatorDescriptor* Indicator = *It;
+		if (!WantedLiveIndicators.Contains(Indicator))
+		{
+			It.RemoveCurrent();
+			RemoveIndicatorForEntry(Indicator);
+			InactiveIndicators.AddUnique(Indicator);
+		}
+	}
+
+	for (UIndicatorDescriptor* Indicator : WantedLiveIndicators)
+	{
+		MakeLive(Indicator);
+	}
+}
+
+bool SActorCanvas::RemoveAutomaticallyRemovableIndicators()
+{
+	bool bRemovedAny = false;
+	for (int32 Index = AllIndicators.Num() - 1; Index >= 0; --Index)
+	{
+		UIndicatorDescriptor* Indicator = AllIndicators[Index];
+		if (Indicator->CanAutomaticallyRemove())
+		{
+			RemoveIndicatorForEntry(Indicator);
+
+			LiveIndicators.Remove(Indicator);
+			InactiveIndicators.Remove(Indicator);
+			AllIndicators.RemoveAt(Index);
+			bRemovedAny = true;
+		}
+	}
+
+	if (bRemovedAny)
+	{
+		// Let the next best indicators take over the widgets
+		LastRankTime = -1.0;
+	}
+
+	return bRemovedAny;
+}
+
 void SActorCanvas::SetShowAnyIndicators(bool bIndicators)
 {
 	if (bShowAnyIndicators != bIndicators)
@@ -322,16 +557,7 @@ void SActorCanvas::OnArrangeChildren(const FGeometry& AllottedGeometry, FArrange
 		const FVector Center = FVector(AllottedGeometry.Size * 0.5f, 0.0f);
 
 		// Sort the children
-		TArray<const SActorCanvas::FSlot*> SortedSlots;
-		for (int32 ChildIndex = 0; ChildIndex < CanvasChildren.Num(); ++ChildIndex)
-		{
-			SortedSlots.Add(&CanvasChildren[ChildIndex]);
-		}
-
-		SortedSlots.StableSort([](const SActorCanvas::FSlot& A, const SActorCanvas::FSlot& B)
-		{
-			return A.GetPriority() == B.GetPriority() ? A.GetDepth() > B.GetDepth() : A.GetPriority() < B.GetPriority();
-		});
+		UpdateSortedSlots();
 
 		// Go through all the sorted children
 		for (int32 ChildIndex = 0; ChildIndex < SortedSlots.Num(); ++ChildIndex)
@@ -501,6 +727,49 @@ void SActorCanvas::OnArrangeChildren(const FGeometry& AllottedGeometry, FArrange
 	ArrowIndexLastUpdate = NextArrowIndex;
 }
 
+void SActorCanvas::UpdateSortedSlots() const
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_SActorCanvas_UpdateSortedSlots);
+
+	auto IsSortedBefore = [](const SActorCanvas::FSlot& A, const SActorCanvas::FSlot& B)
+	{
+		return A.GetPriority() == B.GetPriority() ? A.GetDepth() > B.GetDepth() : A.GetPriority() < B.GetPriority();
+	};
+
+	if (bSortedSlotsNeedRebuild || (SortedSlots.Num() != CanvasChildren.Num()))
+	{
+		SortedSlots.Reset(CanvasChildren.Num());
+		for (int32 ChildIndex = 0; ChildIndex < CanvasChildren.Num(); ++ChildIndex)
+		{
+			SortedSlots.Add(&CanvasChildren[ChildIndex]);
+		}
+
+		SortedSlots.StableSort(IsSortedBefore);
+
+		bSortedSlotsNeedRebuild = false;
+		bSortOrderDirty = false;
+	}
+	else if (bSortOrderDirty)
+	{
+		// Indicators rarely move far in the order between updates, so an insertion sort of last update's order is close to linear
+		for (int32 SortIndex = 1; SortIndex < SortedSlots.Num(); ++SortIndex)
+		{
+			const SActorCanvas::FSlot* SlotToInsert = SortedSlots[SortIndex];
+
+			int32 InsertIndex = SortIndex;
+			while ((InsertIndex > 0) && IsSortedBefore(*SlotToInsert, *SortedSlots[InsertIndex - 1]))
+			{
+				SortedSlots[InsertIndex] = SortedSlots[InsertIndex - 1];
+				--InsertIndex;
+			}
+
+			SortedSlots[InsertIndex] = SlotToInsert;
+		}
+
+		bSortOrderDirty = false;
+	}
+}
+
 int32 SActorCanvas::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
 {
 	QUICK_SCOPE_CYCLE_COUNTER(STAT_SActorCanvas_OnPaint);
@@ -547,8 +816,10 @@ void SActorCanvas::OnIndicatorAdded(UIndicatorDescriptor* Indicator)
 {
 	AllIndicators.Add(Indicator);
 	InactiveIndicators.Add(Indicator);
-	
-	AddIndicatorForEntry(Indicator);
+
+	// Widgets are created by UpdateLiveIndicators once the indicator ranks within the budget
+	LastRankTime = -1.0;
+	UpdateActiveTimer();
 }
 
 void SActorCanvas::OnIndicatorRemoved(UIndicatorDescriptor* Indicator)
@@ -557,6 +828,10 @@ void SActorCanvas::OnIndicatorRemoved(UIndicatorDescriptor* Indicator)
 	
 	AllIndicators.Remove(Indicator);
 	InactiveIndicators.Remove(Indicator);
+	LiveIndicators.Remove(Indicator);
+
+	// Let the next best indicator take over the widget
+	LastRankTime = -1.0;
 }
 
 void SActorCanvas::AddIndicatorForEntry(UIndicatorDescriptor* Indicator)
@@ -569,8 +844,8 @@ void SActorCanvas::AddIndicatorForEntry(UIndicatorDescriptor* Indicator)
 		AsyncLoad(IndicatorClass, [this, IndicatorPtr, IndicatorClass]() {
 			if (UIndicatorDescriptor* Indicator = IndicatorPtr.Get())
 			{
-				// While async loading this indicator widget we could have removed it.
-				if (!AllIndicators.Contains(Indicator))
+				// While async loading this indicator widget we could have removed it, or it could have dropped out of the budget.
+				if (!AllIndicators.Contains(Indicator) || !LiveIndicators.Contains(Indicator) || Indicator->CanvasHost.IsValid())
 				{
 					return;
 				}
@@ -631,6 +906,7 @@ SActorCanvas::FScopedWidgetSlotArguments SActorCanvas::AddActorSlot(UIndicatorDe
 		{
 			if (TSharedPtr<SActorCanvas> Canvas = WeakCanvas.Pin())
 			{
+				Canvas->bSortedSlotsNeedRebuild = true;
 				Canvas->UpdateActiveTimer();
 			}
 		}};
@@ -643,6 +919,7 @@ int32 SActorCanvas::RemoveActorSlot(const TSharedRef<SWidget>& SlotWidget)
 		if ( SlotWidget == CanvasChildren[SlotIdx].GetWidget() )
 		{
 			CanvasChildren.RemoveAt(SlotIdx);
+			bSortedSlotsNeedRebuild = true;
 
 			UpdateActiveTimer();
 
@@ -16,6 +16,8 @@ class FSlateWindowElementList;
 class FWidgetStyle;
 class UIndicatorDescriptor;
 class ULyraIndicatorManagerComponent;
+struct FConvexVolume;
+struct FSceneViewProjectionData;
 struct FSlateBrush;
 
 class SActorCanvas : public SPanel, public FAsyncMixin, public FGCObject
@@ -213,6 +215,10 @@ private:
 	int32 RemoveActorSlot(const TSharedRef<SWidget>& SlotWidget);
 
 	void SetShowAnyIndicators(bool bIndicators);
+
+	// Drops every indicator, with or without a widget, whose component is gone and that is allowed to be removed automatically
+	bool RemoveAutomaticallyRemovableIndicators();
+
 	EActiveTimerReturnType UpdateCanvas(double InCurrentTime, float InDeltaTime);
 
 	/** Helper function for calculating the offset */
@@ -224,9 +230,28 @@ private:
 
 	void UpdateActiveTimer();
 
+	// Brings SortedSlots up to date, only re-sorting when a slot's priority or depth changed
+	void UpdateSortedSlots() const;
+
+	// Ranks the indicators by priority, distance and screen position, and gives widgets to the best Lyra.Indicators.MaxLiveWidgets
+	// of them. The rest stay as descriptors only, without a slot, until they rank high enough.
+	void UpdateLiveIndicators(const FSceneViewProjectionData& ProjectionData, const FMatrix& ViewProjectionMatrix, const FConvexVolume& ViewFrustum);
+
+	struct FRankedIndicator
+	{
+		UIndicatorDescriptor* Indicator = nullptr;
+		int32 Priority = 0;
+		double Score = 0.0;
+	};
+
 private:
 	TArray<TObjectPtr<UIndicatorDescriptor>> AllIndicators;
 	TArray<UIndicatorDescriptor*> InactiveIndicators;
+
+	/** Indicators that have (or are loading) a widget, the rest of AllIndicators are virtualized */
+	TSet<UIndicatorDescriptor*> LiveIndicators;
+	TArray<FRankedIndicator> RankedIndicators;
+	double LastRankTime = -1.0;
 	
 	FLocalPlayerContext LocalPlayerContext;
 	TWeakObjectPtr<ULyraIndicatorManagerComponent> IndicatorComponentPtr;
@@ -250,5 +275,16 @@ private:
 
 	mutable TOptional<FGeometry> OptionalPaintGeometry;
 
+	/** Canvas slots in arrange order (by priority, then back to front), kept between updates so re-sorting is cheap */
+	mutable TArray<const FSlot*> SortedSlots;
+	mutable bool bSortedSlotsNeedRebuild = true;
+	mutable bool bSortOrderDirty = false;
+
+	/** Scratch buffers for batch projecting point indicators, kept to avoid allocating every update */
+	TArray<FSlot*> BatchSlots;
+	TArray<FVector> BatchWorldPoints;
+	TArray<FVector2D> BatchScreenPositions;
+	TBitArray<> BatchInFrontOfCamera;
+
 	TSharedPtr<FActiveTimerHandle> TickHandle;
 };
@@ -0,0 +1,413 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "LyraDamageJournalSubsystem.h"
+
+#include "Abilities/GameplayAbilityTargetTypes.h"
+#include "Containers/Queue.h"
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "LyraLogChannels.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryWriter.h"
+
+#include <atomic>
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(LyraDamageJournalSubsystem)
+
+DECLARE_CYCLE_STAT(TEXT("Damage Journal Flush Frame"), STAT_LyraDamageJournal_FlushFrame, STATGROUP_Game);
+
+namespace LyraDamageJournalCVars
+{
+	static bool bEnableDamageJournal = false;
+	static FAutoConsoleVariableRef CVarEnableDamageJournal(
+		TEXT("Lyra.DamageJournal.Enable"),
+		bEnableDamageJournal,
+		TEXT("If true, servers record shots, damage and kills to Saved/DamageJournal for offline analysis (takes effect for worlds that begin play afterwards). Can also be enabled with -DamageJournal."),
+		ECVF_Default);
+}
+
+//////////////////////////////////////////////////////////////////////
+// FLyraDamageJournalWriter
+
+/** Writes the chunks for each frame to disk on a background thread */
+class FLyraDamageJournalWriter : public FRunnable
+{
+public:
+	FLyraDamageJournalWriter(FArchive* InArchive, const FString& InFilename)
+		: Archive(InArchive)
+		, Filename(InFilename)
+	{
+		WorkEvent = FPlatformProcess::GetSynchEventFromPool();
+
+		if (FPlatformProcess::SupportsMultithreading())
+		{
+			Thread = FRunnableThread::Create(this, TEXT("LyraDamageJournalWriter"), 0, TPri_BelowNormal);
+		}
+	}
+
+	virtual ~FLyraDamageJournalWriter()
+	{
+		Shutdown();
+	}
+
+	const FString& GetFilename() const { return Filename; }
+
+	// Queues a chunk to be written, only called from the game thread
+	void Enqueue(TArray<uint8>&& Chunk)
+	{
+		PendingChunks.Enqueue(MoveTemp(Chunk));
+
+		if (Thread != nullptr)
+		{
+			WorkEvent->Trigger();
+		}
+		else
+		{
+			DrainQueue();
+		}
+	}
+
+	// Writes anything still queued, stops the thread and closes the file
+	void Shutdown()
+	{
+		if (Archive == nullptr)
+		{
+			return;
+		}
+
+		bStopRequested = true;
+		if (Thread != nullptr)
+		{
+			WorkEvent->Trigger();
+			Thread->WaitForCompletion();
+			delete Thread;
+			Thread = nullptr;
+		}
+
+		DrainQueue();
+		Archive->Close();
+		Archive.Reset();
+
+		FPlatformProcess::ReturnSynchEventToPool(WorkEvent);
+		WorkEvent = nullptr;
+
+		UE_LOG(LogLyra, Log, TEXT("Damage journal closed, wrote %lld bytes to %s"), BytesWritten, *Filename);
+	}
+
+	//~FRunnable interface
+	virtual uint32 Run() override
+	{
+		while (!bStopRequested)
+		{
+			WorkEvent->Wait(1000);
+			DrainQueue();
+		}
+
+		return 0;
+	}
+
+	virtual void Stop() override
+	{
+		bStopRequested = true;
+		WorkEvent->Trigger();
+	}
+	//~End of FRunnable interface
+
+private:
+	void DrainQueue()
+	{
+		bool bWroteAnything = false;
+
+		TArray<uint8> Chunk;
+		while (PendingChunks.Dequeue(Chunk))
+		{
+			Archive->Serialize(Chunk.GetData(), Chunk.Num());
+			BytesWritten += Chunk.Num();
+			bWroteAnything = true;
+		}
+
+		if (bWroteAnything)
+		{
+			Archive->Flush();
+		}
+	}
+
+private:
+	TUniquePtr<FArchive> Archive;
+	FString Filename;
+
+	// Single producer (the game thread), single consumer (the writer thread)
+	TQueue<TArray<uint8>, EQueueMode::Spsc> PendingChunks;
+
+	FEvent* WorkEvent = nullptr;
+	FRunnableThread* Thread = nullptr;
+	std::atomic<bool> bStopRequested = false;
+	int64 BytesWritten = 0;
+};
+
+//////////////////////////////////////////////////////////////////////
+// ULyraDamageJournalSubsystem
+
+bool ULyraDamageJournalSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	if (!Super::ShouldCreateSubsystem(Outer))
+	{
+		return false;
+	}
+
+	const UWorld* World = Cast<UWorld>(Outer);
+	return (World != nullptr) && World->IsGameWorld();
+}
+
+void ULyraDamageJournalSubsystem::Deinitialize()
+{
+	StopRecording();
+
+	Super::Deinitialize();
+}
+
+void ULyraDamageJournalSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	const bool bWantsJournal = LyraDamageJournalCVars::bEnableDamageJournal || FParse::Param(FCommandLine::Get(), TEXT("DamageJournal"));
+	if (bWantsJournal && (InWorld.GetNetMode() != NM_Client))
+	{
+		StartRecording();
+	}
+}
+
+ULyraDamageJournalSubsystem* ULyraDamageJournalSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = (WorldContextObject != nullptr) ? WorldContextObject->GetWorld() : nullptr;
+	return (World != nullptr) ? World->GetSubsystem<ULyraDamageJournalSubsystem>() : nullptr;
+}
+
+void ULyraDamageJournalSubsystem::StartRecording()
+{
+	if (IsRecording())
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	const FString Filename = FPaths::ProjectSavedDir() / TEXT("DamageJournal") / FString::Printf(TEXT("%s_%s%s"), *World->GetMapName(), *FDateTime::Now().ToString(), LyraDamageJournal::FileExtension);
+
+	FArchive* Archive = IFileManager::Get().CreateFileWriter(*Filename);
+	if (Archive == nullptr)
+	{
+		UE_LOG(LogLyra, Warning, TEXT("Failed to create damage journal %s"), *Filename);
+		return;
+	}
+
+	uint32 Magic = LyraDamageJournal::FileMagic;
+	uint32 Version = LyraDamageJournal::FileVersion;
+	*Archive << Magic;
+	*Archive << Version;
+
+	Writer = MakeShared<FLyraDamageJournalWriter>(Archive, Filename);
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &ThisClass::HandleWorldPostActorTick);
+
+	UE_LOG(LogLyra, Log, TEXT("Recording damage journal to %s"), *Filename);
+}
+
+void ULyraDamageJournalSubsystem::StopRecording()
+{
+	if (!IsRecording())
+	{
+		return;
+	}
+
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	PostActorTickHandle.Reset();
+
+	FlushFrame();
+	Writer->Shutdown();
+	Writer.Reset();
+
+	SubjectIds.Reset();
+	WeaponClassIds.Reset();
+	NameIds.Reset();
+	NextNameId = 1;
+}
+
+void ULyraDamageJournalSubsystem::RecordDamage(const AActor* Source, const AActor* Target, const UObject* Weapon, FName HitZone, float Amount, float Distance, bool bKilledTarget)
+{
+	if (!IsRecording())
+	{
+		return;
+	}
+
+	FLyraDamageJournalRecord Record;
+	Record.Timestamp = GetWorld()->GetTimeSeconds();
+	Record.SourceId = GetSubjectId(Source);
+	Record.TargetId = GetSubjectId(Target);
+	Record.WeaponId = GetWeaponId(Weapon);
+	Record.HitZoneId = GetNameId(HitZone);
+	Record.Amount = Amount;
+	Record.Distance = Distance;
+	Record.Type = bKilledTarget ? ELyraDamageJournalRecordType::Kill : ELyraDamageJournalRecordType::Damage;
+	AddRecord(Record);
+}
+
+void ULyraDamageJournalSubsystem::RecordShots(const AActor* Source, const UObject* Weapon, const FGameplayAbilityTargetDataHandle& TargetData)
+{
+	if (!IsRecording())
+	{
+		return;
+	}
+
+	FLyraDamageJournalRecord Record;
+	Record.Timestamp = GetWorld()->GetTimeSeconds();
+	Record.SourceId = GetSubjectId(Source);
+	Record.WeaponId = GetWeaponId(Weapon);
+	Record.Type = ELyraDamageJournalRecordType::Shot;
+
+	for (int32 DataIndex = 0; DataIndex < TargetData.Num(); ++DataIndex)
+	{
+		const FGameplayAbilityTargetData* Data = TargetData.Get(DataIndex);
+		const FHitResult* HitResult = (Data != nullptr) ? Data->GetHitResult() : nullptr;
+		if (HitResult != nullptr)
+		{
+			Record.TargetId = GetSubjectId(HitResult->GetActor());
+			Record.HitZoneId = GetNameId(HitResult->BoneName);
+			AddRecord(Record);
+		}
+	}
+}
+
+uint32 ULyraDamageJournalSubsystem::GetSubjectId(const AActor* Actor)
+{
+	if (Actor == nullptr)
+	{
+		return 0;
+	}
+
+	const APlayerState* PlayerState = nullptr;
+	if (const APawn* Pawn = Cast<APawn>(Actor))
+	{
+		PlayerState = Pawn->GetPlayerState();
+	}
+	else if (const AController* Controller = Cast<AController>(Actor))
+	{
+		PlayerState = Controller->PlayerState;
+	}
+	else
+	{
+		PlayerState = Cast<APlayerState>(Actor);
+	}
+
+	const UObject* Subject = (PlayerState != nullptr) ? static_cast<const UObject*>(PlayerState) : static_cast<const UObject*>(Actor);
+	if (const uint32* ExistingId = SubjectIds.Find(FObjectKey(Subject)))
+	{
+		return *ExistingId;
+	}
+
+	const uint32 NewId = AddName((PlayerState != nullptr) ? PlayerState->GetPlayerName() : Actor->GetName());
+	SubjectIds.Add(FObjectKey(Subject), NewId);
+	return NewId;
+}
+
+uint32 ULyraDamageJournalSubsystem::GetWeaponId(const UObject* Weapon)
+{
+	if (Weapon == nullptr)
+	{
+		return 0;
+	}
+
+	const UClass* WeaponClass = Weapon->GetClass();
+	if (const uint32* ExistingId = WeaponClassIds.Find(FObjectKey(WeaponClass)))
+	{
+		return *ExistingId;
+	}
+
+	const uint32 NewId = AddName(WeaponClass->GetName());
+	WeaponClassIds.Add(FObjectKey(WeaponClass), NewId);
+	return NewId;
+}
+
+uint32 ULyraDamageJournalSubsystem::GetNameId(FName Name)
+{
+	if (Name.IsNone())
+	{
+		return 0;
+	}
+
+	if (const uint32* ExistingId = NameIds.Find(Name))
+	{
+		return *ExistingId;
+	}
+
+	const uint32 NewId = AddName(Name.ToString());
+	NameIds.Add(Name, NewId);
+	return NewId;
+}
+
+uint32 ULyraDamageJournalSubsystem::AddName(FString&& Name)
+{
+	const uint32 NewId = NextNameId++;
+	FrameNames.Emplace(NewId, MoveTemp(Name));
+	return NewId;
+}
+
+void ULyraDamageJournalSubsystem::AddRecord(const FLyraDamageJournalRecord& Record)
+{
+	FrameRecords.Add(Record);
+}
+
+void ULyraDamageJournalSubsystem::FlushFrame()
+{
+	if ((FrameRecords.Num() == 0) && (FrameNames.Num() == 0))
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_LyraDamageJournal_FlushFrame);
+
+	TArray<uint8> Chunk;
+	Chunk.Reserve((FrameRecords.Num() * sizeof(FLyraDamageJournalRecord)) + (FrameNames.Num() * 32) + 16);
+	FMemoryWriter ChunkWriter(Chunk);
+
+	// Names go first so the reader always knows an ID before a record uses it
+	if (FrameNames.Num() > 0)
+	{
+		uint32 ChunkType = (uint32)LyraDamageJournal::EChunkType::Names;
+		uint32 NumEntries = FrameNames.Num();
+		ChunkWriter << ChunkType;
+		ChunkWriter << NumEntries;
+
+		for (TPair<uint32, FString>& NameEntry : FrameNames)
+		{
+			ChunkWriter << NameEntry.Key;
+			ChunkWriter << NameEntry.Value;
+		}
+		FrameNames.Reset();
+	}
+
+	if (FrameRecords.Num() > 0)
+	{
+		uint32 ChunkType = (uint32)LyraDamageJournal::EChunkType::Records;
+		uint32 NumEntries = FrameRecords.Num();
+		ChunkWriter << ChunkType;
+		ChunkWriter << NumEntries;
+		ChunkWriter.Serialize(FrameRecords.GetData(), FrameRecords.Num() * sizeof(FLyraDamageJournalRecord));
+		FrameRecords.Reset();
+	}
+
+	Writer->Enqueue(MoveTemp(Chunk));
+}
+
+void ULyraDamageJournalSubsystem::HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World == GetWorld())
+	{
+		FlushFrame();
+	}
+}
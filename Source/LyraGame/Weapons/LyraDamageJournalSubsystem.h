@@ -0,0 +1,138 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+
+#include "LyraDamageJournalSubsystem.generated.h"
+
+class AActor;
+class FLyraDamageJournalWriter;
+struct FGameplayAbilityTargetDataHandle;
+
+enum class ELyraDamageJournalRecordType : uint8
+{
+	// A shot (or pellet) was fired, TargetId is the actor it hit on the server if any
+	Shot,
+
+	// Damage was applied to the target
+	Damage,
+
+	// Damage was applied to the target and took it out of health
+	Kill
+};
+
+/**
+ * One fixed size entry in a damage journal
+ *
+ * Sources, targets, weapons and hit zones are stored as IDs into the name table that is written
+ * alongside the records (0 means none)
+ */
+struct FLyraDamageJournalRecord
+{
+	// World time in seconds
+	double Timestamp = 0.0;
+
+	uint32 SourceId = 0;
+	uint32 TargetId = 0;
+	uint32 WeaponId = 0;
+	uint32 HitZoneId = 0;
+
+	// Damage done (before clamping to the remaining health), unused for shots
+	float Amount = 0.0f;
+
+	// Distance from the damage origin to the impact, unused for shots
+	float Distance = 0.0f;
+
+	ELyraDamageJournalRecordType Type = ELyraDamageJournalRecordType::Damage;
+	uint8 Padding[7] = {};
+};
+
+static_assert(sizeof(FLyraDamageJournalRecord) == 40, "Damage journal records are written raw, bump LyraDamageJournal::FileVersion when changing the layout");
+
+namespace LyraDamageJournal
+{
+	// A journal file is the magic, the version, then a sequence of chunks (chunk type, entry count, entries)
+	static constexpr uint32 FileMagic = 0x4C444A31; // 'LDJ1'
+	static constexpr uint32 FileVersion = 1;
+	static constexpr const TCHAR* FileExtension = TEXT(".lyradmg");
+
+	enum class EChunkType : uint32
+	{
+		// Entries are (uint32 Id, FString Name)
+		Names = 1,
+
+		// Entries are raw FLyraDamageJournalRecords
+		Records = 2
+	};
+}
+
+/**
+ * Server side journal of shots, damage and kills for post match weapon balancing
+ *
+ * Records are appended to a buffer for the current frame, which is handed to a background
+ * thread at the end of the frame to be written to Saved/DamageJournal.
+ * Enable with Lyra.DamageJournal.Enable or -DamageJournal, and aggregate the files with the
+ * LyraDamageJournal commandlet.
+ */
+UCLASS()
+class LYRAGAME_API ULyraDamageJournalSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//~USubsystem interface
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+	//~End of USubsystem interface
+
+	//~UWorldSubsystem interface
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	//~End of UWorldSubsystem interface
+
+	static ULyraDamageJournalSubsystem* Get(const UObject* WorldContextObject);
+
+	bool IsRecording() const { return Writer.IsValid(); }
+
+	// Records damage dealt by Source to Target
+	void RecordDamage(const AActor* Source, const AActor* Target, const UObject* Weapon, FName HitZone, float Amount, float Distance, bool bKilledTarget);
+
+	// Records one shot for every hit result in the target data
+	void RecordShots(const AActor* Source, const UObject* Weapon, const FGameplayAbilityTargetDataHandle& TargetData);
+
+private:
+	void StartRecording();
+	void StopRecording();
+
+	// Returns the journal ID for an actor (players are identified by their player state so they keep the same ID across lives)
+	uint32 GetSubjectId(const AActor* Actor);
+
+	// Returns the journal ID for an object, identified by its class
+	uint32 GetWeaponId(const UObject* Weapon);
+
+	uint32 GetNameId(FName Name);
+
+	uint32 AddName(FString&& Name);
+
+	void AddRecord(const FLyraDamageJournalRecord& Record);
+
+	// Hands the records and names from this frame to the writer
+	void FlushFrame();
+
+	void HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+private:
+	TSharedPtr<FLyraDamageJournalWriter> Writer;
+
+	// Records and new names added this frame, only touched by the game thread
+	TArray<FLyraDamageJournalRecord> FrameRecords;
+	TArray<TPair<uint32, FString>> FrameNames;
+
+	TMap<FObjectKey, uint32> SubjectIds;
+	TMap<FObjectKey, uint32> WeaponClassIds;
+	TMap<FName, uint32> NameIds;
+	uint32 NextNameId = 1;
+
+	FDelegateHandle PostActorTickHandle;
+};
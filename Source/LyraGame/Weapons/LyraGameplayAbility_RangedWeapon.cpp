@@ -7,6 +7,7 @@
 #include "AIController.h"
 #include "NativeGameplayTags.h"
 #include "Weapons/LyraWeaponStateComponent.h"
+#include "Weapons/LyraDamageJournalSubsystem.h"
 #include "AbilitySystemComponent.h"
 #include "AbilitySystem/LyraGameplayAbilityTargetData_SingleTargetHit.h"
 #include "DrawDebugHelpers.h"
@@ -535,6 +536,16 @@ void ULyraGameplayAbility_RangedWeapon::OnTargetDataReadyCallback(const FGamepla
 			check(WeaponData);
 			WeaponData->AddSpread();
 
+#if WITH_SERVER_CODE
+			if (CurrentActorInfo->IsNetAuthority())
+			{
+				if (ULyraDamageJournalSubsystem* DamageJournal = ULyraDamageJournalSubsystem::Get(GetAvatarActorFromActorInfo()))
+				{
+					DamageJournal->RecordShots(GetAvatarActorFromActorInfo(), WeaponData, LocalTargetDataHandle);
+				}
+			}
+#endif // WITH_SERVER_CODE
+
 			// Let the blueprint do stuff like apply effects to the targets
 			OnRangedWeaponTargetDataReady(LocalTargetDataHandle);
 		}
@@ -4,6 +4,7 @@
 #include "NativeGameplayTags.h"
 #include "GameFramework/Pawn.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "HAL/IConsoleManager.h"
 #include "Camera/LyraCameraComponent.h"
 #include "Physics/PhysicalMaterialWithTags.h"
 #include "Weapons/LyraWeaponInstance.h"
@@ -12,6 +13,23 @@
 
 UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Lyra_Weapon_SteadyAimingCamera, "Lyra.Weapon.SteadyAimingCamera");
 
+namespace LyraRangedWeaponCVars
+{
+	static bool bUseDamageTables = true;
+	static FAutoConsoleVariableRef CVarUseDamageTables(
+		TEXT("Lyra.Weapon.UseDamageTables"),
+		bUseDamageTables,
+		TEXT("If true, ranged weapons use tables built at equip time for distance falloff and physical material damage multipliers instead of evaluating the curve and tag map on every hit."),
+		ECVF_Default);
+
+	static int32 DistanceFalloffTableSize = 128;
+	static FAutoConsoleVariableRef CVarDistanceFalloffTableSize(
+		TEXT("Lyra.Weapon.DistanceFalloffTableSize"),
+		DistanceFalloffTableSize,
+		TEXT("Number of samples taken from the distance damage falloff curve when a ranged weapon is equipped."),
+		ECVF_Default);
+}
+
 ULyraRangedWeaponInstance::ULyraRangedWeaponInstance(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
@@ -33,6 +51,11 @@ void ULyraRangedWeaponInstance::PostEditChangeProperty(struct FPropertyChangedEv
 {
 	Super::PostEditChangeProperty(PropertyChangedEvent);
 	UpdateDebugVisualization();
+
+	if (bDamageTablesValid)
+	{
+		BuildDamageTables();
+	}
 }
 
 void ULyraRangedWeaponInstance::UpdateDebugVisualization()
@@ -63,6 +86,8 @@ void ULyraRangedWeaponInstance::OnEquipped()
 	StandingStillMultiplier = 1.0f;
 	JumpFallMultiplier = 1.0f;
 	CrouchingMultiplier = 1.0f;
+
+	BuildDamageTables();
 }
 
 void ULyraRangedWeaponInstance::OnUnequipped()
@@ -122,13 +147,85 @@ void ULyraRangedWeaponInstance::AddSpread()
 #endif
 }
 
+void ULyraRangedWeaponInstance::BuildDamageTables()
+{
+	DistanceFalloffTable.Reset();
+	DistanceFalloffTableStart = 0.0f;
+	DistanceFalloffTableInvStep = 0.0f;
+	MaterialAttenuationCache.Reset();
+
+	bDamageTablesValid = true;
+
+	// Curves that extrapolate past their keys can't be clamped to a table, and interpolating between samples
+	// would smear the steps of constant keys into ramps, so both keep using the curve
+	const FRichCurve* Curve = DistanceDamageFalloff.GetRichCurveConst();
+	bool bCanFlattenCurve = (Curve->PreInfinityExtrap == RCCE_Constant) && (Curve->PostInfinityExtrap == RCCE_Constant);
+	for (int32 KeyIndex = 0; bCanFlattenCurve && (KeyIndex < Curve->Keys.Num() - 1); ++KeyIndex)
+	{
+		bCanFlattenCurve = (Curve->Keys[KeyIndex].InterpMode != RCIM_Constant);
+	}
+	bUseDistanceFalloffTable = bCanFlattenCurve;
+
+	if (bCanFlattenCurve && Curve->HasAnyData())
+	{
+		float MinDistance;
+		float MaxDistance;
+		Curve->GetTimeRange(/*out*/ MinDistance, /*out*/ MaxDistance);
+
+		const int32 NumSamples = (MaxDistance > MinDistance) ? FMath::Max(LyraRangedWeaponCVars::DistanceFalloffTableSize, 2) : 1;
+		const float Step = (NumSamples > 1) ? (MaxDistance - MinDistance) / (NumSamples - 1) : 0.0f;
+
+		DistanceFalloffTable.SetNumUninitialized(NumSamples);
+		for (int32 SampleIndex = 0; SampleIndex < NumSamples; ++SampleIndex)
+		{
+			DistanceFalloffTable[SampleIndex] = Curve->Eval(MinDistance + (Step * SampleIndex));
+		}
+
+		DistanceFalloffTableStart = MinDistance;
+		DistanceFalloffTableInvStep = (Step > 0.0f) ? (1.0f / Step) : 0.0f;
+	}
+}
+
 float ULyraRangedWeaponInstance::GetDistanceAttenuation(float Distance, const FGameplayTagContainer* SourceTags, const FGameplayTagContainer* TargetTags) const
 {
+	if (bDamageTablesValid && bUseDistanceFalloffTable && LyraRangedWeaponCVars::bUseDamageTables)
+	{
+		const int32 NumSamples = DistanceFalloffTable.Num();
+		if (NumSamples == 0)
+		{
+			return 1.0f;
+		}
+
+		const float SamplePosition = FMath::Clamp((Distance - DistanceFalloffTableStart) * DistanceFalloffTableInvStep, 0.0f, float(NumSamples - 1));
+		const int32 LowerIndex = FMath::FloorToInt32(SamplePosition);
+		const int32 UpperIndex = FMath::Min(LowerIndex + 1, NumSamples - 1);
+		return FMath::Lerp(DistanceFalloffTable[LowerIndex], DistanceFalloffTable[UpperIndex], SamplePosition - LowerIndex);
+	}
+
 	const FRichCurve* Curve = DistanceDamageFalloff.GetRichCurveConst();
 	return Curve->HasAnyData() ? Curve->Eval(Distance) : 1.0f;
 }
 
 float ULyraRangedWeaponInstance::GetPhysicalMaterialAttenuation(const UPhysicalMaterial* PhysicalMaterial, const FGameplayTagContainer* SourceTags, const FGameplayTagContainer* TargetTags) const
+{
+	if (bDamageTablesValid && LyraRangedWeaponCVars::bUseDamageTables)
+	{
+		// Physical materials can stream in at any time, so the table is filled in as they get hit
+		const TObjectKey<UPhysicalMaterial> MaterialKey(PhysicalMaterial);
+		if (const float* CachedMultiplier = MaterialAttenuationCache.Find(MaterialKey))
+		{
+			return *CachedMultiplier;
+		}
+
+		const float CombinedMultiplier = ComputePhysicalMaterialAttenuation(PhysicalMaterial);
+		MaterialAttenuationCache.Add(MaterialKey, CombinedMultiplier);
+		return CombinedMultiplier;
+	}
+
+	return ComputePhysicalMaterialAttenuation(PhysicalMaterial);
+}
+
+float ULyraRangedWeaponInstance::ComputePhysicalMaterialAttenuation(const UPhysicalMaterial* PhysicalMaterial) const
 {
 	float CombinedMultiplier = 1.0f;
 	if (const UPhysicalMaterialWithTags* PhysMatWithTags = Cast<const UPhysicalMaterialWithTags>(PhysicalMaterial))
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "Curves/CurveFloat.h"
+#include "UObject/ObjectKey.h"
 
 #include "LyraWeaponInstance.h"
 #include "AbilitySystem/LyraAbilitySourceInterface.h"
@@ -213,6 +214,22 @@ private:
 	// The current crouching multiplier
 	float CrouchingMultiplier = 1.0f;
 
+	// DistanceDamageFalloff sampled at even spacing when the weapon is equipped (empty if the curve has no data or can't be flattened)
+	TArray<float> DistanceFalloffTable;
+
+	// The distance of the first entry in DistanceFalloffTable and the reciprocal of the spacing between entries
+	float DistanceFalloffTableStart = 0.0f;
+	float DistanceFalloffTableInvStep = 0.0f;
+
+	// True if the damage tables were built and can be used instead of the curve and tag map
+	bool bDamageTablesValid = false;
+
+	// True if DistanceFalloffTable can stand in for DistanceDamageFalloff (false for stepped or extrapolated curves)
+	bool bUseDistanceFalloffTable = false;
+
+	// Combined MaterialDamageMultiplier for each physical material that has been hit with this weapon
+	mutable TMap<TObjectKey<UPhysicalMaterial>, float> MaterialAttenuationCache;
+
 public:
 	void Tick(float DeltaSeconds);
 
@@ -229,6 +246,11 @@ public:
 	//~End of ILyraAbilitySourceInterface interface
 
 private:
+	// Flattens DistanceDamageFalloff and resets the physical material cache
+	void BuildDamageTables();
+
+	float ComputePhysicalMaterialAttenuation(const UPhysicalMaterial* PhysicalMaterial) const;
+
 	void ComputeSpreadRange(float& MinSpread, float& MaxSpread);
 	void ComputeHeatRange(float& MinHeat, float& MaxHeat);
 